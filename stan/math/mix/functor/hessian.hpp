@@ -4,11 +4,64 @@
 #include <stan/math/fwd/core.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <cstddef>
 #include <stdexcept>
 
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * Compute the rows of the Hessian (and the respective entries of the
+ * gradient) for the directions <code>start</code> up to, but not
+ * including, <code>end</code>. Each direction runs its own nested
+ * <code>fvar\<var\></code> pass on the AD tape of the calling thread.
+ * The function value is only assigned by the pass of the first
+ * direction.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[out] fx Function applied to argument
+ * @param[out] grad gradient of function at argument
+ * @param[out] H Hessian of function at argument
+ * @param[in] start First direction
+ * @param[in] end One past the last direction
+ */
+template <typename F>
+void hessian_directions(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x, double& fx,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& grad,
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& H, int start,
+    int end) {
+  for (int i = start; i < end; ++i) {
+    // Run nested autodiff in this scope
+    nested_rev_autodiff nested;
+
+    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(x.size());
+    for (int j = 0; j < x.size(); ++j) {
+      x_fvar(j) = fvar<var>(x(j), i == j);
+    }
+    fvar<var> fx_fvar = f(x_fvar);
+    grad(i) = fx_fvar.d_.val();
+    if (i == 0) {
+      fx = fx_fvar.val_.val();
+    }
+    stan::math::grad(fx_fvar.d_.vi_);
+    for (int j = 0; j < x.size(); ++j) {
+      H(i, j) = x_fvar(j).val_.adj();
+    }
+  }
+}
+
+}  // namespace internal
+
 /**
  * Calculate the value, the gradient, and the Hessian,
  * of the specified function at the specified argument in
@@ -50,24 +103,53 @@ void hessian(const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
     fx = f(x);
     return;
   }
-  for (int i = 0; i < x.size(); ++i) {
-    // Run nested autodiff in this scope
-    nested_rev_autodiff nested;
+  internal::hessian_directions(f, x, fx, grad, H, 0, x.size());
+}
 
-    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(x.size());
-    for (int j = 0; j < x.size(); ++j) {
-      x_fvar(j) = fvar<var>(x(j), i == j);
-    }
-    fvar<var> fx_fvar = f(x_fvar);
-    grad(i) = fx_fvar.d_.val();
-    if (i == 0) {
-      fx = fx_fvar.val_.val();
-    }
-    stan::math::grad(fx_fvar.d_.vi_);
-    for (int j = 0; j < x.size(); ++j) {
-      H(i, j) = x_fvar(j).val_.adj();
-    }
+/**
+ * Calculate the value, the gradient, and the Hessian,
+ * of the specified function at the specified argument, splitting
+ * the directional passes over the TBB worker threads.
+ *
+ * <p>Whenever STAN_THREADS is defined the N directions are split
+ * into chunks of at least <code>grainsize</code> directions which run
+ * their nested <code>fvar\<var\></code> passes on the thread local AD
+ * tape of the executing thread. The function must be safe to call
+ * concurrently from different threads. Without STAN_THREADS all
+ * directions are evaluated on the calling thread.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[out] fx Function applied to argument
+ * @param[out] grad gradient of function at argument
+ * @param[out] H Hessian of function at argument
+ * @param[in] grainsize Suggested number of directions computed by one task
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F>
+void hessian(const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+             double& fx, Eigen::Matrix<double, Eigen::Dynamic, 1>& grad,
+             Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& H,
+             int grainsize) {
+  check_positive("hessian", "grainsize", grainsize);
+  H.resize(x.size(), x.size());
+  grad.resize(x.size());
+
+  // need to compute fx even with size = 0
+  if (x.size() == 0) {
+    fx = f(x);
+    return;
   }
+#ifdef STAN_THREADS
+  tbb::parallel_for(
+      tbb::blocked_range<std::size_t>(0, x.size(), grainsize),
+      [&](const tbb::blocked_range<std::size_t>& r) {
+        internal::hessian_directions(f, x, fx, grad, H, r.begin(), r.end());
+      });
+#else
+  internal::hessian_directions(f, x, fx, grad, H, 0, x.size());
+#endif
 }
 
 }  // namespace math
@@ -0,0 +1,200 @@
+#ifndef STAN_MATH_PRIM_FUN_KRYLOV_EXP_ACTION_HANDLER_HPP
+#define STAN_MATH_PRIM_FUN_KRYLOV_EXP_ACTION_HANDLER_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/constants.hpp>
+#include <stan/math/prim/fun/matrix_exp.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * The Krylov subspace method of Expokit,
+ * Roger B. Sidje "Expokit: A Software Package for Computing Matrix
+ * Exponentials", ACM Trans. Math. Softw. 24(1), 1998,
+ * Read More: https://doi.org/10.1145/285861.285868
+ *
+ * Calculates exp(t*A)*v for a sparse matrix A by time stepping. Each
+ * step projects A onto the Krylov subspace of the current vector with
+ * the Arnoldi process, such that only products of A with vectors and
+ * exponentials of small dense Hessenberg matrices are needed. The
+ * steps are kept, since the solution anywhere within a step follows
+ * from the Krylov basis of the step.
+ */
+class krylov_exp_action_handler {
+  static constexpr int m_max = 30;
+  static constexpr int max_rejections = 10;
+  static constexpr double tol = 1e-10;
+  static constexpr double breakdown_tol = 1e-12;
+  static constexpr double gamma = 0.9;
+  static constexpr double delta = 1.2;
+
+  /**
+   * Round the step size up to two significant digits as Expokit does.
+   */
+  static double round_step(double h) {
+    const double s = std::pow(10.0, std::floor(std::log10(h)) - 1.0);
+    return std::ceil(h / s) * s;
+  }
+
+ public:
+  /**
+   * Krylov approximation of the solution on the interval
+   * [t0, t0 + h], which is beta * V * exp((t - t0) * H) * e_1.
+   */
+  struct step {
+    double t0;
+    double h;
+    double beta;
+    Eigen::MatrixXd V;
+    Eigen::MatrixXd H;
+  };
+
+  /**
+   * Return the infinity norm of a sparse matrix, which bounds the step
+   * sizes of the Krylov method.
+   *
+   * @param[in] A sparse matrix
+   * @return maximum absolute row sum of A
+   */
+  static double norm(const Eigen::SparseMatrix<double>& A) {
+    if (A.rows() == 0) {
+      return 0;
+    }
+    return (A.cwiseAbs() * Eigen::VectorXd::Ones(A.cols())).maxCoeff();
+  }
+
+  /**
+   * Return the solution at time t within the given step.
+   *
+   * @param[in] s step with s.t0 <= t <= s.t0 + s.h
+   * @param[in] t time
+   * @return Krylov approximation of the solution at t
+   */
+  static Eigen::VectorXd evaluate(const step& s, double t) {
+    if (s.V.cols() == 0) {
+      return Eigen::VectorXd::Zero(s.V.rows());
+    }
+    return s.beta * (s.V * matrix_exp((t - s.t0) * s.H).col(0));
+  }
+
+  /**
+   * Perform the matrix exponential action exp(A*t)*v and append the
+   * steps taken, which start at time 0, to steps.
+   *
+   * @param[in] function_name name of the calling function
+   * @param[in] A square sparse matrix
+   * @param[in] anorm infinity norm of A
+   * @param[in] v vector
+   * @param[in] t non-negative time
+   * @param[in, out] steps steps of the Krylov method
+   * @return vector exp(A*t)*v
+   * @throw std::domain_error if the local error of a step can not be
+   *   brought below the tolerance
+   */
+  static Eigen::VectorXd action(const char* function_name,
+                                const Eigen::SparseMatrix<double>& A,
+                                double anorm, const Eigen::VectorXd& v,
+                                double t, std::vector<step>& steps) {
+    const Eigen::Index N = v.size();
+    const int m = std::min<Eigen::Index>(m_max, N);
+    Eigen::VectorXd w = v;
+    double beta = w.norm();
+    const double tol_abs = tol * beta;
+    const double rndoff = anorm * std::numeric_limits<double>::epsilon();
+
+    double t_now = 0;
+    double h_new = t;
+    if (anorm > 0 && beta > 0) {
+      const double fact = std::pow((m + 1) / e(), m + 1)
+                          * std::sqrt(2 * pi() * (m + 1));
+      h_new = round_step(std::pow(fact * tol / (4 * anorm), 1.0 / m) / anorm);
+    }
+
+    while (t_now < t) {
+      step s;
+      s.t0 = t_now;
+      s.beta = beta;
+      if (beta == 0) {
+        // the solution stays zero
+        s.h = t - t_now;
+        s.V.resize(N, 0);
+        steps.push_back(std::move(s));
+        break;
+      }
+
+      // Arnoldi process with modified Gram-Schmidt
+      Eigen::MatrixXd V(N, m + 1);
+      Eigen::MatrixXd H = Eigen::MatrixXd::Zero(m + 1, m + 1);
+      V.col(0) = w / beta;
+      int mb = m;
+      bool breakdown = false;
+      for (int j = 0; j < m; ++j) {
+        Eigen::VectorXd p = A * V.col(j);
+        for (int i = 0; i <= j; ++i) {
+          H.coeffRef(i, j) = V.col(i).dot(p);
+          p -= H.coeff(i, j) * V.col(i);
+        }
+        const double p_norm = p.norm();
+        if (p_norm <= breakdown_tol * anorm) {
+          // the Krylov subspace is invariant and the projection exact
+          mb = j + 1;
+          breakdown = true;
+          break;
+        }
+        H.coeffRef(j + 1, j) = p_norm;
+        V.col(j + 1) = p / p_norm;
+      }
+
+      const bool is_last = breakdown || h_new >= t - t_now;
+      double h = is_last ? t - t_now : h_new;
+      Eigen::MatrixXd F;
+      double err = 0;
+      for (int reject = 0;; ++reject) {
+        if (breakdown) {
+          F = matrix_exp(h * H.topLeftCorner(mb, mb));
+          break;
+        }
+        // the last row of the augmented Hessenberg matrix estimates the
+        // local error
+        F = matrix_exp(h * H);
+        err = beta * std::fabs(F.coeff(m, 0));
+        if (err <= delta * h * tol_abs) {
+          break;
+        }
+        if (reject == max_rejections) {
+          const double tolerance = tol;
+          throw_domain_error(function_name, "tolerance", tolerance,
+                             "Krylov approximation fails to reach ");
+        }
+        h = round_step(gamma * h * std::pow(h * tol_abs / err, 1.0 / m));
+      }
+
+      s.h = h;
+      s.V = V.leftCols(mb);
+      s.H = H.topLeftCorner(mb, mb);
+      w = beta * (s.V * F.col(0).head(mb));
+      beta = w.norm();
+      steps.push_back(std::move(s));
+
+      t_now = is_last && h == t - t_now ? t : t_now + h;
+      if (!breakdown) {
+        h_new = round_step(gamma * h
+                           * std::pow(h * tol_abs / std::max(err, rndoff),
+                                      1.0 / m));
+      }
+    }
+    return w;
+  }
+};
+
+}  // namespace math
+}  // namespace stan
+
+#endif
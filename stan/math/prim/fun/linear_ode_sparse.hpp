@@ -0,0 +1,122 @@
+#ifndef STAN_MATH_PRIM_FUN_LINEAR_ODE_SPARSE_HPP
+#define STAN_MATH_PRIM_FUN_LINEAR_ODE_SPARSE_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/krylov_exp_action_handler.hpp>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * Check the arguments of linear_ode_sparse.
+ *
+ * @param[in] function name of the calling function
+ * @param[in] A sparse matrix
+ * @param[in] y0 initial state
+ * @param[in] ts output times
+ */
+inline void check_linear_ode_sparse(const char* function,
+                                    const Eigen::SparseMatrix<double>& A,
+                                    const Eigen::VectorXd& y0,
+                                    const std::vector<double>& ts) {
+  check_size_match(function, "rows of A", A.rows(), "columns of A",
+                   A.cols());
+  check_size_match(function, "columns of A", A.cols(), "size of y0",
+                   y0.size());
+  for (Eigen::Index k = 0; k < A.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(A, k); it; ++it) {
+      check_finite(function, "A", it.value());
+    }
+  }
+  check_finite(function, "initial state", y0);
+  check_nonzero_size(function, "times", ts);
+  check_positive_finite(function, "times", ts);
+  check_sorted(function, "times", ts);
+}
+
+/**
+ * Return the solutions exp(t * A) * y0 at the output times as columns
+ * of a matrix and keep the steps of the Krylov method. The solutions
+ * at all output times within a step follow from the Krylov basis of
+ * that step.
+ *
+ * @param[in] function name of the calling function
+ * @param[in] A sparse matrix
+ * @param[in] y0 initial state
+ * @param[in] ts output times, sorted and positive
+ * @param[out] steps steps of the Krylov method
+ * @return matrix with the solutions at ts as columns
+ */
+inline Eigen::MatrixXd linear_ode_sparse_solve(
+    const char* function, const Eigen::SparseMatrix<double>& A,
+    const Eigen::VectorXd& y0, const std::vector<double>& ts,
+    std::vector<krylov_exp_action_handler::step>& steps) {
+  Eigen::MatrixXd ys(y0.size(), ts.size());
+  if (y0.size() == 0) {
+    return ys;
+  }
+  krylov_exp_action_handler::action(function, A,
+                                    krylov_exp_action_handler::norm(A), y0,
+                                    ts.back(), steps);
+  size_t k = 0;
+  for (size_t n = 0; n < ts.size(); ++n) {
+    while (k + 1 < steps.size() && steps[k].t0 + steps[k].h < ts[n]) {
+      ++k;
+    }
+    ys.col(n) = krylov_exp_action_handler::evaluate(steps[k], ts[n]);
+  }
+  return ys;
+}
+
+}  // namespace internal
+
+/**
+ * Return the solutions of the linear ODE dy/dt = A * y with initial
+ * state y0 at time 0 for the sparse matrix A, which are
+ * exp(t * A) * y0 for each output time t.
+ *
+ * The matrix exponential action is approximated in Krylov subspaces
+ * of A, which only needs sparse matrix vector products, such that
+ * large compartment or Markov models with a sparse rate matrix are
+ * feasible. The Krylov basis of each time step gives the solutions at
+ * all output times within the step.
+ *
+ * @tparam EigVec type of the initial state
+ * @param[in] A square sparse matrix
+ * @param[in] y0 initial state
+ * @param[in] ts output times, positive and sorted
+ * @return a vector of states, one for each output time
+ * @throw std::invalid_argument if A is not square or its size does not
+ *   match y0
+ * @throw std::domain_error if A or y0 are not finite or if ts are not
+ *   positive, finite and sorted
+ */
+template <typename EigVec,
+          require_eigen_col_vector_vt<std::is_arithmetic, EigVec>* = nullptr>
+inline std::vector<Eigen::VectorXd> linear_ode_sparse(
+    const Eigen::SparseMatrix<double>& A, const EigVec& y0,
+    const std::vector<double>& ts) {
+  static const char* function = "linear_ode_sparse";
+  const Eigen::VectorXd y0_val = y0;
+  internal::check_linear_ode_sparse(function, A, y0_val, ts);
+
+  std::vector<krylov_exp_action_handler::step> steps;
+  const Eigen::MatrixXd ys
+      = internal::linear_ode_sparse_solve(function, A, y0_val, ts, steps);
+
+  std::vector<Eigen::VectorXd> res(ts.size());
+  for (size_t n = 0; n < ts.size(); ++n) {
+    res[n] = ys.col(n);
+  }
+  return res;
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
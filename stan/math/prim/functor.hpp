@@ -14,7 +14,10 @@
 #include <stan/math/prim/functor/integrate_1d.hpp>
 #include <stan/math/prim/functor/integrate_ode_rk45.hpp>
 #include <stan/math/prim/functor/integrate_ode_std_vector_interface_adapter.hpp>
+#include <stan/math/prim/functor/ode_batch.hpp>
 #include <stan/math/prim/functor/ode_rk45.hpp>
+#include <stan/math/prim/functor/ode_rk45_batch.hpp>
+#include <stan/math/prim/functor/ode_stats.hpp>
 #include <stan/math/prim/functor/ode_store_sensitivities.hpp>
 #include <stan/math/prim/functor/map_rect.hpp>
 #include <stan/math/prim/functor/map_rect_combine.hpp>
@@ -23,8 +26,10 @@
 #include <stan/math/prim/functor/mpi_cluster.hpp>
 #include <stan/math/prim/functor/mpi_command.hpp>
 #include <stan/math/prim/functor/mpi_distributed_apply.hpp>
+#include <stan/math/prim/functor/mpi_profile.hpp>
 #include <stan/math/prim/functor/operands_and_partials.hpp>
 #include <stan/math/prim/functor/reduce_sum.hpp>
+#include <stan/math/prim/functor/reduce_sum_auto.hpp>
 #include <stan/math/prim/functor/reduce_sum_static.hpp>
 
 #endif
@@ -18,7 +18,10 @@
 #include <boost/serialization/export.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <mutex>
+#include <numeric>
 #include <vector>
 #include <memory>
 
@@ -99,6 +102,134 @@ inline std::vector<int> mpi_map_chunks(std::size_t num_jobs,
   return chunks;
 }
 
+/**
+ * Maps jobs with given costs to workers which run the given number
+ * of threads each and returns a vector of counts indexed by the
+ * rank of each worker. Each worker receives a consecutive range of
+ * jobs such that the summed costs per worker are as close as
+ * possible to a share of the total costs which is proportional to
+ * the number of threads of the worker. This is used for the
+ * cost-aware scheduling of jobs internally, where the costs are the
+ * run times measured during previous evaluations.
+ *
+ * @param job_costs Non-negative costs of each job
+ * @param rank_threads Number of threads of each worker
+ * @param chunk_size Chunk size per job
+ * @return vector indexed by rank with the total number of
+ * elements mapped to a given worker
+ */
+inline std::vector<int> mpi_map_chunks(const std::vector<double>& job_costs,
+                                       const std::vector<int>& rank_threads,
+                                       std::size_t chunk_size = 1);
+
+/**
+ * Maps jobs of given chunk size to workers which run the given
+ * number of threads each and returns a vector of counts indexed by
+ * the rank of each worker. The jobs are split proportional to the
+ * number of threads of each worker. If all workers run the same
+ * number of threads, the static scheduling of mpi_map_chunks
+ * without thread counts is used.
+ *
+ * @param num_jobs Total number of jobs to dispatch
+ * @param rank_threads Number of threads of each worker
+ * @param chunk_size Chunk size per job
+ * @return vector indexed by rank with the total number of
+ * elements mapped to a given worker
+ */
+inline std::vector<int> mpi_map_chunks(std::size_t num_jobs,
+                                       const std::vector<int>& rank_threads,
+                                       std::size_t chunk_size = 1) {
+  if (std::adjacent_find(rank_threads.begin(), rank_threads.end(),
+                         std::not_equal_to<int>())
+      == rank_threads.end()) {
+    return mpi_map_chunks(num_jobs, chunk_size);
+  }
+  return mpi_map_chunks(std::vector<double>(num_jobs, 1.0), rank_threads,
+                        chunk_size);
+}
+
+inline std::vector<int> mpi_map_chunks(const std::vector<double>& job_costs,
+                                       const std::vector<int>& rank_threads,
+                                       std::size_t chunk_size) {
+  const std::size_t world_size = rank_threads.size();
+  const std::size_t num_jobs = job_costs.size();
+
+  std::vector<int> chunks(world_size, 0);
+  if (num_jobs == 0) {
+    return chunks;
+  }
+
+  const double total_cost
+      = std::accumulate(job_costs.begin(), job_costs.end(), 0.0);
+  if (!(total_cost > 0.0)) {
+    return mpi_map_chunks(num_jobs, rank_threads, chunk_size);
+  }
+  const double total_threads
+      = std::accumulate(rank_threads.begin(), rank_threads.end(), 0.0);
+
+  double cumulative_cost = 0.0;
+  double cumulative_threads = 0.0;
+  for (std::size_t r = 0, i = 0; r != world_size; ++r) {
+    cumulative_threads += rank_threads[r];
+    const double target_cost = total_cost * cumulative_threads / total_threads;
+    // assign the next job whenever its midpoint falls below the
+    // target; the last worker takes all remaining jobs
+    while (i != num_jobs
+           && (r == world_size - 1
+               || cumulative_cost + 0.5 * job_costs[i] <= target_cost)) {
+      cumulative_cost += job_costs[i];
+      ++chunks[r];
+      ++i;
+    }
+  }
+
+  for (std::size_t i = 0; i != world_size; ++i)
+    chunks[i] *= chunk_size;
+
+  return chunks;
+}
+
+/**
+ * Maps jobs with given costs to workers and returns a vector of
+ * counts indexed by the rank of each worker. All workers are
+ * assumed to run the same number of threads.
+ *
+ * @param job_costs Non-negative costs of each job
+ * @param chunk_size Chunk size per job
+ * @return vector indexed by rank with the total number of
+ * elements mapped to a given worker
+ */
+inline std::vector<int> mpi_map_chunks(const std::vector<double>& job_costs,
+                                       std::size_t chunk_size = 1) {
+  boost::mpi::communicator world;
+  return mpi_map_chunks(job_costs, std::vector<int>(world.size(), 1),
+                        chunk_size);
+}
+
+/**
+ * Fixed size header broadcasted to the workers for every command.
+ * A non-negative id refers to a command of the mpi_command_registry
+ * which the workers construct and run without further
+ * communication. The id -1 announces a serialized command object
+ * which follows the header.
+ */
+struct mpi_command_header {
+  static constexpr int serialized_id = -1;
+
+  int command_id = serialized_id;
+};
+
+/**
+ * Broadcasts the command header from the root to all processes.
+ *
+ * @param world communicator of the cluster
+ * @param header header to send on the root and to receive otherwise
+ */
+inline void mpi_broadcast_header(const boost::mpi::communicator& world,
+                                 mpi_command_header& header) {
+  boost::mpi::broadcast(world, &header.command_id, 1, 0);
+}
+
 template <typename T>
 std::unique_lock<std::mutex> mpi_broadcast_command();
 
@@ -143,8 +274,10 @@ struct mpi_cluster {
    * we enter into a listening state. In the listening state on
    * the non-root processes we wait for broadcasts of mpi_command
    * objects which are initiated on the root using the
-   * mpi_broadcast_command function below. Each received
-   * mpi_command is executed using the virtual run method.
+   * mpi_broadcast_command function below. Each command starts with
+   * a fixed size header. Registered commands are then constructed
+   * and run locally, while any other command is received as a
+   * serialized object and executed using the virtual run method.
    */
   void listen() {
     listening_status() = true;
@@ -158,6 +291,14 @@ struct mpi_cluster {
       // workers must fail
       std::unique_lock<std::mutex> worker_lock(in_use());
       while (1) {
+        mpi_command_header header;
+        mpi_broadcast_header(world_, header);
+
+        if (header.command_id != mpi_command_header::serialized_id) {
+          mpi_command_registry::run(header.command_id);
+          continue;
+        }
+
         std::shared_ptr<mpi_command> work;
 
         boost::mpi::broadcast(world_, work, 0);
@@ -198,16 +339,13 @@ struct mpi_cluster {
 };
 
 /**
- * Broadcasts a command instance to the listening cluster. This
+ * Acquires the cluster on the root for broadcasting a command. This
  * function must be called on the root whenever the cluster is in
  * listening mode and errs otherwise.
  *
- * @param command shared pointer to an instance of a command class
- * derived from mpi_command
  * @return A unique_lock instance locking the mpi_cluster
  */
-inline std::unique_lock<std::mutex> mpi_broadcast_command(
-    std::shared_ptr<mpi_command>& command) {
+inline std::unique_lock<std::mutex> mpi_lock_cluster() {
   boost::mpi::communicator world;
 
   if (world.rank() != 0)
@@ -222,13 +360,36 @@ inline std::unique_lock<std::mutex> mpi_broadcast_command(
   if (!cluster_lock.owns_lock())
     throw mpi_is_in_use();
 
+  return cluster_lock;
+}
+
+/**
+ * Broadcasts a command instance to the listening cluster. The
+ * command is serialized such that it may carry state. This
+ * function must be called on the root whenever the cluster is in
+ * listening mode and errs otherwise.
+ *
+ * @param command shared pointer to an instance of a command class
+ * derived from mpi_command
+ * @return A unique_lock instance locking the mpi_cluster
+ */
+inline std::unique_lock<std::mutex> mpi_broadcast_command(
+    std::shared_ptr<mpi_command>& command) {
+  std::unique_lock<std::mutex> cluster_lock = mpi_lock_cluster();
+
+  boost::mpi::communicator world;
+  mpi_command_header header;
+  mpi_broadcast_header(world, header);
   boost::mpi::broadcast(world, command, 0);
 
   return cluster_lock;
 }
 
 /**
- * Broadcasts default constructible commands to the cluster.
+ * Broadcasts default constructible commands to the cluster. Commands
+ * registered with the mpi_command_registry are only announced with
+ * their id in the fixed size command header, other commands are
+ * serialized.
  *
  * @tparam T default constructible command class derived from
  * mpi_command
@@ -236,9 +397,20 @@ inline std::unique_lock<std::mutex> mpi_broadcast_command(
  */
 template <typename T>
 std::unique_lock<std::mutex> mpi_broadcast_command() {
-  std::shared_ptr<mpi_command> command(new T);
+  const int command_id = mpi_command_registry::id<T>();
+  if (command_id == -1) {
+    std::shared_ptr<mpi_command> command(new T);
+    return mpi_broadcast_command(command);
+  }
 
-  return mpi_broadcast_command(command);
+  std::unique_lock<std::mutex> cluster_lock = mpi_lock_cluster();
+
+  boost::mpi::communicator world;
+  mpi_command_header header;
+  header.command_id = command_id;
+  mpi_broadcast_header(world, header);
+
+  return cluster_lock;
 }
 
 }  // namespace math
@@ -1,9 +1,14 @@
 #ifdef STAN_MPI
 
 #include <stan/math/prim/functor/mpi_cluster.hpp>
+#include <stan/math/prim/functor/mpi_profile.hpp>
 
 // register stop worker command (instantiates boost serialization
 // templates)
 STAN_REGISTER_MPI_COMMAND(stan::math::mpi_stop_worker)
 
+// register the commands switching the profiling of the workers
+STAN_REGISTER_MPI_COMMAND(stan::math::mpi_enable_profile)
+STAN_REGISTER_MPI_COMMAND(stan::math::mpi_disable_profile)
+
 #endif
@@ -7,6 +7,10 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
+#include <boost/preprocessor/cat.hpp>
+
+#include <type_traits>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -27,7 +31,10 @@ namespace math {
  *
  * For each declared command a call to the
  * STAN_REGISTER_MPI_COMMAND is required. This macro must be
- * called in the root namespace.
+ * called in the root namespace. Default constructible commands are
+ * in addition registered with the mpi_command_registry such that
+ * they can be sent to the workers as a fixed size binary header
+ * instead of a serialized object.
  */
 struct mpi_command {
   // declarations needed for boost.serialization (see
@@ -39,6 +46,90 @@ struct mpi_command {
   virtual void run() const = 0;
 };
 
+/**
+ * The registry of default constructible MPI commands assigns each
+ * registered command a numeric id. Commands are registered during
+ * static initialization of the program. Since all processes of the
+ * cluster run the same program, the ids are the same on all
+ * processes. The root then only needs to broadcast the id of a
+ * command and the workers construct and run the command locally,
+ * which avoids the allocation and the polymorphic serialization
+ * of the command object.
+ */
+class mpi_command_registry {
+ public:
+  using runner_t = void (*)();
+
+  mpi_command_registry() = delete;
+
+  /**
+   * Registers the command T if it is default constructible. A
+   * command registered multiple times keeps its first id.
+   *
+   * @tparam T command class derived from mpi_command
+   * @return id of the command or -1 if it cannot be registered
+   */
+  template <typename T>
+  static int add() {
+    return add<T>(std::is_default_constructible<T>());
+  }
+
+  /**
+   * Returns the id of the command T or -1 if T is not registered.
+   *
+   * @tparam T command class derived from mpi_command
+   */
+  template <typename T>
+  static int id() {
+    return command_id<T>();
+  }
+
+  /**
+   * Constructs and runs the command with the given id.
+   *
+   * @param command_id id of a registered command
+   * @throw std::out_of_range if no command is registered with the id
+   */
+  static void run(int command_id) { runners().at(command_id)(); }
+
+  /**
+   * Returns the number of registered commands.
+   */
+  static std::size_t size() { return runners().size(); }
+
+ private:
+  template <typename T>
+  static int& command_id() {
+    static int id = -1;
+    return id;
+  }
+
+  static std::vector<runner_t>& runners() {
+    static std::vector<runner_t> registered_runners;
+    return registered_runners;
+  }
+
+  template <typename T>
+  static void run_command() {
+    T().run();
+  }
+
+  template <typename T>
+  static int add(std::true_type) {
+    int& id = command_id<T>();
+    if (id == -1) {
+      id = runners().size();
+      runners().push_back(&run_command<T>);
+    }
+    return id;
+  }
+
+  template <typename T>
+  static int add(std::false_type) {
+    return -1;
+  }
+};
+
 }  // namespace math
 }  // namespace stan
 
@@ -48,7 +139,11 @@ BOOST_SERIALIZATION_ASSUME_ABSTRACT(stan::math::mpi_command)
   BOOST_CLASS_IMPLEMENTATION(command,                                   \
                              boost::serialization::object_serializable) \
   BOOST_CLASS_EXPORT(command)                                           \
-  BOOST_CLASS_TRACKING(command, boost::serialization::track_never)
+  BOOST_CLASS_TRACKING(command, boost::serialization::track_never)      \
+  namespace {                                                           \
+  const int BOOST_PP_CAT(stan_math_mpi_command_id_, __COUNTER__)        \
+      = stan::math::mpi_command_registry::add<command>();               \
+  }
 
 #endif
 
@@ -6,11 +6,21 @@
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/functor/mpi_cluster.hpp>
 #include <stan/math/prim/functor/mpi_distributed_apply.hpp>
+#include <stan/math/prim/functor/mpi_profile.hpp>
 #include <stan/math/prim/fun/to_array_1d.hpp>
 #include <stan/math/prim/fun/dims.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/task_arena.h>
+
+#include <boost/functional/hash.hpp>
+
 #include <mutex>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
 #include <vector>
 #include <type_traits>
 #include <functional>
@@ -70,6 +80,12 @@ class mpi_parallel_call_cache {
     is_valid_ = true;
   }
 
+  /**
+   * Invalidate the cache such that new data can be stored. This is
+   * used whenever the assignment of jobs to workers changes.
+   */
+  static void reset() { is_valid_ = false; }
+
   /**
    * Obtain const reference to locally cached data if cache is valid
    * (throws otherwise).
@@ -88,6 +104,41 @@ T mpi_parallel_call_cache<call_id, member, T>::local_;
 template <int call_id, int member, typename T>
 bool mpi_parallel_call_cache<call_id, member, T>::is_valid_ = false;
 
+/**
+ * State of the parameter transfer and the job run time estimates for
+ * a given call_id. The state is shared among all mpi_parallel_call
+ * instantiations of a call_id (like the double and the var variants
+ * of map_rect), since these share the assignment of the jobs to the
+ * workers. Thus, the parameters held by the workers always correspond
+ * to the current assignment, whichever variant sent them.
+ *
+ * @tparam call_id label of static data defined by the user
+ */
+template <int call_id>
+struct mpi_parallel_call_state {
+  // estimated run time of each job, only maintained on the root
+  static std::vector<double> job_costs_;
+
+  // parameters transferred with the previous call, the root holds
+  // all parameters and the workers the parameters of their local
+  // jobs only
+  static vector_d sent_shared_params_;
+  static matrix_d sent_job_params_;
+  static bool params_sent_;
+};
+
+template <int call_id>
+std::vector<double> mpi_parallel_call_state<call_id>::job_costs_;
+
+template <int call_id>
+vector_d mpi_parallel_call_state<call_id>::sent_shared_params_;
+
+template <int call_id>
+matrix_d mpi_parallel_call_state<call_id>::sent_job_params_;
+
+template <int call_id>
+bool mpi_parallel_call_state<call_id>::params_sent_ = false;
+
 }  // namespace internal
 
 /**
@@ -112,10 +163,11 @@ bool mpi_parallel_call_cache<call_id, member, T>::is_valid_ = false;
  * 4. The root then broadcasts and scatters all necessary data to the
  *    cluster. Static data (including meta information on data shapes)
  *    are locally cached such that static data is only transferred on
- *    the first evaluation. Note that the work is equally distributed
- *    among the workers. That is N jobs are distributed ot a cluster
- *    of size W in N/W chunks (the remainder is allocated to node 1
- *    onwards which ensures that the root node 0 has one job less).
+ *    the first evaluation. Note that the work is initially equally
+ *    distributed among the workers. That is N jobs are distributed ot
+ *    a cluster of size W in N/W chunks (the remainder is allocated to
+ *    node 1 onwards which ensures that the root node 0 has one job
+ *    less). See note 3 for the rebalancing of the work.
  * 5. Once the parameters and static data is distributed, the reduce
  *    operation is applied per defined job. Each job is allowed to
  *    return a different number of outputs such that the resulting
@@ -150,6 +202,53 @@ bool mpi_parallel_call_cache<call_id, member, T>::is_valid_ = false;
  * this meta info is only done when all workers have successfully
  * evaluated the function and otherwise an exception is raised.
  *
+ * Note 3: The run time of each job is measured and collected on the
+ * root after every successful evaluation. Whenever the measured
+ * costs predict that the slowest worker would finish considerably
+ * earlier with a cost-aware assignment of consecutive jobs to the
+ * workers (see mpi_map_chunks), the root broadcasts the new
+ * assignment at the beginning of the next call. The locally cached
+ * static data and the parameters are then scattered again according
+ * to the new assignment. The run time estimates and the transferred
+ * parameters are shared by all instantiations for a call_id, since
+ * these share the assignment (see internal::mpi_parallel_call_state).
+ *
+ * Note 4: Once the output sizes are cached, the results are not
+ * gathered with a blocking collective after all local jobs are
+ * done. Instead, the root posts non-blocking receives for every
+ * remote job directly into the combined result and evaluates its own
+ * jobs meanwhile. The workers send the output of each job with a
+ * non-blocking send right after its evaluation. The status of every
+ * worker is then collected together with the run times of its jobs
+ * in a single gather.
+ *
+ * Note 5: Whenever STAN_THREADS is defined, each process evaluates
+ * its local jobs in parallel using the TBB threads of the process
+ * (hybrid MPI and threading) and the outputs are sent once all local
+ * jobs are done. The number of threads of each process is collected
+ * during the first call and the jobs are assigned to the processes
+ * proportional to their number of threads.
+ *
+ * Note 6: After the first call only the parameters which changed
+ * since the previous call are transferred. The root broadcasts a
+ * small header with the number of changed shared parameters and the
+ * number of changed job parameter columns of every worker. Only the
+ * changed shared parameters are broadcasted and only the changed
+ * columns are sent to the worker owning the respective job. In
+ * addition, the root keeps the results of the most recent calls
+ * keyed by a hash of the parameters. Whenever a call is made with
+ * the parameters of a cached result, the cached result is combined
+ * right away without involving the workers at all. As the static
+ * data must not change between calls, the results only depend on the
+ * parameters.
+ *
+ * Note 7: Whenever the profiling is enabled (see mpi_profile), each
+ * process measures the wall time spent on its jobs, the time it
+ * waits for the remaining processes once its jobs are done and the
+ * payload it sends and receives during the call. The measurements
+ * are gathered on the root at the end of every call, except for
+ * failed first evaluations (see note 2).
+ *
  * @tparam call_id label for the static data
  * @tparam ReduceF reduce function called for each job, \see
  * internal::map_rect_reduce
@@ -177,15 +276,46 @@ class mpi_parallel_call {
       = internal::mpi_parallel_call_cache<call_id, 3, std::vector<int>>;
   using cache_chunks
       = internal::mpi_parallel_call_cache<call_id, 4, std::vector<int>>;
+  using cache_threads
+      = internal::mpi_parallel_call_cache<call_id, 5, std::vector<int>>;
 
   // # of outputs for given call_id+ReduceF+CombineF case
   static int num_outputs_per_job_;
 
+  // job run time estimates and parameters of the previous call which
+  // are shared with all other instantiations for the call_id
+  using call_state = internal::mpi_parallel_call_state<call_id>;
+
+  // minimal relative and absolute (in seconds) reduction of the
+  // load of the slowest worker which triggers a reassignment of the
+  // jobs
+  static constexpr double rebalance_threshold_ = 0.1;
+  static constexpr double rebalance_min_saving_ = 1e-3;
+
+  // results of the most recent calls, only maintained on the root
+  struct cached_result {
+    std::size_t hash;
+    vector_d shared_params;
+    matrix_d job_params;
+    matrix_d world_result;
+  };
+  static std::vector<cached_result> result_cache_;
+  static constexpr std::size_t result_cache_size_ = 4;
+
   CombineF combine_;
 
   vector_d local_shared_params_dbl_;
   matrix_d local_job_params_dbl_;
 
+  // the result of this call if it was found in the result cache
+  bool is_cached_result_ = false;
+  matrix_d cached_world_result_;
+
+  // measurements of this call for the profiling (see note 7)
+  double compute_time_ = 0;
+  double bytes_ = 0;
+  std::chrono::steady_clock::time_point jobs_done_;
+
  public:
   /**
    * Initiates a parallel MPI call on the root. The constructor
@@ -223,10 +353,6 @@ class mpi_parallel_call {
                        cached_num_jobs, "number of jobs", job_params.size());
     }
 
-    // make children aware of upcoming job & obtain cluster lock
-    cluster_lock_ = mpi_broadcast_command<stan::math::mpi_distributed_apply<
-        mpi_parallel_call<call_id, ReduceF, CombineF>>>();
-
     const std::vector<int> job_dims = dims(job_params);
 
     const size_type num_jobs = job_dims[0];
@@ -238,6 +364,18 @@ class mpi_parallel_call {
     for (int j = 0; j < num_jobs; ++j)
       job_params_dbl.col(j) = value_of(job_params[j]);
 
+    // the workers are not needed whenever the result is known, but
+    // the cluster is still locked for the lifetime of this call
+    cluster_lock_ = mpi_lock_cluster();
+    is_cached_result_ = find_result(shared_params_dbl, job_params_dbl);
+    if (is_cached_result_)
+      return;
+    cluster_lock_.unlock();
+
+    // make children aware of upcoming job & obtain cluster lock
+    cluster_lock_ = mpi_broadcast_command<stan::math::mpi_distributed_apply<
+        mpi_parallel_call<call_id, ReduceF, CombineF>>>();
+
     setup_call(shared_params_dbl, job_params_dbl, x_r, x_i);
   }
 
@@ -265,145 +403,294 @@ class mpi_parallel_call {
    * evaluates all assigned function evaluations locally, transfers
    * all results back to the root and finally combines on the root all
    * results.
+   *
+   * As soon as the output sizes are known (see note 2), the results
+   * are pipelined (see note 4). Results found in the result cache
+   * are combined right away (see note 6).
    */
   result_t reduce_combine() {
+    if (is_cached_result_) {
+      return combine_(cached_world_result_, cache_f_out::data());
+    }
+    if (num_outputs_per_job_ == -1 || !cache_f_out::is_valid()) {
+      return reduce_combine_first();
+    }
+    return reduce_combine_pipelined();
+  }
+
+ private:
+  // tag of the point-to-point messages carrying job outputs
+  static constexpr int output_tag_ = 0;
+
+  /**
+   * Evaluates the assigned jobs during the first evaluation whenever
+   * the output sizes are not yet known. The status of all workers
+   * and the output sizes of all jobs are collected with a single
+   * gather on the root, which then broadcasts the verdict together
+   * with the number of outputs per job.
+   */
+  result_t reduce_combine_first() {
     const std::vector<int>& job_chunks = cache_chunks::data();
     const int num_jobs = sum(job_chunks);
 
-    const int first_job
-        = std::accumulate(job_chunks.begin(), job_chunks.begin() + rank_, 0);
     const int num_local_jobs = local_job_params_dbl_.cols();
     int local_outputs_per_job = num_local_jobs == 0 ? 0 : num_outputs_per_job_;
-    matrix_d local_output(
-        local_outputs_per_job == -1 ? 0 : local_outputs_per_job,
-        num_local_jobs);
+    matrix_d local_output;
     std::vector<int> local_f_out(num_local_jobs, -1);
+    std::vector<double> local_costs(num_local_jobs, 0.0);
 
     typename cache_x_r::cache_t& local_x_r = cache_x_r::data();
     typename cache_x_i::cache_t& local_x_i = cache_x_i::data();
 
-    // check if we know already output sizes
-    if (cache_f_out::is_valid()) {
-      typename cache_f_out::cache_t& f_out = cache_f_out::data();
-      const int num_outputs
-          = std::accumulate(f_out.begin() + first_job,
-                            f_out.begin() + first_job + num_local_jobs, 0);
-      local_output.resize(Eigen::NoChange, num_outputs);
-    }
-
-    int local_ok = 1;
-    try {
-      for (int i = 0, offset = 0; i < num_local_jobs;
-           offset += local_f_out[i], ++i) {
-        const matrix_d job_output
-            = ReduceF()(local_shared_params_dbl_, local_job_params_dbl_.col(i),
-                        local_x_r[i], local_x_i[i], 0);
-        local_f_out[i] = job_output.cols();
-
-        if (local_outputs_per_job == -1) {
-          local_outputs_per_job = job_output.rows();
-          // changing rows, but leave column size as is
-          local_output.conservativeResize(local_outputs_per_job,
-                                          Eigen::NoChange);
-        }
-
-        if (local_output.cols() < offset + local_f_out[i])
-          // leave row size, but change columns size
-          local_output.conservativeResize(Eigen::NoChange,
-                                          2 * (offset + local_f_out[i]));
-
-        local_output.block(0, offset, local_output.rows(), local_f_out[i])
-            = job_output;
+    std::vector<matrix_d> job_outputs(num_local_jobs);
+    int local_ok = evaluate_local_jobs(
+        [&](int i) {
+          job_outputs[i] = ReduceF()(local_shared_params_dbl_,
+                                     local_job_params_dbl_.col(i),
+                                     local_x_r[i], local_x_i[i], 0);
+          return true;
+        },
+        [](int i) {}, local_costs);
+
+    // assemble the outputs of all local jobs
+    if (local_ok) {
+      int local_cols = 0;
+      for (int i = 0; i < num_local_jobs; ++i) {
+        local_f_out[i] = job_outputs[i].cols();
+        local_cols += local_f_out[i];
+        if (local_outputs_per_job == -1)
+          local_outputs_per_job = job_outputs[i].rows();
+        if (job_outputs[i].rows() != local_outputs_per_job)
+          local_ok = 0;
+      }
+      if (local_ok) {
+        local_output.resize(local_outputs_per_job, local_cols);
+        for (int i = 0, offset = 0; i < num_local_jobs;
+             offset += local_f_out[i], ++i)
+          local_output.block(0, offset, local_outputs_per_job, local_f_out[i])
+              = job_outputs[i];
       }
-    } catch (const std::exception& e) {
-      // see note 1 above for an explanation why we do not rethrow
-      // here, but mereley flag it to keep the cluster synchronized
-      local_ok = 0;
     }
 
-    // during first execution we distribute the output sizes from
-    // local jobs to the root. This needs to be done for the number of
-    // outputs of each result and the number of outputs per job.
-    if (num_outputs_per_job_ == -1) {
-      // before we can cache the sizes locally we must ensure
-      // that no exception has been fired from any node. Hence,
-      // share the info about the current status across all nodes.
-      int cluster_status = 0;
-      boost::mpi::reduce(world_, local_ok, cluster_status, std::plus<int>(), 0);
-      bool all_ok = cluster_status == static_cast<int>(world_size_);
-      boost::mpi::broadcast(world_, all_ok, 0);
-      if (!all_ok) {
-        // err out on the root
-        if (rank_ == 0) {
-          throw std::domain_error("MPI error on first evaluation.");
+    // handshake: the status, the number of outputs per job and the
+    // output sizes of every job are collected on the root at once
+    std::vector<int> local_meta(2 + num_local_jobs);
+    local_meta[0] = local_ok;
+    local_meta[1] = num_local_jobs == 0 ? -1 : local_outputs_per_job;
+    std::copy(local_f_out.begin(), local_f_out.end(), local_meta.begin() + 2);
+
+    std::vector<int> chunks_meta(job_chunks);
+    for (int& chunk : chunks_meta)
+      chunk += 2;
+    std::vector<int> world_meta(2 * world_size_ + num_jobs, 0);
+    boost::mpi::gatherv(world_, local_meta.data(), local_meta.size(),
+                        world_meta.data(), chunks_meta, 0);
+    count_gather<int>(chunks_meta);
+
+    std::vector<int> world_f_out(num_jobs, 0);
+    std::vector<int> verdict(2, 0);
+    if (rank_ == 0) {
+      int all_ok = 1;
+      int outputs_per_job = -1;
+      for (std::size_t r = 0, k = 0, pos = 0; r != world_size_; ++r) {
+        all_ok = all_ok && world_meta[pos];
+        const int rank_outputs_per_job = world_meta[pos + 1];
+        if (rank_outputs_per_job != -1) {
+          if (outputs_per_job != -1 && outputs_per_job != rank_outputs_per_job)
+            all_ok = 0;
+          outputs_per_job = rank_outputs_per_job;
         }
-        // and ensure on the workers that they return into their
-        // listening state
-        return result_t();
+        for (int j = 0; j != job_chunks[r]; ++j, ++k)
+          world_f_out[k] = world_meta[pos + 2 + j];
+        pos += 2 + job_chunks[r];
       }
+      // the output sizes must match the cached sizes if known
+      if (cache_f_out::is_valid() && cache_f_out::data() != world_f_out)
+        all_ok = 0;
+      verdict[0] = all_ok;
+      verdict[1] = outputs_per_job == -1 ? 0 : outputs_per_job;
+    }
+    boost::mpi::broadcast(world_, verdict.data(), 2, 0);
+    count_broadcast<int>(2);
 
-      // execution was ok everywhere such that we can now distribute the
-      // outputs per job as recorded on the root on the first execution
-      boost::mpi::broadcast(world_, local_outputs_per_job, 0);
-      num_outputs_per_job_ = local_outputs_per_job;
-
-      // the f_out cache may not yet be synchronized which we can do
-      // now given that this first execution was just fine
-      if (!cache_f_out::is_valid()) {
-        std::vector<int> world_f_out(num_jobs, 0);
-        boost::mpi::gatherv(world_, local_f_out.data(), num_local_jobs,
-                            world_f_out.data(), job_chunks, 0);
-        // on the root we now have all sizes from all children. Copy
-        // over the local sizes to the world vector on each local node
-        // in order to cache this information locally.
-        std::copy(local_f_out.begin(), local_f_out.end(),
-                  world_f_out.begin() + first_job);
-        cache_f_out::store(world_f_out);
+    if (!verdict[0]) {
+      // err out on the root
+      if (rank_ == 0) {
+        throw std::domain_error("MPI error on first evaluation.");
       }
+      // and ensure on the workers that they return into their
+      // listening state
+      return result_t();
     }
 
-    typename cache_f_out::cache_t& world_f_out = cache_f_out::data();
+    num_outputs_per_job_ = verdict[1];
 
-    // check that cached sizes are the same as just collected from
-    // this evaluation
-    for (int i = 0; i < num_local_jobs; ++i) {
-      if (world_f_out[first_job + i] != local_f_out[i]) {
-        // in case of a mismatch we mark so, but flag the error only
-        // on the root, see note 1 above.
-        local_ok = 0;
-        break;
+    // the workers only know the output sizes of their local jobs,
+    // which is all they need
+    if (!cache_f_out::is_valid()) {
+      if (rank_ != 0) {
+        const int first_job = std::accumulate(
+            job_chunks.begin(), job_chunks.begin() + rank_, 0);
+        std::copy(local_f_out.begin(), local_f_out.end(),
+                  world_f_out.begin() + first_job);
       }
+      cache_f_out::store(world_f_out);
     }
 
-    const std::size_t size_world_f_out = sum(world_f_out);
+    typename cache_f_out::cache_t& cached_f_out = cache_f_out::data();
+    const std::size_t size_world_f_out = sum(cached_f_out);
     matrix_d world_result(num_outputs_per_job_, size_world_f_out);
 
     std::vector<int> chunks_result(world_size_, 0);
     for (std::size_t i = 0, k = 0; i != world_size_; ++i)
       for (int j = 0; j != job_chunks[i]; ++j, ++k)
-        chunks_result[i] += world_f_out[k] * num_outputs_per_job_;
+        chunks_result[i] += cached_f_out[k] * num_outputs_per_job_;
 
     // collect results on root
     boost::mpi::gatherv(world_, local_output.data(), chunks_result[rank_],
                         world_result.data(), chunks_result, 0);
+    count_gather<double>(chunks_result);
+
+    // collect run times of all jobs on root
+    std::vector<double> world_costs(num_jobs, 0.0);
+    boost::mpi::gatherv(world_, local_costs.data(), num_local_jobs,
+                        world_costs.data(), job_chunks, 0);
+    count_gather<double>(job_chunks);
+
+    gather_profile(num_local_jobs);
+
+    // on the workers all is done now.
+    if (rank_ != 0)
+      return result_t();
+
+    update_job_costs(world_costs);
+    store_result(world_result);
+
+    return combine_(world_result, cached_f_out);
+  }
+
+  /**
+   * Evaluates the assigned jobs once the output sizes are known. The
+   * root posts non-blocking receives for the outputs of all jobs
+   * directly into their final position in the combined result, while
+   * the workers send the output of each job with a non-blocking send
+   * as soon as it is evaluated. The status of each worker and the
+   * run times of its jobs are collected with a single gather.
+   */
+  result_t reduce_combine_pipelined() {
+    const std::vector<int>& job_chunks = cache_chunks::data();
+    const int num_jobs = sum(job_chunks);
+    typename cache_f_out::cache_t& world_f_out = cache_f_out::data();
+    const int rows = num_outputs_per_job_;
+
+    const int first_job
+        = std::accumulate(job_chunks.begin(), job_chunks.begin() + rank_, 0);
+    const int num_local_jobs = local_job_params_dbl_.cols();
+
+    // column offset of each job within the combined result
+    std::vector<int> offsets(num_jobs + 1, 0);
+    std::partial_sum(world_f_out.begin(), world_f_out.end(),
+                     offsets.begin() + 1);
+
+    matrix_d world_result;
+    matrix_d local_output;
+    double* local_first = nullptr;
+    std::vector<boost::mpi::request> requests;
+
+    if (rank_ == 0) {
+      world_result.resize(rows, offsets[num_jobs]);
+      local_first = world_result.data();
+      requests.reserve(num_jobs - num_local_jobs);
+      for (std::size_t r = 1, k = job_chunks[0]; r != world_size_; ++r) {
+        for (int j = 0; j != job_chunks[r]; ++j, ++k) {
+          requests.push_back(world_.irecv(
+              r, output_tag_, world_result.data() + offsets[k] * rows,
+              world_f_out[k] * rows));
+          bytes_ += world_f_out[k] * rows * sizeof(double);
+        }
+      }
+    } else {
+      local_output.resize(
+          rows, offsets[first_job + num_local_jobs] - offsets[first_job]);
+      local_first = local_output.data();
+      requests.reserve(num_local_jobs);
+    }
+
+    typename cache_x_r::cache_t& local_x_r = cache_x_r::data();
+    typename cache_x_i::cache_t& local_x_i = cache_x_i::data();
+
+    auto job_first = [&](int i) {
+      return local_first + (offsets[first_job + i] - offsets[first_job]) * rows;
+    };
+
+    // see note 1 above: after a failure the remaining jobs are
+    // skipped, but their (meaningless) outputs are still sent
+    std::vector<double> local_costs(num_local_jobs, 0.0);
+    const int local_ok = evaluate_local_jobs(
+        [&](int i) {
+          const int k = first_job + i;
+          const matrix_d job_output = ReduceF()(
+              local_shared_params_dbl_, local_job_params_dbl_.col(i),
+              local_x_r[i], local_x_i[i], 0);
+          if (job_output.rows() != rows || job_output.cols() != world_f_out[k])
+            return false;
+          Eigen::Map<matrix_d>(job_first(i), rows, world_f_out[k])
+              = job_output;
+          return true;
+        },
+        [&](int i) {
+          if (rank_ != 0) {
+            requests.push_back(world_.isend(0, output_tag_, job_first(i),
+                                            world_f_out[first_job + i] * rows));
+            bytes_ += world_f_out[first_job + i] * rows * sizeof(double);
+          }
+        },
+        local_costs);
+
+    std::vector<double> local_status(1 + num_local_jobs, 0.0);
+    local_status[0] = local_ok;
+    std::copy(local_costs.begin(), local_costs.end(), local_status.begin() + 1);
+
+    if (rank_ != 0)
+      boost::mpi::wait_all(requests.begin(), requests.end());
+
+    // collect status and run times of all jobs on root
+    std::vector<int> chunks_status(job_chunks);
+    for (int& chunk : chunks_status)
+      chunk += 1;
+    std::vector<double> world_status(world_size_ + num_jobs, 0.0);
+    boost::mpi::gatherv(world_, local_status.data(), local_status.size(),
+                        world_status.data(), chunks_status, 0);
+    count_gather<double>(chunks_status);
+
+    if (rank_ == 0)
+      boost::mpi::wait_all(requests.begin(), requests.end());
 
-    // let root know if all went fine everywhere
-    int cluster_status = 0;
-    boost::mpi::reduce(world_, local_ok, cluster_status, std::plus<int>(), 0);
-    bool all_ok = cluster_status == static_cast<int>(world_size_);
+    gather_profile(num_local_jobs);
 
     // on the workers all is done now.
     if (rank_ != 0)
       return result_t();
 
+    std::vector<double> world_costs(num_jobs, 0.0);
+    bool all_ok = true;
+    for (std::size_t r = 0, k = 0, pos = 0; r != world_size_; ++r) {
+      all_ok = all_ok && world_status[pos] == 1.0;
+      for (int j = 0; j != job_chunks[r]; ++j, ++k)
+        world_costs[k] = world_status[pos + 1 + j];
+      pos += 1 + job_chunks[r];
+    }
+
     // in case something went wrong we throw on the root
     if (!all_ok)
       throw std::domain_error("Error during MPI evaluation.");
 
+    update_job_costs(world_costs);
+    store_result(world_result);
+
     return combine_(world_result, world_f_out);
   }
 
- private:
   /**
    * Performs a cached scatter of a 2D array (nested std::vector). On the
    * first call the data on the root is scattered to all workers and
@@ -433,10 +720,12 @@ class mpi_parallel_call {
     data_dims.resize(2);
 
     boost::mpi::broadcast(world_, data_dims.data(), 2, 0);
+    count_broadcast<int>(2);
 
-    const std::vector<int> job_chunks = mpi_map_chunks(data_dims[0], 1);
-    const std::vector<int> data_chunks
-        = mpi_map_chunks(data_dims[0], data_dims[1]);
+    const std::vector<int>& job_chunks = cache_chunks::data();
+    std::vector<int> data_chunks(job_chunks);
+    for (int& chunk : data_chunks)
+      chunk *= data_dims[1];
 
     auto flat_data = to_array_1d(data);
     decltype(flat_data) local_flat_data(data_chunks[rank_]);
@@ -449,6 +738,7 @@ class mpi_parallel_call {
         boost::mpi::scatterv(world_, local_flat_data.data(), data_chunks[rank_],
                              0);
       }
+      count_gather<typename decltype(flat_data)::value_type>(data_chunks);
     }
 
     std::vector<decltype(flat_data)> local_data;
@@ -493,6 +783,8 @@ class mpi_parallel_call {
     local_data.resize(data_size);
 
     boost::mpi::broadcast(world_, local_data.data(), data_size, 0);
+    count_broadcast<std::size_t>(1);
+    count_broadcast<typename T_cache::cache_t::value_type>(data_size);
     T_cache::store(local_data);
     return T_cache::data();
   }
@@ -521,6 +813,7 @@ class mpi_parallel_call {
     local_data.resize(data_size[0]);
 
     boost::mpi::broadcast(world_, local_data.data(), data_size[0], 0);
+    count_broadcast<double>(data_size[0]);
 
     return local_data;
   }
@@ -547,8 +840,10 @@ class mpi_parallel_call {
     const size_type rows = dims[0];
     const size_type total_cols = dims[1];
 
-    const std::vector<int> job_chunks = mpi_map_chunks(total_cols, 1);
-    const std::vector<int> data_chunks = mpi_map_chunks(total_cols, rows);
+    const std::vector<int>& job_chunks = cache_chunks::data();
+    std::vector<int> data_chunks(job_chunks);
+    for (int& chunk : data_chunks)
+      chunk *= rows;
     matrix_d local_data(rows, job_chunks[rank_]);
     if (rows * total_cols > 0) {
       if (rank_ == 0) {
@@ -557,19 +852,436 @@ class mpi_parallel_call {
       } else {
         boost::mpi::scatterv(world_, local_data.data(), data_chunks[rank_], 0);
       }
+      count_gather<double>(data_chunks);
     }
 
     return local_data;
   }
 
+  /**
+   * Evaluates all local jobs and records their run times. Whenever
+   * STAN_THREADS is defined the jobs are evaluated in parallel by the
+   * TBB threads of the process and the done functor is called in
+   * job order after all jobs are evaluated. Otherwise each job is
+   * followed immediately by the call of the done functor. Once a job
+   * failed, the evaluation of the remaining jobs is skipped. MPI
+   * communication must only happen in the done functor, which is
+   * always called from the thread calling this function.
+   *
+   * @tparam JobF type of functor evaluating a job
+   * @tparam DoneF type of functor called once a job is evaluated
+   * @param job functor evaluating the job with the given local
+   * index, returns false if the job failed
+   * @param done functor called with the local index of each job
+   * @param[out] costs run time of each local job
+   * @return 1 if all jobs were successfully evaluated, 0 otherwise
+   */
+  template <typename JobF, typename DoneF>
+  int evaluate_local_jobs(const JobF& job, const DoneF& done,
+                          std::vector<double>& costs) {
+    const int num_local_jobs = costs.size();
+    std::atomic<int> local_ok{1};
+    const auto start = std::chrono::steady_clock::now();
+
+    auto evaluate = [&](int i) {
+      if (local_ok.load() == 0)
+        return;
+      try {
+        const auto start = std::chrono::steady_clock::now();
+        const bool job_ok = job(i);
+        const std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        costs[i] = elapsed.count();
+        if (!job_ok)
+          local_ok = 0;
+      } catch (const std::exception& e) {
+        // see note 1 above for an explanation why we do not rethrow
+        // here, but mereley flag it to keep the cluster synchronized
+        local_ok = 0;
+      }
+    };
+
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_local_jobs),
+                      [&](const tbb::blocked_range<int>& r) {
+                        for (int i = r.begin(); i != r.end(); ++i)
+                          evaluate(i);
+                      });
+    for (int i = 0; i < num_local_jobs; ++i)
+      done(i);
+#else
+    for (int i = 0; i < num_local_jobs; ++i) {
+      evaluate(i);
+      done(i);
+    }
+#endif
+
+    jobs_done_ = std::chrono::steady_clock::now();
+    const std::chrono::duration<double> elapsed = jobs_done_ - start;
+    compute_time_ = elapsed.count();
+
+    return local_ok.load();
+  }
+
+  /**
+   * Counts the payload of a broadcast sent by the root to all workers
+   * or received by a worker.
+   *
+   * @tparam T type of the elements
+   * @param size number of elements
+   */
+  template <typename T>
+  void count_broadcast(std::size_t size) {
+    bytes_ += size * sizeof(T) * (rank_ == 0 ? world_size_ - 1 : 1);
+  }
+
+  /**
+   * Counts the payload of a scatter or gather exchanged by the root
+   * with all workers or by a worker with the root.
+   *
+   * @tparam T type of the elements
+   * @param chunks number of elements of each process
+   */
+  template <typename T>
+  void count_gather(const std::vector<int>& chunks) {
+    const std::size_t size = rank_ == 0 ? sum(chunks) - chunks[0]
+                                        : chunks[rank_];
+    bytes_ += size * sizeof(T);
+  }
+
+  /**
+   * Collects the measurements of this call on the root and adds them
+   * to the statistics of the call_id if the profiling is enabled (see
+   * note 7). Must be called on all processes.
+   *
+   * @param num_local_jobs number of jobs evaluated by this process
+   */
+  void gather_profile(int num_local_jobs) {
+    if (!mpi_profile::is_enabled())
+      return;
+
+    const std::chrono::duration<double> wait_time
+        = std::chrono::steady_clock::now() - jobs_done_;
+    const std::vector<double> local_stats{static_cast<double>(num_local_jobs),
+                                          compute_time_, wait_time.count(),
+                                          bytes_};
+    std::vector<double> world_stats(4 * world_size_, 0.0);
+    boost::mpi::gather(world_, local_stats.data(), 4, world_stats.data(), 0);
+
+    if (rank_ == 0)
+      mpi_profile::record(call_id, world_stats);
+  }
+
+  /**
+   * Collects the number of threads of each process during the first
+   * call and caches them on all processes.
+   *
+   * @return number of threads indexed by rank
+   */
+  typename cache_threads::cache_t& gather_threads_cached() {
+    if (cache_threads::is_valid()) {
+      return cache_threads::data();
+    }
+
+    int local_threads = 1;
+#ifdef STAN_THREADS
+    local_threads = tbb::this_task_arena::max_concurrency();
+#endif
+    std::vector<int> world_threads(world_size_, 1);
+    boost::mpi::gather(world_, local_threads, world_threads.data(), 0);
+    count_gather<int>(std::vector<int>(world_size_, 1));
+    return broadcast_array_1d_cached<cache_threads>(world_threads);
+  }
+
+  /**
+   * Updates on the root the estimated run time of each job with the
+   * run times measured during the last evaluation. The estimate is
+   * the average of the previous estimate and the last measurement.
+   *
+   * @param world_costs run times of all jobs measured on the workers
+   */
+  void update_job_costs(const std::vector<double>& world_costs) {
+    std::vector<double>& job_costs = call_state::job_costs_;
+    if (job_costs.size() != world_costs.size()) {
+      job_costs = world_costs;
+      return;
+    }
+    for (std::size_t i = 0; i != world_costs.size(); ++i)
+      job_costs[i] = 0.5 * (job_costs[i] + world_costs[i]);
+  }
+
+  /**
+   * Returns the summed estimated costs per thread of the worker with
+   * the highest load for the given assignment of jobs to workers.
+   *
+   * @param job_chunks number of jobs assigned to each worker
+   * @return estimated run time of the slowest worker
+   */
+  static double max_load(const std::vector<int>& job_chunks) {
+    typename cache_threads::cache_t& world_threads = cache_threads::data();
+    double max_cost = 0.0;
+    for (std::size_t r = 0, i = 0; r != job_chunks.size(); ++r) {
+      double cost = 0.0;
+      for (int j = 0; j != job_chunks[r]; ++j, ++i)
+        cost += call_state::job_costs_[i];
+      max_cost = std::max(max_cost, cost / world_threads[r]);
+    }
+    return max_cost;
+  }
+
+  /**
+   * Reassigns the jobs to the workers whenever the run times
+   * measured on the root predict a sufficiently better balanced
+   * assignment. The new assignment is broadcasted to the cluster
+   * and the caches of all static data which depend on the
+   * assignment are invalidated or synchronized. Must be called on
+   * all nodes once the job assignment is cached.
+   */
+  void rebalance_chunks() {
+    const std::vector<int>& job_chunks = cache_chunks::data();
+    const std::size_t num_jobs = sum(job_chunks);
+
+    bool rebalance = false;
+    std::vector<int> new_job_chunks(world_size_, 0);
+    const std::vector<double>& job_costs = call_state::job_costs_;
+    if (rank_ == 0 && job_costs.size() == num_jobs) {
+      new_job_chunks = mpi_map_chunks(job_costs, cache_threads::data(), 1);
+      const double current_load = max_load(job_chunks);
+      const double new_load = max_load(new_job_chunks);
+      rebalance = new_job_chunks != job_chunks
+                  && new_load < (1.0 - rebalance_threshold_) * current_load
+                  && current_load - new_load > rebalance_min_saving_;
+    }
+    boost::mpi::broadcast(world_, rebalance, 0);
+    count_broadcast<bool>(1);
+
+    if (!rebalance)
+      return;
+
+    boost::mpi::broadcast(world_, new_job_chunks.data(), world_size_, 0);
+    count_broadcast<int>(world_size_);
+    cache_chunks::reset();
+    cache_chunks::store(new_job_chunks);
+
+    // the static data and the parameters are scattered again with
+    // the new assignment
+    cache_x_r::reset();
+    cache_x_i::reset();
+    call_state::params_sent_ = false;
+
+    // the output sizes are only complete on the root
+    if (cache_f_out::is_valid()) {
+      std::vector<int> world_f_out = cache_f_out::data();
+      world_f_out.resize(num_jobs);
+      boost::mpi::broadcast(world_, world_f_out.data(), num_jobs, 0);
+      count_broadcast<int>(num_jobs);
+      cache_f_out::reset();
+      cache_f_out::store(world_f_out);
+    }
+  }
+
+  /**
+   * Hash of the parameters used to look up cached results.
+   */
+  static std::size_t hash_params(const vector_d& shared_params,
+                                 const matrix_d& job_params) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, shared_params.size());
+    boost::hash_combine(seed, job_params.size());
+    boost::hash_range(seed, shared_params.data(),
+                      shared_params.data() + shared_params.size());
+    boost::hash_range(seed, job_params.data(),
+                      job_params.data() + job_params.size());
+    return seed;
+  }
+
+  /**
+   * Looks up the result of a previous call with the same parameters
+   * on the root. A found result is moved to the front of the result
+   * cache and copied to this call.
+   *
+   * @return true if the result was found
+   */
+  bool find_result(const vector_d& shared_params, const matrix_d& job_params) {
+    if (num_outputs_per_job_ == -1 || !cache_f_out::is_valid())
+      return false;
+
+    const std::size_t hash = hash_params(shared_params, job_params);
+    for (auto entry = result_cache_.begin(); entry != result_cache_.end();
+         ++entry) {
+      if (entry->hash == hash
+          && entry->shared_params.size() == shared_params.size()
+          && entry->job_params.rows() == job_params.rows()
+          && entry->job_params.cols() == job_params.cols()
+          && entry->shared_params == shared_params
+          && entry->job_params == job_params) {
+        std::rotate(result_cache_.begin(), entry, entry + 1);
+        cached_world_result_ = result_cache_.front().world_result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Stores the result of a successful call for the parameters sent
+   * with this call on the root. The least recently used result is
+   * dropped once the result cache is full.
+   */
+  void store_result(const matrix_d& world_result) {
+    const vector_d& shared_params = call_state::sent_shared_params_;
+    const matrix_d& job_params = call_state::sent_job_params_;
+    cached_result entry{hash_params(shared_params, job_params), shared_params,
+                        job_params, world_result};
+    if (result_cache_.size() == result_cache_size_)
+      result_cache_.pop_back();
+    result_cache_.insert(result_cache_.begin(), std::move(entry));
+  }
+
+  /**
+   * Transfers the parameters to the cluster. On the first call (and
+   * after the jobs have been reassigned) all parameters are
+   * transferred. Otherwise only the shared parameters and the job
+   * parameter columns which changed since the previous call are
+   * sent (see note 6).
+   *
+   * @param shared_params shared parameters on the root and a dummy
+   * argument on workers
+   * @param job_params job parameters (one column per job) on the root
+   * and a dummy argument on workers
+   */
+  void transfer_params(const vector_d& shared_params,
+                       const matrix_d& job_params) {
+    const std::vector<int>& job_chunks = cache_chunks::data();
+    vector_d& sent_shared_params = call_state::sent_shared_params_;
+    matrix_d& sent_job_params = call_state::sent_job_params_;
+
+    if (!call_state::params_sent_) {
+      sent_shared_params = broadcast_vector<-1>(shared_params);
+      matrix_d local_job_params = scatter_matrix<-2>(job_params);
+      sent_job_params = rank_ == 0 ? job_params : local_job_params;
+      call_state::params_sent_ = true;
+    } else {
+      update_params(shared_params, job_params);
+    }
+
+    local_shared_params_dbl_ = sent_shared_params;
+    local_job_params_dbl_ = sent_job_params.leftCols(job_chunks[rank_]);
+  }
+
+  /**
+   * Sends the changed parameters to the cluster and updates the
+   * parameters of the previous call on all nodes. The header holds
+   * the number of changed shared parameters (-1 if all are sent)
+   * followed by the number of changed job parameter columns of each
+   * worker. The changed shared parameters are broadcasted as pairs of
+   * index and value, while each changed column is sent to its worker
+   * preceded by its local column index.
+   *
+   * @param shared_params shared parameters on the root and a dummy
+   * argument on workers
+   * @param job_params job parameters (one column per job) on the root
+   * and a dummy argument on workers
+   */
+  void update_params(const vector_d& shared_params,
+                     const matrix_d& job_params) {
+    const std::vector<int>& job_chunks = cache_chunks::data();
+    vector_d& sent_shared_params = call_state::sent_shared_params_;
+    matrix_d& sent_job_params = call_state::sent_job_params_;
+    const size_type num_shared = sent_shared_params.size();
+    const size_type rows = sent_job_params.rows();
+
+    std::vector<int> header(1 + world_size_, 0);
+    std::vector<double> shared_delta;
+    std::vector<double> job_delta;
+
+    if (rank_ == 0) {
+      std::vector<int> changed;
+      for (size_type i = 0; i < num_shared; ++i)
+        if (shared_params(i) != sent_shared_params(i))
+          changed.push_back(i);
+
+      if (changed.empty()) {
+        header[0] = 0;
+      } else if (2 * changed.size() >= static_cast<std::size_t>(num_shared)) {
+        header[0] = -1;
+        shared_delta.assign(shared_params.data(),
+                            shared_params.data() + num_shared);
+      } else {
+        header[0] = changed.size();
+        for (int i : changed) {
+          shared_delta.push_back(i);
+          shared_delta.push_back(shared_params(i));
+        }
+      }
+
+      // the root evaluates its jobs with the new parameters directly
+      for (std::size_t r = 1, k = job_chunks[0]; r != world_size_; ++r) {
+        for (int j = 0; j != job_chunks[r]; ++j, ++k) {
+          if (job_params.col(k) != sent_job_params.col(k)) {
+            ++header[1 + r];
+            job_delta.push_back(j);
+            job_delta.insert(job_delta.end(), job_params.col(k).data(),
+                             job_params.col(k).data() + rows);
+          }
+        }
+      }
+
+      sent_shared_params = shared_params;
+      sent_job_params = job_params;
+    }
+
+    boost::mpi::broadcast(world_, header.data(), header.size(), 0);
+    count_broadcast<int>(header.size());
+
+    if (header[0] != 0) {
+      shared_delta.resize(header[0] == -1 ? num_shared : 2 * header[0]);
+      boost::mpi::broadcast(world_, shared_delta.data(), shared_delta.size(),
+                            0);
+      count_broadcast<double>(shared_delta.size());
+      if (rank_ != 0) {
+        if (header[0] == -1) {
+          sent_shared_params
+              = Eigen::Map<const vector_d>(shared_delta.data(), num_shared);
+        } else {
+          for (int i = 0; i < header[0]; ++i)
+            sent_shared_params(shared_delta[2 * i]) = shared_delta[2 * i + 1];
+        }
+      }
+    }
+
+    std::vector<int> delta_sizes(world_size_, 0);
+    for (std::size_t r = 1; r != world_size_; ++r)
+      delta_sizes[r] = header[1 + r] * (rows + 1);
+    if (sum(delta_sizes) == 0)
+      return;
+
+    std::vector<double> local_delta(delta_sizes[rank_]);
+    count_gather<double>(delta_sizes);
+    if (rank_ == 0) {
+      boost::mpi::scatterv(world_, job_delta.data(), delta_sizes,
+                           local_delta.data(), 0);
+    } else {
+      boost::mpi::scatterv(world_, local_delta.data(), delta_sizes[rank_], 0);
+      for (int i = 0, pos = 0; i < header[1 + rank_]; ++i, pos += rows + 1)
+        sent_job_params.col(local_delta[pos])
+            = Eigen::Map<const vector_d>(local_delta.data() + pos + 1, rows);
+    }
+  }
+
   void setup_call(const vector_d& shared_params, const matrix_d& job_params,
                   const std::vector<std::vector<double>>& x_r,
                   const std::vector<std::vector<int>>& x_i) {
-    std::vector<int> job_chunks = mpi_map_chunks(job_params.cols(), 1);
-    broadcast_array_1d_cached<cache_chunks>(job_chunks);
+    if (cache_chunks::is_valid()) {
+      rebalance_chunks();
+    } else {
+      const std::vector<int>& world_threads = gather_threads_cached();
+      std::vector<int> job_chunks
+          = mpi_map_chunks(job_params.cols(), world_threads, 1);
+      broadcast_array_1d_cached<cache_chunks>(job_chunks);
+    }
 
-    local_shared_params_dbl_ = broadcast_vector<-1>(shared_params);
-    local_job_params_dbl_ = scatter_matrix<-2>(job_params);
+    transfer_params(shared_params, job_params);
 
     // distribute const data if not yet cached
     scatter_array_2d_cached<cache_x_r>(x_r);
@@ -580,6 +1292,26 @@ class mpi_parallel_call {
 template <int call_id, typename ReduceF, typename CombineF>
 int mpi_parallel_call<call_id, ReduceF, CombineF>::num_outputs_per_job_ = -1;
 
+template <int call_id, typename ReduceF, typename CombineF>
+constexpr double
+    mpi_parallel_call<call_id, ReduceF, CombineF>::rebalance_threshold_;
+
+template <int call_id, typename ReduceF, typename CombineF>
+constexpr double
+    mpi_parallel_call<call_id, ReduceF, CombineF>::rebalance_min_saving_;
+
+template <int call_id, typename ReduceF, typename CombineF>
+constexpr int mpi_parallel_call<call_id, ReduceF, CombineF>::output_tag_;
+
+template <int call_id, typename ReduceF, typename CombineF>
+std::vector<
+    typename mpi_parallel_call<call_id, ReduceF, CombineF>::cached_result>
+    mpi_parallel_call<call_id, ReduceF, CombineF>::result_cache_;
+
+template <int call_id, typename ReduceF, typename CombineF>
+constexpr std::size_t
+    mpi_parallel_call<call_id, ReduceF, CombineF>::result_cache_size_;
+
 }  // namespace math
 }  // namespace stan
 
@@ -0,0 +1,188 @@
+#ifdef STAN_MPI
+
+#ifndef STAN_MATH_PRIM_FUNCTOR_MPI_PROFILE_HPP
+#define STAN_MATH_PRIM_FUNCTOR_MPI_PROFILE_HPP
+
+#include <stan/math/prim/functor/mpi_cluster.hpp>
+#include <stan/math/prim/functor/mpi_command.hpp>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Accumulated statistics of a single process for all profiled calls
+ * with a given call_id.
+ */
+struct mpi_rank_stats {
+  // number of profiled calls
+  std::size_t num_calls = 0;
+  // number of evaluated jobs
+  std::size_t num_jobs = 0;
+  // wall time spent evaluating the local jobs (seconds)
+  double compute_time = 0;
+  // wall time spent waiting for the results of the other processes
+  // once the local jobs are done (seconds)
+  double wait_time = 0;
+  // payload sent and received by the process (bytes)
+  double bytes = 0;
+};
+
+/**
+ * Instrumentation of the distributed calls of mpi_parallel_call. The
+ * profiling is off by default. Once enabled, every process measures
+ * the time spent on evaluating its jobs, the time spent waiting for
+ * the other processes and the payload it exchanges. These numbers
+ * are collected on the root with one small gather at the end of each
+ * call and accumulated per call_id and rank.
+ *
+ * The profiling must be switched on and off on the root only, which
+ * then instructs the workers accordingly. The statistics are only
+ * available on the root. They are updated while a call holds the
+ * cluster and must not be queried concurrently with running calls.
+ */
+class mpi_profile {
+ public:
+  mpi_profile() = delete;
+
+  /**
+   * Returns true if the profiling is enabled on this process.
+   */
+  static bool is_enabled() { return enabled(); }
+
+  /**
+   * Enables the profiling on the root and all workers.
+   */
+  static void enable();
+
+  /**
+   * Disables the profiling on the root and all workers. The
+   * statistics collected so far are kept.
+   */
+  static void disable();
+
+  /**
+   * Returns the statistics of all ranks for the given call_id, which
+   * are empty if no call with this call_id was profiled.
+   *
+   * @param call_id label of the distributed call
+   * @return statistics indexed by rank
+   */
+  static std::vector<mpi_rank_stats> stats(int call_id) {
+    auto elem = all_stats().find(call_id);
+    return elem == all_stats().end() ? std::vector<mpi_rank_stats>()
+                                     : elem->second;
+  }
+
+  /**
+   * Clears all statistics.
+   */
+  static void reset() { all_stats().clear(); }
+
+  /**
+   * Adds the measurements of one call to the statistics. The
+   * measurements are the number of jobs, the compute time, the wait
+   * time and the payload of each rank in turn.
+   *
+   * @param call_id label of the distributed call
+   * @param world_stats four measurements per rank
+   */
+  static void record(int call_id, const std::vector<double>& world_stats) {
+    std::vector<mpi_rank_stats>& call_stats = all_stats()[call_id];
+    const std::size_t world_size = world_stats.size() / 4;
+    call_stats.resize(world_size);
+    for (std::size_t r = 0; r != world_size; ++r) {
+      mpi_rank_stats& rank_stats = call_stats[r];
+      ++rank_stats.num_calls;
+      rank_stats.num_jobs += world_stats[4 * r];
+      rank_stats.compute_time += world_stats[4 * r + 1];
+      rank_stats.wait_time += world_stats[4 * r + 2];
+      rank_stats.bytes += world_stats[4 * r + 3];
+    }
+  }
+
+  /**
+   * Writes all statistics as comma separated values with a header
+   * line and one line per call_id and rank.
+   *
+   * @param out stream to write to
+   */
+  static void write_csv(std::ostream& out) {
+    out << "call_id,rank,calls,jobs,compute_time,wait_time,bytes\n";
+    for (const auto& call_stats : all_stats()) {
+      for (std::size_t r = 0; r != call_stats.second.size(); ++r) {
+        const mpi_rank_stats& rank_stats = call_stats.second[r];
+        out << call_stats.first << "," << r << "," << rank_stats.num_calls
+            << "," << rank_stats.num_jobs << "," << rank_stats.compute_time
+            << "," << rank_stats.wait_time << "," << rank_stats.bytes << "\n";
+      }
+    }
+  }
+
+  /**
+   * Returns the profiling flag of this process. Use enable and
+   * disable on the root to switch the profiling of the cluster.
+   */
+  static bool& enabled() {
+    static bool is_enabled = false;
+    return is_enabled;
+  }
+
+ private:
+  static std::map<int, std::vector<mpi_rank_stats>>& all_stats() {
+    static std::map<int, std::vector<mpi_rank_stats>> call_stats;
+    return call_stats;
+  }
+};
+
+/**
+ * MPI command used to switch the profiling on the workers on.
+ */
+struct mpi_enable_profile : public mpi_command {
+  friend class boost::serialization::access;
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(mpi_command);
+  }
+  void run() const { mpi_profile::enabled() = true; }
+};
+
+/**
+ * MPI command used to switch the profiling on the workers off.
+ */
+struct mpi_disable_profile : public mpi_command {
+  friend class boost::serialization::access;
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(mpi_command);
+  }
+  void run() const { mpi_profile::enabled() = false; }
+};
+
+inline void mpi_profile::enable() {
+  if (mpi_cluster::listening_status()) {
+    std::unique_lock<std::mutex> cluster_lock
+        = mpi_broadcast_command<mpi_enable_profile>();
+  }
+  enabled() = true;
+}
+
+inline void mpi_profile::disable() {
+  if (mpi_cluster::listening_status()) {
+    std::unique_lock<std::mutex> cluster_lock
+        = mpi_broadcast_command<mpi_disable_profile>();
+  }
+  enabled() = false;
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
+
+#endif
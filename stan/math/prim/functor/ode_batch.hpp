@@ -0,0 +1,147 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_ODE_BATCH_HPP
+#define STAN_MATH_PRIM_FUNCTOR_ODE_BATCH_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return type of a batch of ODE solutions, indexed by the system and
+ * then by the output time.
+ */
+template <typename T_y0, typename T_t0, typename T_ts, typename... T_Args>
+using ode_batch_return_t = std::vector<std::vector<
+    Eigen::Matrix<return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic,
+                  1>>>;
+
+/**
+ * Check that the initial states, the output times and the arguments
+ * of all systems of a batch have the same number of entries.
+ *
+ * @param function_name Calling function name
+ * @param y0 Initial state of each system
+ * @param ts Output times of each system
+ * @param args Arguments of each system
+ * @throw std::invalid_argument if the number of systems differs
+ */
+template <typename T_y0, typename T_ts, typename... T_Args>
+inline void check_ode_batch_sizes(const char* function_name,
+                                  const std::vector<T_y0>& y0,
+                                  const std::vector<T_ts>& ts,
+                                  const std::vector<T_Args>&... args) {
+  check_size_match(function_name, "number of initial states", y0.size(),
+                   "number of output times", ts.size());
+  static_cast<void>(std::initializer_list<int>{
+      (check_size_match(function_name, "number of initial states", y0.size(),
+                        "number of ode parameters and data", args.size()),
+       0)...});
+}
+
+/**
+ * Solve a batch of independent ODE systems without any vars.
+ *
+ * @tparam Solve Type of functor solving a single system
+ * @param solve Functor solving a single system given its initial
+ *   state, the initial time, its output times and its arguments
+ * @param y0 Initial state of each system
+ * @param t0 Initial time of all systems
+ * @param ts Output times of each system
+ * @param args Arguments of each system
+ * @return Solution of each system at its output times
+ */
+template <typename Solve, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+ode_batch_return_t<T_y0, T_t0, T_ts, T_Args...> ode_batch_impl(
+    std::false_type /* is_var */, const Solve& solve,
+    const std::vector<Eigen::Matrix<T_y0, Eigen::Dynamic, 1>>& y0,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& ts,
+    const std::vector<T_Args>&... args) {
+  const std::size_t num_systems = y0.size();
+  ode_batch_return_t<T_y0, T_t0, T_ts, T_Args...> ys(num_systems);
+
+  auto execute_chunk = [&](std::size_t start, std::size_t end) -> void {
+    for (std::size_t k = start; k != end; ++k) {
+      ys[k] = solve(y0[k], t0, ts[k], args[k]...);
+    }
+  };
+
+#ifdef STAN_THREADS
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_systems),
+                    [&](const tbb::blocked_range<std::size_t>& r) {
+                      execute_chunk(r.begin(), r.end());
+                    });
+#else
+  execute_chunk(0, num_systems);
+#endif
+
+  return ys;
+}
+
+/**
+ * Solve a batch of independent ODE systems with vars. Defined in
+ * rev.
+ */
+template <typename Solve, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+ode_batch_return_t<T_y0, T_t0, T_ts, T_Args...> ode_batch_impl(
+    std::true_type /* is_var */, const Solve& solve,
+    const std::vector<Eigen::Matrix<T_y0, Eigen::Dynamic, 1>>& y0,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& ts,
+    const std::vector<T_Args>&... args);
+
+/**
+ * Solve a batch of K independent ODE systems with a solver for a
+ * single system. Every system has its own initial state, output times
+ * and arguments, while the initial time is shared by all systems.
+ *
+ * Whenever STAN_THREADS is defined the systems are solved in parallel
+ * by the TBB worker threads, each system with an integrator of its
+ * own. For vars the solutions are recorded on separate AD tapes and
+ * the vector-Jacobian products of the reverse pass are computed on
+ * these tapes in parallel as well.
+ *
+ * @tparam Solve Type of functor solving a single system
+ * @param function_name Calling function name
+ * @param solve Functor solving a single system given its initial
+ *   state, the initial time, its output times and its arguments
+ * @param y0 Initial state of each system
+ * @param t0 Initial time of all systems
+ * @param ts Output times of each system
+ * @param args Arguments of each system
+ * @return Solution of each system at its output times
+ * @throw std::invalid_argument if the number of systems differs
+ *   between the arguments
+ */
+template <typename Solve, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+ode_batch_return_t<T_y0, T_t0, T_ts, T_Args...> ode_batch(
+    const char* function_name, const Solve& solve,
+    const std::vector<Eigen::Matrix<T_y0, Eigen::Dynamic, 1>>& y0,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& ts,
+    const std::vector<T_Args>&... args) {
+  check_ode_batch_sizes(function_name, y0, ts, args...);
+  if (y0.empty()) {
+    return {};
+  }
+  return ode_batch_impl(
+      is_var<return_type_t<T_y0, T_t0, T_ts, T_Args...>>(), solve, y0, t0, ts,
+      args...);
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+
+#endif
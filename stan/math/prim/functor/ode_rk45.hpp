@@ -3,6 +3,7 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/functor/coupled_ode_system.hpp>
+#include <stan/math/prim/functor/ode_stats.hpp>
 #include <stan/math/prim/functor/ode_store_sensitivities.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <boost/numeric/odeint.hpp>
@@ -46,6 +47,11 @@ namespace math {
  * @param absolute_tolerance Absolute tolerance passed to Boost
  * @param max_num_steps Upper limit on the number of integration steps to
  *   take between each output (error if exceeded)
+ * @param[out] stats If not null, the number of steps and of right hand
+ *   side evaluations are written to it. Boost does not report the steps
+ *   of a failed solve. The sensitivities are part of the coupled right
+ *   hand side such that no separate sensitivity evaluations are
+ *   reported.
  * @param[in, out] msgs the print stream for warning messages
  * @param args Extra arguments passed unmodified through to ODE right hand side
  * @return Solution to ODE at times \p ts
@@ -59,7 +65,7 @@ ode_rk45_tol_impl(const char* function_name, const F& f,
                   const std::vector<T_ts>& ts, double relative_tolerance,
                   double absolute_tolerance,
                   long int max_num_steps,  // NOLINT(runtime/int)
-                  std::ostream* msgs, const Args&... args) {
+                  ode_stats* stats, std::ostream* msgs, const Args&... args) {
   using boost::numeric::odeint::integrate_times;
   using boost::numeric::odeint::make_dense_output;
   using boost::numeric::odeint::max_step_checker;
@@ -122,24 +128,64 @@ ode_rk45_tol_impl(const char* function_name, const F& f,
   // the coupled system creates the coupled initial state
   std::vector<double> initial_coupled_state = coupled_system.initial_state();
 
+  long int num_rhs_evals = 0;  // NOLINT(runtime/int)
+  auto counted_system = [&](const std::vector<double>& coupled_state,
+                            std::vector<double>& dz_dt, double t) {
+    ++num_rhs_evals;
+    coupled_system(coupled_state, dz_dt, t);
+  };
+  auto write_stats = [&](size_t num_steps) {
+    if (stats != nullptr) {
+      *stats = ode_stats();
+      stats->num_steps = num_steps;
+      stats->num_rhs_evals = num_rhs_evals;
+    }
+  };
+
   const double step_size = 0.1;
+  size_t num_steps = 0;
   try {
-    integrate_times(
+    num_steps = integrate_times(
         make_dense_output(absolute_tolerance, relative_tolerance,
                           runge_kutta_dopri5<std::vector<double>, double,
                                              std::vector<double>, double>()),
-        std::ref(coupled_system), initial_coupled_state, std::begin(ts_vec),
+        counted_system, initial_coupled_state, std::begin(ts_vec),
         std::end(ts_vec), step_size, filtered_observer,
         max_step_checker(max_num_steps));
   } catch (const no_progress_error& e) {
+    write_stats(0);
     throw_domain_error(function_name, "", ts_vec[time_index + 1],
                        "Failed to integrate to next output time (",
                        ") in less than max_num_steps steps");
+  } catch (const std::exception& e) {
+    write_stats(0);
+    throw;
   }
+  write_stats(num_steps);
 
   return y;
 }
 
+/**
+ * Solve the ODE initial value problem without counters. See
+ * ode_rk45_tol_impl above.
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, Args...>,
+                          Eigen::Dynamic, 1>>
+ode_rk45_tol_impl(const char* function_name, const F& f,
+                  const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0_arg, T_t0 t0,
+                  const std::vector<T_ts>& ts, double relative_tolerance,
+                  double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  std::ostream* msgs, const Args&... args) {
+  return ode_rk45_tol_impl(function_name, f, y0_arg, t0, ts,
+                           relative_tolerance, absolute_tolerance,
+                           max_num_steps, static_cast<ode_stats*>(nullptr),
+                           msgs, args...);
+}
+
 /**
  * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
  * times, { t1, t2, t3, ... } using the non-stiff Runge-Kutta 45 solver in
@@ -190,6 +236,47 @@ ode_rk45_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0_arg,
                            max_num_steps, msgs, args...);
 }
 
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the non-stiff Runge-Kutta 45 solver in
+ * Boost and write the number of steps and of right hand side evaluations
+ * to \p stats. Boost does not report the steps of a failed solve. The
+ * evaluations of the coupled right hand side include the sensitivities,
+ * which are therefore not counted separately.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0_arg Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   greater than t0.
+ * @param relative_tolerance Relative tolerance passed to Boost
+ * @param absolute_tolerance Absolute tolerance passed to Boost
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[out] stats Counters of the solve
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, Args...>,
+                          Eigen::Dynamic, 1>>
+ode_rk45_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0_arg,
+             T_t0 t0, const std::vector<T_ts>& ts, double relative_tolerance,
+             double absolute_tolerance,
+             long int max_num_steps,  // NOLINT(runtime/int)
+             ode_stats& stats, std::ostream* msgs, const Args&... args) {
+  return ode_rk45_tol_impl("ode_rk45_tol", f, y0_arg, t0, ts,
+                           relative_tolerance, absolute_tolerance,
+                           max_num_steps, &stats, msgs, args...);
+}
+
 /**
  * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
  * times, { t1, t2, t3, ... } using the non-stiff Runge-Kutta 45 solver in Boost
@@ -0,0 +1,118 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_ODE_RK45_BATCH_HPP
+#define STAN_MATH_PRIM_FUNCTOR_ODE_RK45_BATCH_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/functor/ode_batch.hpp>
+#include <stan/math/prim/functor/ode_rk45.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Solve a batch of K independent ODE initial value problems
+ * y_k' = f(t, y_k), y_k(t0) = y0_k at the times ts_k using the non-stiff
+ * Runge-Kutta 45 solver in Boost.
+ *
+ * All systems share the right hand side \p f and the initial time, while
+ * the initial state, the output times and each pass-through argument are
+ * given per system. The k-th system is solved as
+ *   ode_rk45_tol(f, y0[k], t0, ts[k], ..., msgs, args[k]...)
+ * Whenever STAN_THREADS is defined the systems are solved in parallel.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * \p f must be safe to call concurrently from different threads.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial conditions
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state of each system
+ * @param t0 Initial time
+ * @param ts Times at which to solve each system. All values must be sorted
+ *   and greater than t0.
+ * @param relative_tolerance Relative tolerance passed to Boost
+ * @param absolute_tolerance Absolute tolerance passed to Boost
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments of each system passed unmodified through to
+ *   ODE right hand side
+ * @return Solution of each system at its times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<std::vector<Eigen::Matrix<
+    stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_rk45_tol_batch(
+    const F& f, const std::vector<Eigen::Matrix<T_y0, Eigen::Dynamic, 1>>& y0,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& ts,
+    double relative_tolerance, double absolute_tolerance,
+    long int max_num_steps,  // NOLINT(runtime/int)
+    std::ostream* msgs, const std::vector<T_Args>&... args) {
+  auto solve = [&](const auto& y0_k, const auto& t0_k, const auto& ts_k,
+                   const auto&... args_k) {
+    return ode_rk45_tol_impl("ode_rk45_tol_batch", f, y0_k, t0_k, ts_k,
+                             relative_tolerance, absolute_tolerance,
+                             max_num_steps, msgs, args_k...);
+  };
+  return internal::ode_batch("ode_rk45_tol_batch", solve, y0, t0, ts,
+                             args...);
+}
+
+/**
+ * Solve a batch of K independent ODE initial value problems
+ * y_k' = f(t, y_k), y_k(t0) = y0_k at the times ts_k using the non-stiff
+ * Runge-Kutta 45 solver in Boost with defaults for relative_tolerance,
+ * absolute_tolerance, and max_num_steps. See ode_rk45_tol_batch.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial conditions
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state of each system
+ * @param t0 Initial time
+ * @param ts Times at which to solve each system. All values must be sorted
+ *   and greater than t0.
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments of each system passed unmodified through to
+ *   ODE right hand side
+ * @return Solution of each system at its times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<std::vector<Eigen::Matrix<
+    stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_rk45_batch(const F& f,
+               const std::vector<Eigen::Matrix<T_y0, Eigen::Dynamic, 1>>& y0,
+               const T_t0& t0, const std::vector<std::vector<T_ts>>& ts,
+               std::ostream* msgs, const std::vector<T_Args>&... args) {
+  double relative_tolerance = 1e-6;
+  double absolute_tolerance = 1e-6;
+  long int max_num_steps = 1e6;  // NOLINT(runtime/int)
+
+  auto solve = [&](const auto& y0_k, const auto& t0_k, const auto& ts_k,
+                   const auto&... args_k) {
+    return ode_rk45_tol_impl("ode_rk45_batch", f, y0_k, t0_k, ts_k,
+                             relative_tolerance, absolute_tolerance,
+                             max_num_steps, msgs, args_k...);
+  };
+  return internal::ode_batch("ode_rk45_batch", solve, y0, t0, ts, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,76 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_ODE_STATS_HPP
+#define STAN_MATH_PRIM_FUNCTOR_ODE_STATS_HPP
+
+namespace stan {
+namespace math {
+
+/**
+ * Performance counters of an ODE or DAE solve. The solvers which are
+ * given an ode_stats overwrite it with the counters of the solve, also
+ * if the solve fails. Counters which do not apply to a solver are zero.
+ *
+ * A growing number of steps or of error test failures for some
+ * parameters is a sign of the ODE becoming stiff in that region.
+ */
+struct ode_stats {
+  /**
+   * Number of accepted integration steps
+   */
+  long int num_steps = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of evaluations of the ODE right hand side or the DAE
+   * residual
+   */
+  long int num_rhs_evals = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of evaluations of the Jacobian wrt to the states, including
+   * the ones handed to the preconditioner of Krylov solvers
+   */
+  long int num_jacobian_evals = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of setups of the linear solver of the Newton iterations
+   */
+  long int num_linear_solver_setups = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of steps which were rejected by the local error test
+   */
+  long int num_error_test_failures = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of iterations of the nonlinear solver
+   */
+  long int num_nonlinear_solver_iterations = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of convergence failures of the nonlinear solver
+   */
+  long int num_nonlinear_solver_convergence_failures  // NOLINT(runtime/int)
+      = 0;
+
+  /**
+   * Number of evaluations of the right hand side of the sensitivity
+   * equations by the SUNDIALS solvers. The Runge-Kutta solver evaluates
+   * the sensitivities as part of the coupled right hand side, which is
+   * counted by num_rhs_evals only.
+   */
+  long int num_sensitivity_rhs_evals = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Number of switches from the non-stiff to the stiff method of
+   * ode_auto
+   */
+  long int num_method_switches = 0;  // NOLINT(runtime/int)
+
+  /**
+   * Size of the last integration step
+   */
+  double last_step_size = 0;
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,258 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_REDUCE_SUM_AUTO_HPP
+#define STAN_MATH_PRIM_FUNCTOR_REDUCE_SUM_AUTO_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/functor/reduce_sum.hpp>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * Tuning state of the grainsize for calls to reduce_sum over a fixed
+ *   number of terms.
+ *
+ * The candidate grainsizes split the terms into 1, 2, 4, ..., 64 chunks
+ *   per available thread. Each candidate is timed for a few calls, after
+ *   which the candidate with the smallest observed run time is chosen and
+ *   used for all further calls.
+ */
+class grainsize_tuner {
+ public:
+  /**
+   * @param num_terms Number of terms in the sum
+   * @param concurrency Number of threads available to the TBB
+   * @param num_trials Number of timed calls per candidate grainsize
+   */
+  grainsize_tuner(std::size_t num_terms, int concurrency, int num_trials = 2)
+      : num_trials_(num_trials) {
+    const std::size_t num_threads = std::max(concurrency, 1);
+    for (std::size_t chunks = 1; chunks <= 64; chunks *= 2) {
+      const std::size_t num_chunks = num_threads * chunks;
+      const int grainsize = std::max<std::size_t>(
+          (num_terms + num_chunks - 1) / num_chunks, 1);
+      if (candidates_.empty() || candidates_.back() != grainsize) {
+        candidates_.push_back(grainsize);
+      }
+      if (grainsize == 1) {
+        break;
+      }
+    }
+    best_time_.resize(candidates_.size(),
+                      std::numeric_limits<double>::infinity());
+    num_runs_.resize(candidates_.size(), 0);
+  }
+
+  /**
+   * Return the grainsize to use for the next call.
+   */
+  int propose() const { return converged() ? chosen_ : candidates_[next_]; }
+
+  /**
+   * Record the run time of a call made with the given grainsize. Once
+   *   all candidates are timed often enough the fastest one is chosen.
+   *
+   * @param grainsize Grainsize used for the call
+   * @param elapsed Run time of the call in seconds
+   */
+  void record(int grainsize, double elapsed) {
+    if (converged()) {
+      return;
+    }
+    auto candidate
+        = std::find(candidates_.begin(), candidates_.end(), grainsize);
+    if (candidate == candidates_.end()) {
+      return;
+    }
+    const std::size_t i = candidate - candidates_.begin();
+    best_time_[i] = std::min(best_time_[i], elapsed);
+    ++num_runs_[i];
+    while (next_ < candidates_.size() && num_runs_[next_] >= num_trials_) {
+      ++next_;
+    }
+    if (next_ == candidates_.size()) {
+      const std::size_t best
+          = std::min_element(best_time_.begin(), best_time_.end())
+            - best_time_.begin();
+      chosen_ = candidates_[best];
+    }
+  }
+
+  /**
+   * Return true once a grainsize has been chosen.
+   */
+  bool converged() const { return chosen_ > 0; }
+
+  /**
+   * Return the chosen grainsize or 0 while the tuning is not finished.
+   */
+  int grainsize() const { return chosen_; }
+
+  /**
+   * Return the candidate grainsizes.
+   */
+  const std::vector<int>& candidates() const { return candidates_; }
+
+ private:
+  std::vector<int> candidates_;
+  std::vector<double> best_time_;
+  std::vector<int> num_runs_;
+  std::size_t next_{0};
+  int chosen_{0};
+  int num_trials_;
+};
+
+/**
+ * Grainsize tuners of all reduce_sum_auto call sites using the same
+ *   `ReduceFunction` and return type, keyed by the number of terms.
+ *
+ * @tparam ReduceFunction Type of reducer function
+ * @tparam ReturnType Return type of the sum
+ */
+template <typename ReduceFunction, typename ReturnType>
+struct reduce_sum_auto_registry {
+  static std::mutex& mutex() {
+    static std::mutex registry_mutex;
+    return registry_mutex;
+  }
+
+  static std::unordered_map<std::size_t, grainsize_tuner>& tuners() {
+    static std::unordered_map<std::size_t, grainsize_tuner> registry_tuners;
+    return registry_tuners;
+  }
+
+  /**
+   * Return the tuner for the given number of terms, creating it if needed.
+   * The registry mutex must be held by the caller.
+   */
+  static grainsize_tuner& tuner(std::size_t num_terms) {
+    auto& all_tuners = tuners();
+    auto elem = all_tuners.find(num_terms);
+    if (elem == all_tuners.end()) {
+      elem = all_tuners
+                 .emplace(num_terms,
+                          grainsize_tuner(
+                              num_terms,
+                              tbb::this_task_arena::max_concurrency()))
+                 .first;
+    }
+    return elem->second;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Call an instance of the function `ReduceFunction` on every element
+ *   of an input sequence and sum these terms, choosing the grainsize
+ *   automatically.
+ *
+ * This defers to reduce_sum_impl for the appropriate implementation
+ *
+ * ReduceFunction must define an operator() with the same signature as:
+ *   T f(Vec&& vmapped_subset, int start, int end, std::ostream* msgs, Args&&...
+ * args)
+ *
+ * `ReduceFunction` must be default constructible without any arguments
+ *
+ * The first calls for a given `ReduceFunction`, return type and number of
+ *   terms are timed with a sequence of candidate grainsizes. Afterwards the
+ *   fastest candidate is cached and used for all later calls. The chosen
+ *   grainsize can be queried with `reduce_sum_auto_grainsize`. The work is
+ *   partitioned as in `reduce_sum`.
+ *
+ * If STAN_THREADS is not defined, do all the work with one ReduceFunction call.
+ *
+ * @tparam ReduceFunction Type of reducer function
+ * @tparam Vec Type of sliced argument
+ * @tparam Args Types of shared arguments
+ * @param vmapped Sliced arguments used only in some sum terms
+ * @param[in, out] msgs The print stream for warning messages
+ * @param args Shared arguments used in every sum term
+ * @return Sum of terms
+ */
+template <typename ReduceFunction, typename Vec,
+          typename = require_vector_like_t<Vec>, typename... Args>
+auto reduce_sum_auto(Vec&& vmapped, std::ostream* msgs, Args&&... args) {
+  using return_type = return_type_t<Vec, Args...>;
+
+  if (vmapped.empty()) {
+    return return_type(0);
+  }
+
+#ifdef STAN_THREADS
+  using registry
+      = internal::reduce_sum_auto_registry<ReduceFunction, return_type>;
+  const std::size_t num_terms = vmapped.size();
+  int grainsize;
+  bool converged;
+  {
+    std::lock_guard<std::mutex> registry_lock(registry::mutex());
+    const internal::grainsize_tuner& tuner = registry::tuner(num_terms);
+    grainsize = tuner.propose();
+    converged = tuner.converged();
+  }
+
+  if (converged) {
+    return internal::reduce_sum_impl<ReduceFunction, void, return_type, Vec,
+                                     Args...>()(
+        std::forward<Vec>(vmapped), true, grainsize, msgs,
+        std::forward<Args>(args)...);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  return_type result
+      = internal::reduce_sum_impl<ReduceFunction, void, return_type, Vec,
+                                  Args...>()(std::forward<Vec>(vmapped), true,
+                                             grainsize, msgs,
+                                             std::forward<Args>(args)...);
+  const std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now() - start;
+
+  {
+    std::lock_guard<std::mutex> registry_lock(registry::mutex());
+    registry::tuner(num_terms).record(grainsize, elapsed.count());
+  }
+  return result;
+#else
+  return ReduceFunction()(std::forward<Vec>(vmapped), 0, vmapped.size() - 1,
+                          msgs, std::forward<Args>(args)...);
+#endif
+}
+
+/**
+ * Return the grainsize chosen by `reduce_sum_auto` for the given
+ *   `ReduceFunction`, return type and number of terms, or 0 if the
+ *   tuning has not finished yet (or no call has been made).
+ *
+ * @tparam ReduceFunction Type of reducer function
+ * @tparam ReturnType Return type of the sum
+ * @param num_terms Number of terms in the sum
+ * @return chosen grainsize or 0
+ */
+template <typename ReduceFunction, typename ReturnType = double>
+int reduce_sum_auto_grainsize(std::size_t num_terms) {
+  using registry
+      = internal::reduce_sum_auto_registry<ReduceFunction, ReturnType>;
+  std::lock_guard<std::mutex> registry_lock(registry::mutex());
+  const auto& all_tuners = registry::tuners();
+  auto elem = all_tuners.find(num_terms);
+  return elem == all_tuners.end() ? 0 : elem->second.grainsize();
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef STAN_MATH_REV_CORE_SCOPED_CHAINABLESTACK_HPP
+#define STAN_MATH_REV_CORE_SCOPED_CHAINABLESTACK_HPP
+
+#include <stan/math/rev/core/chainable_alloc.hpp>
+#include <stan/math/rev/core/chainablestack.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+namespace stan {
+namespace math {
+
+/**
+ * An explicit handle to an AD tape which is independent of the tape
+ * referenced by <code>ChainableStack::instance_</code>. Any number of
+ * these tapes may be held by a single thread and each can be made the
+ * active tape of the calling thread for the duration of a function
+ * call. This allows to interleave the construction and the reverse
+ * sweeps of independent gradients (for example of multiple chains or
+ * particles evaluated cooperatively) on one thread. Example:
+ *
+ * ScopedChainableStack tape_a;
+ * ScopedChainableStack tape_b;
+ *
+ * var lp_a = tape_a.execute([&] { return f(theta_a); });
+ * var lp_b = tape_b.execute([&] { return f(theta_b); });
+ * tape_a.execute([&] { lp_a.grad(); });
+ * tape_b.execute([&] { lp_b.grad(); });
+ *
+ * All vars created while a tape is active live on that tape and must
+ * only be used while that very tape is active again. The previously
+ * active tape is always restored, including when an exception is
+ * thrown. A tape can only be active once at a time, which rules out
+ * recursive activation and the concurrent use of the same tape from
+ * different threads.
+ *
+ * The memory of the tape is recovered with <code>recover_memory()</code>
+ * executed within the tape or when the handle is destructed.
+ */
+class ScopedChainableStack {
+ public:
+  using storage_t = ChainableStack::AutodiffStackStorage;
+
+  /**
+   * RAII guard which makes the referenced tape the active AD tape of
+   * the calling thread for its lifetime. On destruction the tape
+   * which was active before is restored.
+   */
+  class activation {
+   public:
+    explicit activation(ScopedChainableStack& scoped_stack)
+        : scoped_stack_(scoped_stack),
+          parent_stack_(ChainableStack::instance_) {
+      if (scoped_stack_.is_active_.exchange(true)) {
+        throw std::logic_error(
+            "ScopedChainableStack: the AD tape is already active.");
+      }
+      ChainableStack::instance_ = &scoped_stack_.local_stack_;
+    }
+
+    ~activation() {
+      ChainableStack::instance_ = parent_stack_;
+      scoped_stack_.is_active_ = false;
+    }
+
+    activation(const activation&) = delete;
+    activation& operator=(const activation&) = delete;
+    void* operator new(std::size_t) = delete;
+
+   private:
+    ScopedChainableStack& scoped_stack_;
+    storage_t* parent_stack_;
+  };
+
+  ScopedChainableStack() : local_stack_(), is_active_(false) {}
+
+  ~ScopedChainableStack() {
+    for (auto& alloc : local_stack_.var_alloc_stack_) {
+      delete alloc;
+    }
+  }
+
+  ScopedChainableStack(const ScopedChainableStack&) = delete;
+  ScopedChainableStack& operator=(const ScopedChainableStack&) = delete;
+
+  /**
+   * Call the functor with the given arguments while this tape is the
+   * active AD tape of the calling thread.
+   *
+   * @tparam F type of functor
+   * @tparam Args types of arguments
+   * @param f functor to execute
+   * @param args arguments forwarded to the functor
+   * @return the result of the functor call
+   * @throw std::logic_error if the tape is already active
+   */
+  template <typename F, typename... Args>
+  decltype(auto) execute(F&& f, Args&&... args) {
+    activation active_scope(*this);
+    return std::forward<F>(f)(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Return whether the tape is currently the active tape of a thread.
+   */
+  bool is_active() const { return is_active_; }
+
+  /**
+   * Return a pointer to the underlying AD tape storage.
+   */
+  storage_t* storage() { return &local_stack_; }
+
+ private:
+  storage_t local_stack_;
+  std::atomic<bool> is_active_;
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -77,6 +77,7 @@
 #include <stan/math/rev/fun/lbeta.hpp>
 #include <stan/math/rev/fun/ldexp.hpp>
 #include <stan/math/rev/fun/lgamma.hpp>
+#include <stan/math/rev/fun/linear_ode_sparse.hpp>
 #include <stan/math/rev/fun/lmgamma.hpp>
 #include <stan/math/rev/fun/log.hpp>
 #include <stan/math/rev/fun/log10.hpp>
@@ -0,0 +1,229 @@
+#ifndef STAN_MATH_REV_FUN_LINEAR_ODE_SPARSE_HPP
+#define STAN_MATH_REV_FUN_LINEAR_ODE_SPARSE_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/value_of.hpp>
+#include <stan/math/rev/fun/to_arena.hpp>
+#include <stan/math/rev/functor/arena_matrix.hpp>
+#include <stan/math/rev/functor/reverse_pass_callback.hpp>
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/krylov_exp_action_handler.hpp>
+#include <stan/math/prim/fun/linear_ode_sparse.hpp>
+#include <stan/math/prim/fun/matrix_exp.hpp>
+#include <stan/math/prim/fun/typedefs.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * Sparse matrix, output times and Krylov steps of the forward solution
+ * of linear_ode_sparse, which are needed in the reverse pass.
+ *
+ * The reverse pass solves the adjoint ODE d lambda/dt = -A^T lambda
+ * backwards in time, where lambda jumps by the adjoints of the
+ * solution at each output time, again with the Krylov method. Then
+ * the adjoint of y0 is lambda(0) and the adjoint of A is
+ *
+ * \f[
+ *   \int_0^{t_{max}} \lambda(s) y(s)^T ds,
+ * \f]
+ *
+ * of which only the entries in the sparsity pattern of A are needed.
+ * Within a forward and a backward step both y and lambda are given by
+ * the Krylov bases V and W of the steps, such that the integral over
+ * their overlap is W * M * V^T with a small matrix M. M follows from
+ * the exponential of a block triangular matrix (Van Loan, "Computing
+ * integrals involving the matrix exponential", IEEE Trans. Automat.
+ * Control 23(3), 1978).
+ */
+class linear_ode_sparse_solution : public chainable_alloc {
+  using step = krylov_exp_action_handler::step;
+
+  const Eigen::SparseMatrix<double> A_;
+  const std::vector<double> ts_;
+
+  /**
+   * Add the integral of lambda(s) * y(s)^T over the backward step b to
+   * the adjoints of the non-zero entries of A.
+   *
+   * @param[in] b step of the adjoint ODE, which starts at time c and
+   *   integrates backwards in time
+   * @param[in] c time at which the backward solve of b starts
+   * @param[in, out] A_adj adjoints of the non-zero entries of A
+   */
+  void add_A_adjoint(const step& b, double c, Eigen::VectorXd& A_adj) const {
+    if (b.V.cols() == 0) {
+      return;
+    }
+    const double lo = c - b.t0 - b.h;
+    const double hi = c - b.t0;
+    const Eigen::Index mb = b.H.rows();
+
+    auto f = std::upper_bound(
+        steps_.begin(), steps_.end(), lo,
+        [](double t, const step& s) { return t < s.t0 + s.h; });
+    for (; f != steps_.end() && f->t0 < hi; ++f) {
+      const double p = std::max(lo, f->t0);
+      const double q = std::min(hi, f->t0 + f->h);
+      if (f->V.cols() == 0 || q <= p) {
+        continue;
+      }
+      const Eigen::Index mf = f->H.rows();
+
+      // the upper right block of the exponential of B is the integral
+      // of exp((h - r) * H_b) * e_1 * e_1^T * exp(r * H_f^T) over [0, h]
+      Eigen::MatrixXd B = Eigen::MatrixXd::Zero(mb + mf, mb + mf);
+      B.topLeftCorner(mb, mb) = b.H;
+      B.coeffRef(0, mb) = 1;
+      B.bottomRightCorner(mf, mf) = f->H.transpose();
+      const Eigen::MatrixXd M
+          = matrix_exp((c - q - b.t0) * b.H)
+            * matrix_exp((q - p) * B).topRightCorner(mb, mf)
+            * matrix_exp((p - f->t0) * f->H).transpose();
+      const Eigen::MatrixXd WM = (b.beta * f->beta) * (b.V * M);
+
+      Eigen::Index k = 0;
+      for (Eigen::Index j = 0; j < A_.outerSize(); ++j) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(A_, j); it;
+             ++it, ++k) {
+          A_adj.coeffRef(k) += WM.row(it.row()).dot(f->V.row(it.col()));
+        }
+      }
+    }
+  }
+
+ public:
+  std::vector<step> steps_;
+
+  linear_ode_sparse_solution(const Eigen::SparseMatrix<double>& A,
+                             const std::vector<double>& ts)
+      : A_(A), ts_(ts) {}
+
+  /**
+   * Propagate the adjoints of the solutions at the output times to
+   * the non-zero entries of A and to the initial state.
+   *
+   * @param[in] function name of the calling function
+   * @param[in] ys_adj adjoints of the solutions as columns
+   * @param[in] need_A_adj whether the adjoints of A are needed
+   * @param[out] A_adj adjoints of the non-zero entries of A in storage
+   *   order, if needed
+   * @param[out] y0_adj adjoints of the initial state
+   */
+  void chain(const char* function, const Eigen::MatrixXd& ys_adj,
+             bool need_A_adj, Eigen::VectorXd& A_adj,
+             Eigen::VectorXd& y0_adj) const {
+    const Eigen::SparseMatrix<double> A_t = A_.transpose();
+    const double anorm_t = krylov_exp_action_handler::norm(A_t);
+    if (need_A_adj) {
+      A_adj = Eigen::VectorXd::Zero(A_.nonZeros());
+    }
+
+    Eigen::VectorXd lambda = Eigen::VectorXd::Zero(A_.rows());
+    std::vector<step> backward_steps;
+    for (size_t n = ts_.size(); n-- > 0;) {
+      lambda += ys_adj.col(n);
+      const double t_lo = n > 0 ? ts_[n - 1] : 0.0;
+      backward_steps.clear();
+      lambda = krylov_exp_action_handler::action(
+          function, A_t, anorm_t, lambda, ts_[n] - t_lo, backward_steps);
+      if (need_A_adj) {
+        for (const step& b : backward_steps) {
+          add_A_adjoint(b, ts_[n], A_adj);
+        }
+      }
+    }
+    y0_adj = lambda;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Return the solutions of the linear ODE dy/dt = A * y with initial
+ * state y0 at time 0 for the sparse matrix A, which are
+ * exp(t * A) * y0 for each output time t.
+ *
+ * The forward and the adjoint ODE are solved with the Krylov method
+ * of krylov_exp_action_handler. The gradients wrt to A are only
+ * formed for the non-zero entries of A and reuse the Krylov bases of
+ * the forward solve.
+ *
+ * @tparam Ta scalar type of the sparse matrix
+ * @tparam EigVec type of the initial state
+ * @param[in] A square sparse matrix
+ * @param[in] y0 initial state
+ * @param[in] ts output times, positive and sorted
+ * @return a vector of states, one for each output time
+ * @throw std::invalid_argument if A is not square or its size does not
+ *   match y0
+ * @throw std::domain_error if A or y0 are not finite or if ts are not
+ *   positive, finite and sorted
+ */
+template <typename Ta, typename EigVec,
+          require_eigen_col_vector_t<EigVec>* = nullptr,
+          require_any_var_t<Ta, value_type_t<EigVec>>* = nullptr>
+inline std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> linear_ode_sparse(
+    const Eigen::SparseMatrix<Ta>& A, const EigVec& y0,
+    const std::vector<double>& ts) {
+  static const char* function = "linear_ode_sparse";
+  Eigen::SparseMatrix<double> A_val
+      = A.unaryExpr([](const Ta& x) { return value_of(x); });
+  A_val.makeCompressed();
+  const Eigen::VectorXd y0_val = value_of(y0);
+  internal::check_linear_ode_sparse(function, A_val, y0_val, ts);
+
+  auto* solution = new internal::linear_ode_sparse_solution(A_val, ts);
+  arena_matrix<Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic>> ys
+      = internal::linear_ode_sparse_solve(function, A_val, y0_val, ts,
+                                          solution->steps_);
+  if (is_constant<Ta>::value) {
+    // the forward steps are only needed for the adjoints of A
+    solution->steps_.clear();
+  }
+
+  arena_t<Eigen::Matrix<Ta, Eigen::Dynamic, 1>> A_arena(
+      is_constant<Ta>::value ? 0 : A_val.nonZeros());
+  if (!is_constant<Ta>::value) {
+    Eigen::Index k = 0;
+    for (Eigen::Index j = 0; j < A.outerSize(); ++j) {
+      for (typename Eigen::SparseMatrix<Ta>::InnerIterator it(A, j); it;
+           ++it, ++k) {
+        A_arena.coeffRef(k) = it.value();
+      }
+    }
+  }
+  auto y0_arena = to_arena_if<!is_constant<EigVec>::value>(y0);
+
+  reverse_pass_callback([solution, ys, A_arena, y0_arena]() mutable {
+    Eigen::VectorXd A_adj;
+    Eigen::VectorXd y0_adj;
+    solution->chain(function, ys.adj(), !is_constant<Ta>::value, A_adj,
+                    y0_adj);
+    if (!is_constant<Ta>::value) {
+      forward_as<vector_v>(A_arena).adj() += A_adj;
+    }
+    if (!is_constant<EigVec>::value) {
+      forward_as<vector_v>(y0_arena).adj() += y0_adj;
+    }
+  });
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> res(ts.size());
+  for (size_t n = 0; n < ts.size(); ++n) {
+    res[n] = ys.col(n);
+  }
+  return res;
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
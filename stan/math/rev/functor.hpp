@@ -6,18 +6,28 @@
 #include <stan/math/rev/functor/algebra_solver_fp.hpp>
 #include <stan/math/rev/functor/algebra_solver_powell.hpp>
 #include <stan/math/rev/functor/algebra_solver_newton.hpp>
+#include <stan/math/rev/functor/algebra_solver_warm_start.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
 #include <stan/math/rev/functor/apply_scalar_unary.hpp>
 #include <stan/math/rev/functor/coupled_ode_system.hpp>
 #include <stan/math/rev/functor/cvodes_integrator.hpp>
+#include <stan/math/rev/functor/cvodes_integrator_adjoint.hpp>
+#include <stan/math/rev/functor/cvodes_linear_solver.hpp>
 #include <stan/math/rev/functor/cvodes_utils.hpp>
 #include <stan/math/rev/functor/gradient.hpp>
+#include <stan/math/rev/functor/gradient_batch.hpp>
 #include <stan/math/rev/functor/integrate_1d.hpp>
 #include <stan/math/rev/functor/integrate_dae.hpp>
+#include <stan/math/rev/functor/integrate_dae_adjoint.hpp>
 #include <stan/math/rev/functor/integrate_ode_adams.hpp>
 #include <stan/math/rev/functor/integrate_ode_bdf.hpp>
 #include <stan/math/rev/functor/ode_adams.hpp>
+#include <stan/math/rev/functor/ode_auto.hpp>
+#include <stan/math/rev/functor/ode_adams_batch.hpp>
+#include <stan/math/rev/functor/ode_batch.hpp>
 #include <stan/math/rev/functor/ode_bdf.hpp>
+#include <stan/math/rev/functor/ode_bdf_adjoint.hpp>
+#include <stan/math/rev/functor/ode_bdf_batch.hpp>
 #include <stan/math/rev/functor/ode_store_sensitivities.hpp>
 #include <stan/math/rev/functor/petsc_functor.hpp>
 #include <stan/math/rev/functor/jacobian.hpp>
@@ -27,6 +37,8 @@
 #include <stan/math/rev/functor/map_rect_reduce.hpp>
 #include <stan/math/rev/functor/operands_and_partials.hpp>
 #include <stan/math/rev/functor/reduce_sum.hpp>
+#include <stan/math/rev/functor/reduce_sum_mpi.hpp>
 #include <stan/math/rev/functor/reverse_pass_callback.hpp>
+#include <stan/math/rev/functor/sundials_workspace_cache.hpp>
 
 #endif
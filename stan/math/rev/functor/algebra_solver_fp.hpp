@@ -5,6 +5,7 @@
 #include <stan/math/rev/core.hpp>
 #include <stan/math/rev/fun/value_of.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
+#include <stan/math/rev/functor/algebra_solver_warm_start.hpp>
 #include <stan/math/rev/functor/kinsol_data.hpp>
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/mdivide_left.hpp>
@@ -317,6 +318,10 @@ struct FixedPointSolver<KinsolFixedPointEnv<F>, fp_jac_type> {
  * The user can also specify the scaling controls, the function
  * tolerance, and the maximum number of steps.
  *
+ * If algebra_solver_warm_start is enabled, the solve starts from the
+ * last solution of the same system and data and falls back to x on
+ * failure.
+ *
  * @tparam F type of equation system function.
  * @tparam T type of initial guess vector. The final solution
  *           type doesn't depend on initial guess type,
@@ -376,10 +381,15 @@ Eigen::Matrix<T2, -1, 1> algebra_solver_fp(
                        value_of(f(x, y, x_r, x_i, msgs)),
                        "the vector of unknowns, x,", x);
 
-  KinsolFixedPointEnv<F> env(f, x, y, x_r, x_i, msgs, u_scale,
-                             f_scale);  // NOLINT
-  FixedPointSolver<KinsolFixedPointEnv<F>, FixedPointADJac> fp;
-  return fp.solve(x, y, env, f_tol, max_num_steps);
+  // Start from the last solution if the warm start is enabled
+  return internal::warm_started_solve<KinsolFixedPointEnv<F>>(
+      value_of(x), value_of(y), x_r, x_i,
+      [&](const Eigen::VectorXd& x_start) {
+        KinsolFixedPointEnv<F> env(f, x_start, y, x_r, x_i, msgs, u_scale,
+                                   f_scale);  // NOLINT
+        FixedPointSolver<KinsolFixedPointEnv<F>, FixedPointADJac> fp;
+        return fp.solve(x_start, y, env, f_tol, max_num_steps);
+      });
 }
 
 }  // namespace math
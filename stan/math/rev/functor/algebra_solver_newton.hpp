@@ -3,6 +3,7 @@
 
 #include <stan/math/rev/core.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
+#include <stan/math/rev/functor/algebra_solver_warm_start.hpp>
 #include <stan/math/rev/functor/algebra_solver_powell.hpp>
 #include <stan/math/rev/functor/kinsol_solve.hpp>
 #include <stan/math/prim/err.hpp>
@@ -25,6 +26,10 @@ namespace math {
  * The user can also specify the scaled step size, the function
  * tolerance, and the maximum number of steps.
  *
+ * If algebra_solver_warm_start is enabled, the solve starts from the
+ * last solution of the same system and data and falls back to x on
+ * failure.
+ *
  * @tparam F type of equation system function.
  * @tparam T type of initial guess vector.
  *
@@ -68,8 +73,13 @@ Eigen::VectorXd algebra_solver_newton(
                        value_of(f(x, y, dat, dat_int, msgs)),
                        "the vector of unknowns, x,", x);
 
-  return kinsol_solve(f, value_of(x), y, dat, dat_int, 0, scaling_step_size,
-                      function_tolerance, max_num_steps);
+  // Start from the last solution if the warm start is enabled
+  using Fs = system_functor<F, double, double, true>;
+  return internal::warm_started_solve<Fs>(
+      value_of(x), y, dat, dat_int, [&](const Eigen::VectorXd& x_start) {
+        return kinsol_solve(f, x_start, y, dat, dat_int, 0, scaling_step_size,
+                            function_tolerance, max_num_steps);
+      });
 }
 
 /**
@@ -4,8 +4,9 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
+#include <stan/math/rev/functor/algebra_solver_warm_start.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/fun/mdivide_left.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
 #include <stan/math/prim/fun/value_of.hpp>
 #include <unsupported/Eigen/NonLinearOptimization>
 #include <iostream>
@@ -15,11 +16,42 @@
 namespace stan {
 namespace math {
 
+namespace internal {
+
 /**
- * The vari class for the algebraic solver. We compute the  Jacobian of
- * the solutions with respect to the parameters using the implicit
- * function theorem. The call to Jacobian() occurs outside the call to
- * chain() -- this prevents malloc issues.
+ * The algebraic system at the solution and the LU decomposition of
+ * its Jacobian w.r.t the unknowns, which the reverse pass of
+ * algebra_solver_vari needs. Their memory is released together with
+ * the memory of the AD tape.
+ *
+ * @tparam Fs type of the system functor with the parameters as
+ * independent variable
+ */
+template <typename Fs>
+struct algebra_solver_adjoint : public chainable_alloc {
+  /** algebraic system with the solution as unknowns */
+  const Fs fs_;
+  /** LU decomposition of the Jacobian w.r.t the unknowns */
+  const Eigen::PartialPivLU<Eigen::MatrixXd> Jf_x_lu_;
+
+  algebra_solver_adjoint(const Fs& fs, const Eigen::MatrixXd& Jf_x)
+      : fs_(fs), Jf_x_lu_(Jf_x) {}
+};
+
+}  // namespace internal
+
+/**
+ * The vari class for the algebraic solver. We compute the adjoints of
+ * the parameters using the implicit function theorem,
+ *
+ *   y_adj = -Jf_y^T * (Jf_x^T)^{-1} * theta_adj,
+ *
+ * where theta is the solution. The Jacobian w.r.t the unknowns is
+ * computed and factored once outside the call to chain(). The call to
+ * chain() needs a single solve with the transposed factorization and
+ * one reverse sweep of the algebraic system w.r.t the parameters, such
+ * that the Jacobian of the solution w.r.t the parameters is never
+ * formed.
  */
 template <typename Fs, typename F, typename T, typename Fx>
 struct algebra_solver_vari : public vari {
@@ -31,8 +63,8 @@ struct algebra_solver_vari : public vari {
   int x_size_;
   /** vector of solution */
   vari** theta_;
-  /** Jacobian of the solution w.r.t parameters */
-  double* Jx_y_;
+  /** algebraic system and factored Jacobian for the reverse pass */
+  internal::algebra_solver_adjoint<Fs>* adjoint_;
 
   algebra_solver_vari(const Fs& fs, const F& f, const Eigen::VectorXd& x,
                       const Eigen::Matrix<T, Eigen::Dynamic, 1>& y,
@@ -46,10 +78,9 @@ struct algebra_solver_vari : public vari {
         x_size_(x.size()),
         theta_(
             ChainableStack::instance_->memalloc_.alloc_array<vari*>(x_size_)),
-        Jx_y_(ChainableStack::instance_->memalloc_.alloc_array<double>(
-            x_size_ * y_size_)) {
-    using Eigen::Map;
-    using Eigen::MatrixXd;
+        adjoint_(new internal::algebra_solver_adjoint<Fs>(
+            Fs(f, theta_dbl, value_of(y), dat, dat_int, msgs),
+            fx.get_jacobian(theta_dbl))) {
     for (int i = 0; i < y.size(); ++i) {
       y_[i] = y(i).vi_;
     }
@@ -58,21 +89,28 @@ struct algebra_solver_vari : public vari {
     for (int i = 1; i < x.size(); ++i) {
       theta_[i] = new vari(theta_dbl(i), false);
     }
-
-    // Compute the Jacobian and store in array, using the
-    // implicit function theorem, i.e. Jx_y = Jf_y / Jf_x
-    using f_y = hybrj_functor_solver<Fs, F, double, double>;
-    Map<MatrixXd>(&Jx_y_[0], x_size_, y_size_)
-        = -mdivide_left(fx.get_jacobian(theta_dbl),
-                        f_y(fs, f, theta_dbl, value_of(y), dat, dat_int, msgs)
-                            .get_jacobian(value_of(y)));
   }
 
   void chain() {
-    for (int j = 0; j < y_size_; j++) {
-      for (int i = 0; i < x_size_; i++) {
-        y_[j]->adj_ += theta_[i]->adj_ * Jx_y_[j * x_size_ + i];
-      }
+    Eigen::VectorXd theta_adj(x_size_);
+    for (int i = 0; i < x_size_; ++i) {
+      theta_adj(i) = theta_[i]->adj_;
+    }
+    if (theta_adj.isZero(0.0)) {
+      return;
+    }
+    const Eigen::VectorXd eta
+        = adjoint_->Jf_x_lu_.transpose().solve(theta_adj);
+
+    nested_rev_autodiff nested;
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_nested(adjoint_->fs_.y_);
+    Eigen::Matrix<var, Eigen::Dynamic, 1> f_y = adjoint_->fs_(y_nested);
+    for (int i = 0; i < x_size_; ++i) {
+      f_y(i).vi_->adj_ = -eta(i);
+    }
+    grad();
+    for (int j = 0; j < y_size_; ++j) {
+      y_[j]->adj_ += y_nested(j).vi_->adj_;
     }
   }
 };
@@ -92,6 +130,10 @@ struct algebra_solver_vari : public vari {
  * is greater than the function tolerance. We here use the
  * norm as a metric to measure how far we are from the origin (0).
  *
+ * If algebra_solver_warm_start is enabled, the solve starts from the
+ * last solution of the same system and data and falls back to x on
+ * failure.
+ *
  * @tparam F type of equation system function.
  * @tparam T type of initial guess vector.
  *
@@ -140,39 +182,46 @@ Eigen::VectorXd algebra_solver_powell(
   using Fs = system_functor<F, double, double, true>;
   using Fx = hybrj_functor_solver<Fs, F, double, double>;
   Fx fx(Fs(), f, value_of(x), y, dat, dat_int, msgs);
-  Eigen::HybridNonLinearSolver<Fx> solver(fx);
 
   // Check dimension unknowns equals dimension of system output
   check_matching_sizes("algebra_solver", "the algebraic system's output",
                        fx.get_value(value_of(x)), "the vector of unknowns, x,",
                        x);
 
-  // Compute theta_dbl
-  Eigen::VectorXd theta_dbl = value_of(x);
-  solver.parameters.xtol = relative_tolerance;
-  solver.parameters.maxfev = max_num_steps;
-  solver.solve(theta_dbl);
+  auto solve = [&](const Eigen::VectorXd& x_start) {
+    Eigen::HybridNonLinearSolver<Fx> solver(fx);
 
-  // Check if the max number of steps has been exceeded
-  if (solver.nfev >= max_num_steps) {
-    throw_domain_error("algebra_solver", "maximum number of iterations",
-                       max_num_steps, "(", ") was exceeded in the solve.");
-  }
+    // Compute theta_dbl
+    Eigen::VectorXd theta_dbl = x_start;
+    solver.parameters.xtol = relative_tolerance;
+    solver.parameters.maxfev = max_num_steps;
+    solver.solve(theta_dbl);
 
-  // Check solution is a root
-  double system_norm = fx.get_value(theta_dbl).stableNorm();
-  if (system_norm > function_tolerance) {
-    std::ostringstream message;
-    message << "the norm of the algebraic function is " << system_norm
-            << " but should be lower than the function "
-            << "tolerance:";
-    throw_domain_error("algebra_solver", message.str().c_str(),
-                       function_tolerance, "",
-                       ". Consider decreasing the relative tolerance and "
-                       "increasing max_num_steps.");
-  }
+    // Check if the max number of steps has been exceeded
+    if (solver.nfev >= max_num_steps) {
+      throw_domain_error("algebra_solver", "maximum number of iterations",
+                         max_num_steps, "(", ") was exceeded in the solve.");
+    }
+
+    // Check solution is a root
+    double system_norm = fx.get_value(theta_dbl).stableNorm();
+    if (system_norm > function_tolerance) {
+      std::ostringstream message;
+      message << "the norm of the algebraic function is " << system_norm
+              << " but should be lower than the function "
+              << "tolerance:";
+      throw_domain_error("algebra_solver", message.str().c_str(),
+                         function_tolerance, "",
+                         ". Consider decreasing the relative tolerance and "
+                         "increasing max_num_steps.");
+    }
+
+    return theta_dbl;
+  };
 
-  return theta_dbl;
+  // Start from the last solution if the warm start is enabled
+  return internal::warm_started_solve<Fs>(value_of(x), y, dat, dat_int,
+                                          solve);
 }
 
 /**
@@ -0,0 +1,306 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ALGEBRA_SOLVER_WARM_START_HPP
+#define STAN_MATH_REV_FUNCTOR_ALGEBRA_SOLVER_WARM_START_HPP
+
+#include <stan/math/rev/fun/value_of.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Switches of the warm start of algebra_solver_newton,
+ * algebra_solver_powell and algebra_solver_fp, which is off by
+ * default.
+ *
+ * Consecutive solves of a sampler or an optimizer have nearby
+ * parameters and hence nearby solutions. With the warm start enabled,
+ * a solve starts from the last solution found for the same algebraic
+ * system, problem size and data instead of the initial guess of the
+ * caller. With extrapolation, the starting point is moved along the
+ * secant through the last two solutions by the projection of the
+ * parameter change onto the change of the last two parameters. Should the solve
+ * from the warm start fail, the solver starts over from the initial
+ * guess of the caller, such that the warm start never makes a solve
+ * fail that would succeed without it.
+ *
+ * Every thread keeps its own solutions, while the switches apply to
+ * all threads and should be set before solving.
+ */
+class algebra_solver_warm_start {
+ public:
+  /**
+   * Start solves from previous solutions.
+   *
+   * @param extrapolate whether to extrapolate from the last two
+   *   solutions
+   */
+  static void enable(bool extrapolate = false) {
+    extrapolate_flag() = extrapolate;
+    enabled_flag() = true;
+  }
+
+  /**
+   * Start solves from the initial guess of the caller again and forget
+   * all previous solutions.
+   */
+  static void disable() {
+    enabled_flag() = false;
+    clear();
+  }
+
+  /**
+   * Forget all previous solutions of all threads.
+   */
+  static void clear() { ++generation_count(); }
+
+  /**
+   * Return true if solves start from previous solutions.
+   */
+  static bool enabled() { return enabled_flag(); }
+
+  /**
+   * Return true if solves extrapolate from the last two solutions.
+   */
+  static bool extrapolate() { return extrapolate_flag(); }
+
+  /**
+   * Return the number of calls to clear(). Solutions stored before the
+   * last call are ignored.
+   */
+  static std::size_t generation() { return generation_count(); }
+
+ private:
+  static std::atomic<bool>& enabled_flag() {
+    static std::atomic<bool> enabled{false};
+    return enabled;
+  }
+
+  static std::atomic<bool>& extrapolate_flag() {
+    static std::atomic<bool> extrapolate{false};
+    return extrapolate;
+  }
+
+  static std::atomic<std::size_t>& generation_count() {
+    static std::atomic<std::size_t> generation{0};
+    return generation;
+  }
+};
+
+namespace internal {
+
+/**
+ * Last two solutions of an algebraic system for each problem size and
+ * data, which are the starting points of the warm start. Whenever
+ * STAN_THREADS is defined every thread has its own solutions.
+ *
+ * Stan generates a functor type for every user defined function, such
+ * that the type of the algebraic system identifies the call site. A
+ * system solved at one call site for several data sets, e.g. once per
+ * group, keeps the solutions of each data set apart, which are
+ * identified by a hash of the data (see data_key).
+ *
+ * @tparam Tag Type of the algebraic system, which distinguishes
+ *   root finding from fixed point problems of the same functor
+ */
+template <typename Tag>
+class algebra_solver_warm_start_cache {
+  struct entry {
+    Eigen::Index N;
+    Eigen::Index M;
+    std::size_t key;
+    std::size_t generation;
+    /** number of stored solutions, at most two */
+    int count;
+    /** parameters of the last and the second to last solution */
+    Eigen::VectorXd y[2];
+    /** last and second to last solution */
+    Eigen::VectorXd theta[2];
+  };
+
+  /**
+   * Maximum number of problem sizes and data sets kept per algebraic
+   * system.
+   */
+  static constexpr std::size_t max_entries = 4;
+
+  /**
+   * Maximum absolute step along the secant, in units of the distance
+   * between the last two solutions, which keeps the extrapolation
+   * local.
+   */
+  static constexpr double max_secant_step = 2.0;
+
+  static std::vector<entry>& entries() {
+#ifdef STAN_THREADS
+    static thread_local std::vector<entry> cache;
+#else
+    static std::vector<entry> cache;
+#endif
+    return cache;
+  }
+
+  static entry* find(Eigen::Index N, Eigen::Index M, std::size_t key) {
+    const std::size_t generation = algebra_solver_warm_start::generation();
+    std::vector<entry>& cache = entries();
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+      if (it->N == N && it->M == M && it->key == key) {
+        if (it->generation != generation) {
+          cache.erase(it);
+          return nullptr;
+        }
+        return &*it;
+      }
+    }
+    return nullptr;
+  }
+
+ public:
+  /**
+   * Return the hash of the data of a solve, which identifies the data
+   * set among the solutions of an algebraic system.
+   *
+   * @param[in] dat real data
+   * @param[in] dat_int integer data
+   * @return hash of the data
+   */
+  static std::size_t data_key(const std::vector<double>& dat,
+                              const std::vector<int>& dat_int) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, dat.size());
+    boost::hash_combine(seed, dat_int.size());
+    boost::hash_range(seed, dat.begin(), dat.end());
+    boost::hash_range(seed, dat_int.begin(), dat_int.end());
+    return seed;
+  }
+
+  /**
+   * Return the starting point of a solve with parameters y.
+   *
+   * @param[in] x initial guess of the caller
+   * @param[in] y parameters
+   * @param[in] key hash of the data of the solve
+   * @param[out] x0 starting point
+   * @return true if a previous solution is the starting point
+   */
+  static bool guess(const Eigen::VectorXd& x, const Eigen::VectorXd& y,
+                    std::size_t key, Eigen::VectorXd& x0) {
+    const entry* e = find(x.size(), y.size(), key);
+    if (e == nullptr || e->count == 0) {
+      return false;
+    }
+    x0 = e->theta[0];
+    if (e->count < 2 || !algebra_solver_warm_start::extrapolate()) {
+      return true;
+    }
+    const Eigen::VectorXd dy = e->y[0] - e->y[1];
+    const double dy_norm2 = dy.squaredNorm();
+    if (dy_norm2 > 0) {
+      const double step = std::min(
+          max_secant_step,
+          std::max(-max_secant_step, (y - e->y[0]).dot(dy) / dy_norm2));
+      const Eigen::VectorXd x_secant
+          = e->theta[0] + step * (e->theta[0] - e->theta[1]);
+      if (x_secant.allFinite()) {
+        x0 = x_secant;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Store the solution of a solve with parameters y.
+   *
+   * @param[in] y parameters
+   * @param[in] key hash of the data of the solve
+   * @param[in] theta solution
+   */
+  static void store(const Eigen::VectorXd& y, std::size_t key,
+                    const Eigen::VectorXd& theta) {
+    entry* e = find(theta.size(), y.size(), key);
+    if (e == nullptr) {
+      std::vector<entry>& cache = entries();
+      if (cache.size() >= max_entries) {
+        cache.erase(cache.begin());
+      }
+      cache.push_back(entry{theta.size(), y.size(), key,
+                            algebra_solver_warm_start::generation(), 0});
+      e = &cache.back();
+    }
+    // a repeated solve with the same parameters would spoil the secant
+    if (e->count == 0 || e->y[0] != y) {
+      e->y[1] = std::move(e->y[0]);
+      e->theta[1] = std::move(e->theta[0]);
+      e->count = std::min(e->count + 1, 2);
+    }
+    e->y[0] = y;
+    e->theta[0] = theta;
+  }
+
+  /**
+   * Return the number of problem sizes and data sets with stored
+   * solutions.
+   */
+  static std::size_t size() { return entries().size(); }
+};
+
+template <typename Tag>
+constexpr std::size_t algebra_solver_warm_start_cache<Tag>::max_entries;
+
+template <typename Tag>
+constexpr double algebra_solver_warm_start_cache<Tag>::max_secant_step;
+
+/**
+ * Solve an algebraic system from the warm start, if it is enabled, and
+ * from the initial guess of the caller if there is no previous
+ * solution or the solve from the warm start fails.
+ *
+ * @tparam Tag Type of the algebraic system
+ * @tparam Solve Type of the solve, which is called with the starting
+ *   point as an Eigen::VectorXd
+ * @param[in] x initial guess of the caller
+ * @param[in] y values of the parameters
+ * @param[in] dat real data
+ * @param[in] dat_int integer data
+ * @param[in] solve solve of the algebraic system
+ * @return solution
+ * @throw any exception of the solve from the initial guess of the
+ *   caller
+ */
+template <typename Tag, typename Solve>
+inline auto warm_started_solve(const Eigen::VectorXd& x,
+                               const Eigen::VectorXd& y,
+                               const std::vector<double>& dat,
+                               const std::vector<int>& dat_int,
+                               const Solve& solve) -> decltype(solve(x)) {
+  if (!algebra_solver_warm_start::enabled()) {
+    return solve(x);
+  }
+  using cache = algebra_solver_warm_start_cache<Tag>;
+  const std::size_t key = cache::data_key(dat, dat_int);
+  Eigen::VectorXd x0;
+  if (cache::guess(x, y, key, x0)) {
+    try {
+      auto theta = solve(x0);
+      cache::store(y, key, value_of(theta));
+      return theta;
+    } catch (const std::exception&) {
+      // start over from the initial guess of the caller
+    }
+  }
+  auto theta = solve(x);
+  cache::store(y, key, value_of(theta));
+  return theta;
+}
+
+}  // namespace internal
+
+}  // namespace math
+}  // namespace stan
+#endif
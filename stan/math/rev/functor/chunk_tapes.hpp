@@ -0,0 +1,159 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CHUNK_TAPES_HPP
+#define STAN_MATH_REV_FUNCTOR_CHUNK_TAPES_HPP
+
+#include <stan/math/rev/core.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/concurrent_vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * AD tapes of the chunks of a range of independent jobs.
+ *
+ * The jobs are recorded in chunks of consecutive jobs. Each chunk
+ * records the expression graphs of its jobs on an AD tape of its own,
+ * together with the local copies of their operands and their results.
+ * The chunk tapes are deleted together with the memory of the AD tape
+ * on which this object got created, such that a vari on that tape
+ * can sweep them during the reverse pass. Whenever STAN_THREADS is
+ * defined the chunks are recorded and swept by the TBB worker
+ * threads.
+ *
+ * @tparam Local Type of the local operands and results of a chunk
+ */
+template <typename Local>
+class chunk_tapes : public chainable_alloc {
+ public:
+  /**
+   * AD tape and local operands of a consecutive range of jobs.
+   */
+  struct chunk_tape {
+    ScopedChainableStack stack_;
+    const std::size_t start_;
+    const std::size_t end_;
+    Local local_;
+
+    chunk_tape(std::size_t start, std::size_t end)
+        : stack_(), start_(start), end_(end) {}
+  };
+
+  using chunk_tape_ptr = std::unique_ptr<chunk_tape>;
+
+  /**
+   * Record the jobs 0 to num_jobs - 1 on the chunk tapes.
+   *
+   * @tparam F Type of functor recording a chunk
+   * @param num_jobs Number of jobs
+   * @param f Functor called as f(local, start, end) on the tape of the
+   *   chunk holding the jobs start to end - 1
+   */
+  template <typename F>
+  void record(std::size_t num_jobs, F&& f) {
+    tbb::concurrent_vector<chunk_tape_ptr> tapes;
+
+    auto execute_chunk = [&](std::size_t start, std::size_t end) -> void {
+      chunk_tape_ptr tape = std::make_unique<chunk_tape>(start, end);
+      tape->stack_.execute([&] { f(tape->local_, start, end); });
+      tapes.push_back(std::move(tape));
+    };
+
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_jobs),
+                      [&](const tbb::blocked_range<std::size_t>& r) {
+                        execute_chunk(r.begin(), r.end());
+                      });
+#else
+    execute_chunk(0, num_jobs);
+#endif
+
+    tapes_.reserve(tapes.size());
+    for (auto& tape : tapes) {
+      tapes_.emplace_back(std::move(tape));
+    }
+    std::sort(tapes_.begin(), tapes_.end(),
+              [](const chunk_tape_ptr& a, const chunk_tape_ptr& b) {
+                return a->start_ < b->start_;
+              });
+  }
+
+  /**
+   * Run a reverse sweep on each chunk tape.
+   *
+   * @tparam Seed Type of functor seeding the adjoints of a chunk
+   * @tparam Collect Type of functor collecting the adjoints of a chunk
+   * @param seed Functor called as seed(tape) after the adjoints of the
+   *   tape are set to zero
+   * @param collect Functor called as collect(tape) after the sweep;
+   *   calls for different chunks may run concurrently
+   */
+  template <typename Seed, typename Collect>
+  void reverse_sweep(Seed&& seed, Collect&& collect) {
+    auto sweep = [&](chunk_tape& tape) -> void {
+      tape.stack_.execute([&] {
+        set_zero_all_adjoints();
+        seed(tape);
+        grad();
+        collect(tape);
+      });
+    };
+
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, tapes_.size()),
+                      [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t t = r.begin(); t != r.end(); ++t) {
+                          sweep(*tapes_[t]);
+                        }
+                      });
+#else
+    for (auto& tape : tapes_) {
+      sweep(*tape);
+    }
+#endif
+  }
+
+  /**
+   * Run a reverse sweep on each chunk tape.
+   *
+   * @tparam Seed Type of functor seeding the adjoints of a chunk
+   * @param seed Functor called as seed(tape) after the adjoints of the
+   *   tape are set to zero
+   */
+  template <typename Seed>
+  void reverse_sweep(Seed&& seed) {
+    reverse_sweep(seed, [](chunk_tape&) {});
+  }
+
+  /**
+   * Return the chunk tapes ordered by their first job.
+   */
+  const std::vector<chunk_tape_ptr>& tapes() const { return tapes_; }
+
+  /**
+   * Return the chunk tape holding the k-th job.
+   */
+  const chunk_tape& tape_of(std::size_t k) const {
+    auto tape = std::upper_bound(
+        tapes_.begin(), tapes_.end(), k,
+        [](std::size_t k, const chunk_tape_ptr& t) { return k < t->start_; });
+    --tape;
+    return **tape;
+  }
+
+ private:
+  std::vector<chunk_tape_ptr> tapes_;
+};
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -57,6 +57,12 @@ namespace math {
  * parameter vector part of the nochain autodiff tape and is therefore
  * set to zero separately.
  *
+ * <p>Note: Each evaluation of the coupled system performs N reverse
+ * sweeps of the nested autodiff to obtain the Jacobians J_y and
+ * J_theta of the base ODE RHS wrt to the states and the parameters.
+ * The sensitivities are then propagated as J_y * S + J_theta using a
+ * single dense matrix product.
+ *
  * @tparam F base ode system functor. Must provide
  *   <code>
  *     template<typename T_y, typename... T_args>
@@ -72,8 +78,8 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
   const size_t num_y0_vars_;
   const size_t num_args_vars;
   const size_t N_;
-  Eigen::VectorXd args_adjoints_;
-  Eigen::VectorXd y_adjoints_;
+  Eigen::MatrixXd jacobian_y_t_;
+  Eigen::MatrixXd jacobian_args_t_;
   std::ostream* msgs_;
 
   /**
@@ -95,8 +101,8 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
         num_y0_vars_(count_vars(y0_)),
         num_args_vars(count_vars(args...)),
         N_(y0.size()),
-        args_adjoints_(num_args_vars),
-        y_adjoints_(N_),
+        jacobian_y_t_(N_, N_),
+        jacobian_args_t_(num_args_vars, N_),
         msgs_(msgs) {}
 
   /**
@@ -131,19 +137,21 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
     check_size_match("coupled_ode_system", "dy_dt", f_y_t_vars.size(), "states",
                      N_);
 
+    // Each reverse sweep yields one row of the Jacobians of the base
+    // system wrt to the states and the parameters, which are stored as
+    // columns of their transposes.
     for (size_t i = 0; i < N_; ++i) {
       dz_dt[i] = f_y_t_vars.coeffRef(i).val();
       f_y_t_vars.coeffRef(i).grad();
 
-      y_adjoints_ = y_vars.adj();
+      jacobian_y_t_.col(i) = y_vars.adj();
 
+      double* args_adjoints = jacobian_args_t_.col(i).data();
       // memset was faster than Eigen setZero
-      memset(args_adjoints_.data(), 0, sizeof(double) * num_args_vars);
+      memset(args_adjoints, 0, sizeof(double) * num_args_vars);
 
       apply(
-          [&](auto&&... args) {
-            accumulate_adjoints(args_adjoints_.data(), args...);
-          },
+          [&](auto&&... args) { accumulate_adjoints(args_adjoints, args...); },
           local_args_tuple_);
 
       // The vars here do not live on the nested stack so must be zero'd
@@ -154,30 +162,20 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
       if (i + 1 < N_) {
         nested.set_zero_all_adjoints();
       }
+    }
 
-      // Compute the right hand side for the sensitivities with respect to the
-      // initial conditions
-      for (size_t j = 0; j < num_y0_vars_; ++j) {
-        double temp_deriv = 0.0;
-        for (size_t k = 0; k < N_; ++k) {
-          temp_deriv += z[N_ + N_ * j + k] * y_adjoints_.coeffRef(k);
-        }
-
-        dz_dt[N_ + N_ * j + i] = temp_deriv;
-      }
-
-      // Compute the right hand size for the sensitivities with respect to the
-      // parameters
-      for (size_t j = 0; j < num_args_vars; ++j) {
-        double temp_deriv = args_adjoints_.coeffRef(j);
-        for (size_t k = 0; k < N_; ++k) {
-          temp_deriv += z[N_ + N_ * num_y0_vars_ + N_ * j + k]
-                        * y_adjoints_.coeffRef(k);
-        }
-
-        dz_dt[N_ + N_ * num_y0_vars_ + N_ * j + i] = temp_deriv;
-      }
+    // The sensitivities are stored column major as a N x (N0 + M) matrix
+    // S, where N0 is the number of initial conditions which are vars.
+    // Their right hand side is J_y * S + [0, J_theta], which is
+    // computed as a single matrix product.
+    const size_t num_sens = num_y0_vars_ + num_args_vars;
+    if (num_sens == 0) {
+      return;
     }
+    Eigen::Map<const Eigen::MatrixXd> S(z.data() + N_, N_, num_sens);
+    Eigen::Map<Eigen::MatrixXd> dS_dt(dz_dt.data() + N_, N_, num_sens);
+    dS_dt.noalias() = jacobian_y_t_.transpose() * S;
+    dS_dt.rightCols(num_args_vars) += jacobian_args_t_.transpose();
   }
 
   /**
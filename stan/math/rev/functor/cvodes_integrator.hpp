@@ -4,23 +4,155 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/cvodes_utils.hpp>
 #include <stan/math/rev/functor/coupled_ode_system.hpp>
+#include <stan/math/rev/functor/cvodes_linear_solver.hpp>
 #include <stan/math/rev/functor/ode_store_sensitivities.hpp>
+#include <stan/math/rev/functor/sundials_workspace_cache.hpp>
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/value_of.hpp>
 #include <cvodes/cvodes.h>
 #include <nvector/nvector_serial.h>
+#include <sunlinsol/sunlinsol_band.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spbcgs.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 #include <algorithm>
 #include <ostream>
+#include <tuple>
 #include <vector>
 
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * CVODES memory together with the state vectors and the linear solver
+ * used by a cvodes_integrator. The workspace is created and
+ * initialized by the first solve and only re-initialized by later
+ * solves with the same number of states, number of sensitivities and
+ * linear solver.
+ */
+struct cvodes_workspace {
+  using key_type = std::tuple<size_t, size_t, int, int, int, int, bool>;
+
+  const key_type key_;
+  std::vector<double> coupled_state_;
+  N_Vector nv_state_;
+  N_Vector* nv_state_sens_;
+  SUNMatrix A_;
+  SUNLinearSolver LS_;
+  void* cvodes_mem_;
+  const size_t num_sens_;
+  bool is_initialized_;
+  /**
+   * The workspace is the user data of the CVODES memory, since CVODES
+   * keeps copies of the user data pointer. This points to the
+   * integrator which currently uses the workspace.
+   */
+  void* integrator_;
+
+  /**
+   * Return the key of a workspace.
+   *
+   * @param N Number of states
+   * @param num_sens Number of sensitivities
+   * @param linear_solver Linear solver used by the Newton iterations
+   */
+  static key_type make_key(size_t N, size_t num_sens,
+                           const cvodes_linear_solver& linear_solver) {
+    return key_type(N, num_sens, static_cast<int>(linear_solver.type()),
+                    linear_solver.lower_bandwidth(),
+                    linear_solver.upper_bandwidth(),
+                    linear_solver.max_krylov_dim(),
+                    linear_solver.has_preconditioner());
+  }
+
+  /**
+   * Allocate the CVODES memory, the state vectors and the linear
+   * solver. The CVODES memory is not initialized yet.
+   *
+   * @param lmm ID of ODE solver (1: ADAMS, 2: BDF)
+   * @param N Number of states
+   * @param num_sens Number of sensitivities
+   * @param linear_solver Linear solver used by the Newton iterations
+   */
+  cvodes_workspace(int lmm, size_t N, size_t num_sens,
+                   const cvodes_linear_solver& linear_solver)
+      : key_(make_key(N, num_sens, linear_solver)),
+        coupled_state_(N * (num_sens + 1), 0.0),
+        nv_state_(N_VMake_Serial(N, coupled_state_.data())),
+        nv_state_sens_(nullptr),
+        A_(nullptr),
+        LS_(nullptr),
+        cvodes_mem_(CVodeCreate(lmm)),
+        num_sens_(num_sens),
+        is_initialized_(false),
+        integrator_(nullptr) {
+    if (cvodes_mem_ == nullptr) {
+      N_VDestroy_Serial(nv_state_);
+      throw std::runtime_error("CVodeCreate failed to allocate memory");
+    }
+
+    const int pretype
+        = linear_solver.has_preconditioner() ? PREC_LEFT : PREC_NONE;
+    switch (linear_solver.type()) {
+      case cvodes_linear_solver::solver_type::band:
+        A_ = SUNBandMatrix(N, linear_solver.upper_bandwidth(),
+                           linear_solver.lower_bandwidth());
+        LS_ = SUNLinSol_Band(nv_state_, A_);
+        break;
+      case cvodes_linear_solver::solver_type::spgmr:
+        LS_ = SUNLinSol_SPGMR(nv_state_, pretype,
+                              linear_solver.max_krylov_dim());
+        break;
+      case cvodes_linear_solver::solver_type::spbcgs:
+        LS_ = SUNLinSol_SPBCGS(nv_state_, pretype,
+                               linear_solver.max_krylov_dim());
+        break;
+      default:
+        A_ = SUNDenseMatrix(N, N);
+        LS_ = SUNDenseLinearSolver(nv_state_, A_);
+    }
+
+    if (num_sens_ > 0) {
+      nv_state_sens_ = N_VCloneVectorArrayEmpty_Serial(num_sens_, nv_state_);
+      for (std::size_t i = 0; i < num_sens_; i++) {
+        NV_DATA_S(nv_state_sens_[i]) = &coupled_state_[N] + i * N;
+      }
+    }
+  }
+
+  cvodes_workspace(const cvodes_workspace&) = delete;
+  cvodes_workspace& operator=(const cvodes_workspace&) = delete;
+
+  ~cvodes_workspace() {
+    CVodeFree(&cvodes_mem_);
+    SUNLinSolFree(LS_);
+    if (A_ != nullptr) {
+      SUNMatDestroy(A_);
+    }
+    N_VDestroy_Serial(nv_state_);
+    if (num_sens_ > 0) {
+      N_VDestroyVectorArray_Serial(nv_state_sens_, num_sens_);
+    }
+  }
+
+  const key_type& key() const { return key_; }
+};
+
+}  // namespace internal
+
 /**
  * Integrator interface for CVODES' ODE solvers (Adams & BDF
  * methods).
  *
+ * The CVODES memory, state vectors and linear solver are taken from a
+ * sundials_workspace_cache such that repeated solves of the same ODE
+ * only re-initialize CVODES instead of allocating it again.
+ *
  * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
  * @tparam F Type of ODE right hand side
  * @tparam T_y0 Type of scalars for initial state
@@ -47,24 +179,36 @@ class cvodes_integrator {
   double relative_tolerance_;
   double absolute_tolerance_;
   long int max_num_steps_;  // NOLINT(runtime/int)
+  const cvodes_linear_solver linear_solver_;
 
   const size_t num_y0_vars_;
   const size_t num_args_vars_;
 
   coupled_ode_system<F, T_y0_t0, T_Args...> coupled_ode_;
 
-  std::vector<double> coupled_state_;
-  N_Vector nv_state_;
-  N_Vector* nv_state_sens_;
-  SUNMatrix A_;
-  SUNLinearSolver LS_;
+  Eigen::MatrixXd Jprec_;
+  Eigen::MatrixXd jacobian_y_;
+  Eigen::MatrixXd jacobian_args_t_;
+
+  using workspace_cache
+      = sundials_workspace_cache<internal::cvodes_workspace,
+                                 cvodes_integrator>;
+
+  /**
+   * Return the integrator which uses the workspace that CVODES passes
+   * as user data to the callbacks.
+   */
+  static cvodes_integrator* integrator_of(void* user_data) {
+    return static_cast<cvodes_integrator*>(
+        static_cast<internal::cvodes_workspace*>(user_data)->integrator_);
+  }
 
   /**
    * Implements the function of type CVRhsFn which is the user-defined
    * ODE RHS passed to CVODES.
    */
   static int cv_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data) {
-    cvodes_integrator* integrator = static_cast<cvodes_integrator*>(user_data);
+    cvodes_integrator* integrator = integrator_of(user_data);
     integrator->rhs(t, NV_DATA_S(y), NV_DATA_S(ydot));
     return 0;
   }
@@ -76,7 +220,7 @@ class cvodes_integrator {
   static int cv_rhs_sens(int Ns, realtype t, N_Vector y, N_Vector ydot,
                          N_Vector* yS, N_Vector* ySdot, void* user_data,
                          N_Vector tmp1, N_Vector tmp2) {
-    cvodes_integrator* integrator = static_cast<cvodes_integrator*>(user_data);
+    cvodes_integrator* integrator = integrator_of(user_data);
     integrator->rhs_sens(t, NV_DATA_S(y), yS, ySdot);
     return 0;
   }
@@ -90,11 +234,54 @@ class cvodes_integrator {
   static int cv_jacobian_states(realtype t, N_Vector y, N_Vector fy,
                                 SUNMatrix J, void* user_data, N_Vector tmp1,
                                 N_Vector tmp2, N_Vector tmp3) {
-    cvodes_integrator* integrator = static_cast<cvodes_integrator*>(user_data);
+    cvodes_integrator* integrator = integrator_of(user_data);
     integrator->jacobian_states(t, NV_DATA_S(y), J);
     return 0;
   }
 
+  /**
+   * Implements the function of type CVLsPrecSetupFn which forwards to
+   * the preconditioner setup of the linear solver. The jacobian handed
+   * to the setup is only recomputed whenever CVODES does not allow
+   * (jok false) to reuse the jacobian of an earlier setup, which is
+   * reported back to CVODES by jcurPtr.
+   */
+  static int cv_preconditioner_setup(realtype t, N_Vector y, N_Vector fy,
+                                     booleantype jok, booleantype* jcurPtr,
+                                     realtype gamma, void* user_data) {
+    cvodes_integrator* integrator = integrator_of(user_data);
+    if (jok && integrator->Jprec_.size() != 0) {
+      *jcurPtr = SUNFALSE;
+    } else {
+      integrator->jacobian_states_dense(t, NV_DATA_S(y), integrator->Jprec_);
+      *jcurPtr = SUNTRUE;
+    }
+    const auto& setup = integrator->linear_solver_.preconditioner_setup();
+    if (setup) {
+      setup(t, Eigen::Map<const Eigen::VectorXd>(NV_DATA_S(y), integrator->N_),
+            integrator->Jprec_, gamma);
+    }
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVLsPrecSolveFn which forwards to
+   * the preconditioner solve of the linear solver.
+   */
+  static int cv_preconditioner_solve(realtype t, N_Vector y, N_Vector fy,
+                                     N_Vector r, N_Vector z, realtype gamma,
+                                     realtype delta, int lr, void* user_data) {
+    cvodes_integrator* integrator = integrator_of(user_data);
+    const size_t N = integrator->N_;
+    Eigen::VectorXd z_vec = integrator->linear_solver_.preconditioner_solve()(
+        t, Eigen::Map<const Eigen::VectorXd>(NV_DATA_S(y), N),
+        Eigen::Map<const Eigen::VectorXd>(NV_DATA_S(r), N), gamma);
+    check_size_match("cvodes_integrator", "preconditioner solution",
+                     z_vec.size(), "states", N);
+    std::copy(z_vec.data(), z_vec.data() + N, NV_DATA_S(z));
+    return 0;
+  }
+
   /**
    * Calculates the ODE RHS, dy_dt, using the user-supplied functor at
    * the given time t and state y.
@@ -117,43 +304,170 @@ class cvodes_integrator {
    * given time-point t and state y.
    */
   inline void jacobian_states(double t, const double y[], SUNMatrix J) const {
-    Eigen::VectorXd fy;
+    if (linear_solver_.type() == cvodes_linear_solver::solver_type::band) {
+      jacobian_states_band(t, y, J);
+      return;
+    }
+
     Eigen::MatrixXd Jfy;
+    jacobian_states_dense(t, y, Jfy);
+
+    for (size_t j = 0; j < Jfy.cols(); ++j) {
+      for (size_t i = 0; i < Jfy.rows(); ++i) {
+        SM_ELEMENT_D(J, i, j) = Jfy(i, j);
+      }
+    }
+  }
+
+  /**
+   * Calculates the banded jacobian of the ODE RHS wrt to its states y
+   * at the given time-point t and state y.
+   *
+   * The rows are grouped such that the rows within a group are
+   * lower_bandwidth + upper_bandwidth + 1 apart. Within the band, every
+   * column then has at most one entry per group, such that a single
+   * reverse sweep per group yields all entries of its rows.
+   */
+  inline void jacobian_states_band(double t, const double y[],
+                                   SUNMatrix J) const {
+    const int N = N_;
+    const int ml = linear_solver_.lower_bandwidth();
+    const int mu = linear_solver_.upper_bandwidth();
+    const int num_groups = std::min(ml + mu + 1, N);
+
+    nested_rev_autodiff nested;
+
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_vars
+        = Eigen::Map<const Eigen::VectorXd>(y, N);
+    Eigen::Matrix<var, Eigen::Dynamic, 1> fy_vars
+        = apply([&](auto&&... args) { return f_(t, y_vars, msgs_, args...); },
+                value_of_args_tuple_);
+
+    check_size_match("cvodes_integrator", "dy_dt", fy_vars.size(), "states",
+                     N_);
+
+    for (int group = 0; group < num_groups; ++group) {
+      if (group > 0) {
+        nested.set_zero_all_adjoints();
+      }
+      for (int i = group; i < N; i += ml + mu + 1) {
+        fy_vars.coeffRef(i).vi_->adj_ += 1.0;
+      }
+      grad();
+      for (int j = 0; j < N; ++j) {
+        // first row of the group which may have an entry in column j
+        const int first_row = std::max(j - mu, 0);
+        const int i = first_row
+                      + ((group - first_row) % (ml + mu + 1) + ml + mu + 1)
+                            % (ml + mu + 1);
+        if (i < N && i <= j + ml) {
+          SM_ELEMENT_B(J, i, j) = y_vars.coeff(j).adj();
+        }
+      }
+    }
+  }
+
+  /**
+   * Calculates the dense jacobian J of the ODE RHS wrt to its states y
+   * at the given time-point t and state y.
+   */
+  inline void jacobian_states_dense(double t, const double y[],
+                                    Eigen::MatrixXd& J) const {
+    Eigen::VectorXd fy;
 
     auto f_wrapped = [&](const Eigen::Matrix<var, Eigen::Dynamic, 1>& y) {
       return apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
                    value_of_args_tuple_);
     };
 
-    jacobian(f_wrapped, Eigen::Map<const Eigen::VectorXd>(y, N_), fy, Jfy);
+    jacobian(f_wrapped, Eigen::Map<const Eigen::VectorXd>(y, N_), fy, J);
+  }
 
-    for (size_t j = 0; j < Jfy.cols(); ++j) {
-      for (size_t i = 0; i < Jfy.rows(); ++i) {
-        SM_ELEMENT_D(J, i, j) = Jfy(i, j);
+  /**
+   * Calculates the rows [begin, end) of the jacobians of the ODE RHS
+   * wrt to the states y and wrt to the parameters at the given
+   * time-point t and state y. The parameters are copied onto the nested
+   * tape, such that blocks of rows can be computed concurrently.
+   */
+  inline void sensitivity_jacobians(double t, const double y[], size_t begin,
+                                    size_t end) {
+    nested_rev_autodiff nested;
+
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_vars
+        = Eigen::Map<const Eigen::VectorXd>(y, N_);
+    std::tuple<decltype(deep_copy_vars(std::declval<const T_Args&>()))...>
+        local_args_tuple = apply(
+            [](auto&&... args) {
+              return std::tuple<decltype(
+                  deep_copy_vars(std::declval<const T_Args&>()))...>(
+                  deep_copy_vars(args)...);
+            },
+            args_tuple_);
+    Eigen::Matrix<var, Eigen::Dynamic, 1> f_y_t_vars
+        = apply([&](auto&&... args) { return f_(t, y_vars, msgs_, args...); },
+                local_args_tuple);
+
+    check_size_match("cvodes_integrator", "dy_dt", f_y_t_vars.size(),
+                     "states", N_);
+
+    for (size_t i = begin; i < end; ++i) {
+      if (i > begin) {
+        nested.set_zero_all_adjoints();
       }
+      grad(f_y_t_vars.coeffRef(i).vi_);
+      jacobian_y_.row(i) = y_vars.adj();
+      double* args_adjoints = jacobian_args_t_.col(i).data();
+      memset(args_adjoints, 0, sizeof(double) * num_args_vars_);
+      apply(
+          [&](auto&&... args) { accumulate_adjoints(args_adjoints, args...); },
+          local_args_tuple);
     }
   }
 
   /**
-   * Calculates the RHS of the sensitivity ODE system which
-   * corresponds to the coupled ode system from which the first N
-   * states are omitted, since the first N states are the ODE RHS
-   * which CVODES separates from the main ODE RHS.
+   * Calculates the RHS of the sensitivity ODE system
+   *
+   *   dS/dt = J_y * S + [0, J_args],
+   *
+   * where the columns of S are the N_Vectors of CVODES, without copying
+   * them into a coupled state. The sensitivities of different
+   * parameters are independent given the jacobians J_y and J_args.
+   *
+   * Whenever STAN_THREADS is defined, the reverse sweeps for the rows of
+   * the jacobians are split over the TBB worker threads, each of which
+   * evaluates the ODE RHS on its own nested tape, and the sensitivities
+   * are then split over the threads by parameter. The ODE RHS must
+   * therefore be safe to call concurrently from different threads.
    */
   inline void rhs_sens(double t, const double y[], N_Vector* yS,
                        N_Vector* ySdot) {
-    std::vector<double> z(coupled_state_.size());
-    std::vector<double> dz_dt;
-    std::copy(y, y + N_, z.data());
-    for (std::size_t s = 0; s < num_y0_vars_ + num_args_vars_; s++) {
-      std::copy(NV_DATA_S(yS[s]), NV_DATA_S(yS[s]) + N_,
-                z.data() + (s + 1) * N_);
-    }
-    coupled_ode_(z, dz_dt, t);
-    for (std::size_t s = 0; s < num_y0_vars_ + num_args_vars_; s++) {
-      std::move(dz_dt.data() + (s + 1) * N_, dz_dt.data() + (s + 2) * N_,
-                NV_DATA_S(ySdot[s]));
-    }
+    const size_t num_sens = num_y0_vars_ + num_args_vars_;
+    auto sens_rhs = [&](size_t begin, size_t end) {
+      for (size_t s = begin; s < end; ++s) {
+        Eigen::Map<Eigen::VectorXd> dS_dt(NV_DATA_S(ySdot[s]), N_);
+        dS_dt.noalias()
+            = jacobian_y_
+              * Eigen::Map<const Eigen::VectorXd>(NV_DATA_S(yS[s]), N_);
+        if (s >= num_y0_vars_) {
+          dS_dt += jacobian_args_t_.row(s - num_y0_vars_).transpose();
+        }
+      }
+    };
+
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, N_),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        sensitivity_jacobians(t, y, r.begin(), r.end());
+                      });
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_sens),
+        [&](const tbb::blocked_range<size_t>& r) {
+          sens_rhs(r.begin(), r.end());
+        });
+#else
+    sensitivity_jacobians(t, y, 0, N_);
+    sens_rhs(0, num_sens);
+#endif
   }
 
  public:
@@ -171,6 +485,7 @@ class cvodes_integrator {
    * @param absolute_tolerance Absolute tolerance passed to CVODES
    * @param max_num_steps Upper limit on the number of integration steps to
    *   take between each output (error if exceeded)
+   * @param linear_solver Linear solver used by the Newton iterations
    * @param[in, out] msgs the print stream for warning messages
    * @param args Extra arguments passed unmodified through to ODE right hand
    * side function
@@ -188,6 +503,7 @@ class cvodes_integrator {
                     const T_t0& t0, const std::vector<T_ts>& ts,
                     double relative_tolerance, double absolute_tolerance,
                     long int max_num_steps,  // NOLINT(runtime/int)
+                    const cvodes_linear_solver& linear_solver,
                     std::ostream* msgs, const T_Args&... args)
       : function_name_(function_name),
         f_(f),
@@ -201,10 +517,12 @@ class cvodes_integrator {
         relative_tolerance_(relative_tolerance),
         absolute_tolerance_(absolute_tolerance),
         max_num_steps_(max_num_steps),
+        linear_solver_(linear_solver),
         num_y0_vars_(count_vars(y0_)),
         num_args_vars_(count_vars(args...)),
         coupled_ode_(f, y0_, msgs, args...),
-        coupled_state_(coupled_ode_.initial_state()) {
+        jacobian_y_(N_, N_),
+        jacobian_args_t_(num_args_vars_, N_) {
     check_finite(function_name, "initial state", y0_);
     check_finite(function_name, "initial time", t0_);
     check_finite(function_name, "times", ts_);
@@ -228,29 +546,6 @@ class cvodes_integrator {
     check_positive_finite(function_name, "absolute_tolerance",
                           absolute_tolerance_);
     check_positive(function_name, "max_num_steps", max_num_steps_);
-
-    nv_state_ = N_VMake_Serial(N_, &coupled_state_[0]);
-    nv_state_sens_ = nullptr;
-    A_ = SUNDenseMatrix(N_, N_);
-    LS_ = SUNDenseLinearSolver(nv_state_, A_);
-
-    if (num_y0_vars_ + num_args_vars_ > 0) {
-      nv_state_sens_ = N_VCloneVectorArrayEmpty_Serial(
-          num_y0_vars_ + num_args_vars_, nv_state_);
-      for (std::size_t i = 0; i < num_y0_vars_ + num_args_vars_; i++) {
-        NV_DATA_S(nv_state_sens_[i]) = &coupled_state_[N_] + i * N_;
-      }
-    }
-  }
-
-  ~cvodes_integrator() {
-    SUNLinSolFree(LS_);
-    SUNMatDestroy(A_);
-    N_VDestroy_Serial(nv_state_);
-    if (num_y0_vars_ + num_args_vars_ > 0) {
-      N_VDestroyVectorArray_Serial(nv_state_sens_,
-                                   num_y0_vars_ + num_args_vars_);
-    }
   }
 
   /**
@@ -258,42 +553,97 @@ class cvodes_integrator {
    * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
    * (BDF) solver in CVODES.
    *
+   * @param[out] stats If not null, the counters of the solve are written
+   *   to it, also if the solve fails
    * @return std::vector of Eigen::Matrix of the states of the ODE, one for each
    *   solution time (excluding the initial state)
    */
-  std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> operator()() {
-    std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> y;
-
-    void* cvodes_mem = CVodeCreate(Lmm);
-    if (cvodes_mem == nullptr) {
-      throw std::runtime_error("CVodeCreate failed to allocate memory");
-    }
+  std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> operator()(
+      ode_stats* stats = nullptr) {
+    return (*this)(value_of(t0_), coupled_ode_.initial_state(), stats);
+  }
 
-    try {
+  /**
+   * Continue the solution of the ODE from the state of the coupled ODE
+   * system at the time t_start, which is how another integrator hands
+   * over a partially solved problem. The coupled state holds the states
+   * followed by their sensitivities wrt to the initial state and the
+   * parameters, such that the returned sensitivities are wrt to y0, t0
+   * and args as if CVODES had solved the ODE from t0.
+   *
+   * @param t_start Time of the coupled state, which must be less than
+   *   the first output time
+   * @param initial_coupled_state State of the coupled ODE system at
+   *   t_start
+   * @param[out] stats If not null, the counters of the solve are written
+   *   to it, also if the solve fails
+   * @return std::vector of Eigen::Matrix of the states of the ODE, one for each
+   *   solution time
+   */
+  std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> operator()(
+      double t_start, const std::vector<double>& initial_coupled_state,
+      ode_stats* stats) {
+    std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> y;
+    const size_t num_sens = num_y0_vars_ + num_args_vars_;
+
+    check_less(function_name_, "initial time", t_start, ts_[0]);
+    check_size_match(function_name_, "coupled state",
+                     initial_coupled_state.size(), "expected size",
+                     N_ * (num_sens + 1));
+
+    // the workspace is freed instead of cached if the solve throws
+    typename workspace_cache::workspace_ptr workspace
+        = workspace_cache::acquire(
+            internal::cvodes_workspace::make_key(N_, num_sens, linear_solver_),
+            Lmm, N_, num_sens, linear_solver_);
+    std::vector<double>& coupled_state = workspace->coupled_state_;
+    std::copy(initial_coupled_state.begin(), initial_coupled_state.end(),
+              coupled_state.begin());
+    void* cvodes_mem = workspace->cvodes_mem_;
+    N_Vector nv_state = workspace->nv_state_;
+    N_Vector* nv_state_sens = workspace->nv_state_sens_;
+
+    if (workspace->is_initialized_) {
+      check_flag_sundials(CVodeReInit(cvodes_mem, t_start, nv_state),
+                          "CVodeReInit");
+      if (num_sens > 0) {
+        check_flag_sundials(
+            CVodeSensReInit(cvodes_mem, CV_STAGGERED, nv_state_sens),
+            "CVodeSensReInit");
+      }
+    } else {
       check_flag_sundials(CVodeInit(cvodes_mem, &cvodes_integrator::cv_rhs,
-                                    value_of(t0_), nv_state_),
+                                    t_start, nv_state),
                           "CVodeInit");
 
-      // Assign pointer to this as user data
       check_flag_sundials(
-          CVodeSetUserData(cvodes_mem, reinterpret_cast<void*>(this)),
+          CVodeSetUserData(cvodes_mem, static_cast<void*>(workspace.get())),
           "CVodeSetUserData");
 
-      cvodes_set_options(cvodes_mem, relative_tolerance_, absolute_tolerance_,
-                         max_num_steps_);
-
-      check_flag_sundials(CVodeSetLinearSolver(cvodes_mem, LS_, A_),
-                          "CVodeSetLinearSolver");
       check_flag_sundials(
-          CVodeSetJacFn(cvodes_mem, &cvodes_integrator::cv_jacobian_states),
-          "CVodeSetJacFn");
+          CVodeSetLinearSolver(cvodes_mem, workspace->LS_, workspace->A_),
+          "CVodeSetLinearSolver");
+      // the Krylov solvers use the difference quotient approximation
+      // of CVODES for the products of the jacobian with vectors
+      if (linear_solver_.is_krylov()) {
+        if (linear_solver_.has_preconditioner()) {
+          check_flag_sundials(
+              CVodeSetPreconditioner(
+                  cvodes_mem, &cvodes_integrator::cv_preconditioner_setup,
+                  &cvodes_integrator::cv_preconditioner_solve),
+              "CVodeSetPreconditioner");
+        }
+      } else {
+        check_flag_sundials(
+            CVodeSetJacFn(cvodes_mem, &cvodes_integrator::cv_jacobian_states),
+            "CVodeSetJacFn");
+      }
 
       // initialize forward sensitivity system of CVODES as needed
-      if (num_y0_vars_ + num_args_vars_ > 0) {
+      if (num_sens > 0) {
         check_flag_sundials(
-            CVodeSensInit(
-                cvodes_mem, static_cast<int>(num_y0_vars_ + num_args_vars_),
-                CV_STAGGERED, &cvodes_integrator::cv_rhs_sens, nv_state_sens_),
+            CVodeSensInit(cvodes_mem, static_cast<int>(num_sens), CV_STAGGERED,
+                          &cvodes_integrator::cv_rhs_sens, nv_state_sens),
             "CVodeSensInit");
 
         check_flag_sundials(CVodeSetSensErrCon(cvodes_mem, SUNTRUE),
@@ -302,14 +652,21 @@ class cvodes_integrator {
         check_flag_sundials(CVodeSensEEtolerances(cvodes_mem),
                             "CVodeSensEEtolerances");
       }
+      workspace->is_initialized_ = true;
+    }
 
-      double t_init = value_of(t0_);
+    workspace->integrator_ = this;
+    cvodes_set_options(cvodes_mem, relative_tolerance_, absolute_tolerance_,
+                       max_num_steps_);
+
+    try {
+      double t_init = t_start;
       for (size_t n = 0; n < ts_.size(); ++n) {
         double t_final = value_of(ts_[n]);
 
         if (t_final != t_init) {
           int error_code
-              = CVode(cvodes_mem, t_final, nv_state_, &t_init, CV_NORMAL);
+              = CVode(cvodes_mem, t_final, nv_state, &t_init, CV_NORMAL);
 
           if (error_code == CV_TOO_MUCH_WORK) {
             throw_domain_error(function_name_, "", t_final,
@@ -319,16 +676,16 @@ class cvodes_integrator {
             check_flag_sundials(error_code, "CVode");
           }
 
-          if (num_y0_vars_ + num_args_vars_ > 0) {
+          if (num_sens > 0) {
             check_flag_sundials(
-                CVodeGetSens(cvodes_mem, &t_init, nv_state_sens_),
+                CVodeGetSens(cvodes_mem, &t_init, nv_state_sens),
                 "CVodeGetSens");
           }
         }
 
         y.emplace_back(apply(
             [&](auto&&... args) {
-              return ode_store_sensitivities(f_, coupled_state_, y0_, t0_,
+              return ode_store_sensitivities(f_, coupled_state, y0_, t0_,
                                              ts_[n], msgs_, args...);
             },
             args_tuple_));
@@ -336,11 +693,21 @@ class cvodes_integrator {
         t_init = t_final;
       }
     } catch (const std::exception& e) {
-      CVodeFree(&cvodes_mem);
+      if (stats != nullptr) {
+        try {
+          cvodes_get_stats(cvodes_mem, num_sens > 0, *stats);
+        } catch (const std::exception&) {
+          // the error of the solve is reported instead
+        }
+      }
       throw;
     }
 
-    CVodeFree(&cvodes_mem);
+    if (stats != nullptr) {
+      cvodes_get_stats(cvodes_mem, num_sens > 0, *stats);
+    }
+
+    workspace_cache::release(std::move(workspace));
 
     return y;
   }
@@ -0,0 +1,612 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CVODES_INTEGRATOR_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_CVODES_INTEGRATOR_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/cvodes_utils.hpp>
+#include <stan/math/rev/functor/jacobian.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <stan/math/prim/functor/apply.hpp>
+#include <cvodes/cvodes.h>
+#include <nvector/nvector_serial.h>
+#include <sunlinsol/sunlinsol_dense.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Integrator interface for CVODES' ODE solvers (Adams & BDF methods)
+ * using the adjoint method to propagate the gradients.
+ *
+ * <p>The forward pass integrates the base ODE only and stores
+ * checkpoints of the solution every num_steps_between_checkpoints
+ * steps. The reverse pass integrates the adjoint ODE
+ *
+ * \f[
+ *   \frac{d \lambda}{dt} = - J_y^T \lambda
+ * \f]
+ *
+ * backwards in time from the last to the first output time, adding the
+ * adjoints of the solution at each output time along the way, and
+ * integrates the quadrature
+ *
+ * \f[
+ *   \frac{d \mu}{dt} = - J_{\theta}^T \lambda
+ * \f]
+ *
+ * for the adjoints of the parameters. The forward solution needed in
+ * between the checkpoints is recomputed by CVODES. Each evaluation of
+ * the adjoint ODE or the quadrature is a single reverse sweep of the
+ * ODE right hand side, such that the cost of the gradient is about
+ * two solves of the base ODE regardless of the number of parameters.
+ *
+ * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of scalars for initial state
+ * @tparam T_t0 Type of scalar of initial time point
+ * @tparam T_ts Type of time-points where ODE solution is returned
+ * @tparam T_Args Types of pass-through parameters
+ */
+template <int Lmm, typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+class cvodes_integrator_adjoint_vari : public vari_base {
+  /**
+   * CVODES memory and the state of the forward and backward problems
+   * which are needed during the reverse pass. The memory is freed
+   * together with the memory of the AD tape.
+   */
+  struct cvodes_solver : public chainable_alloc {
+    const std::string function_name_;
+    const F f_;
+    std::ostream* msgs_;
+    const size_t N_;
+    const size_t num_args_vars_;
+    const double relative_tolerance_;
+    const double absolute_tolerance_;
+    const long int max_num_steps_;  // NOLINT(runtime/int)
+    std::tuple<
+        plain_type_t<decltype(value_of(std::declval<const T_Args&>()))>...>
+        value_of_args_tuple_;
+    std::tuple<decltype(deep_copy_vars(std::declval<const T_Args&>()))...>
+        local_args_tuple_;
+    std::vector<Eigen::VectorXd> y_;
+    Eigen::VectorXd state_forward_;
+    Eigen::VectorXd state_backward_;
+    Eigen::VectorXd quad_;
+    N_Vector nv_state_forward_;
+    N_Vector nv_state_backward_;
+    N_Vector nv_quad_;
+    SUNMatrix A_forward_;
+    SUNMatrix A_backward_;
+    SUNLinearSolver LS_forward_;
+    SUNLinearSolver LS_backward_;
+    void* cvodes_mem_;
+    int index_backward_;
+    bool backward_is_initialized_;
+
+    cvodes_solver(const char* function_name, const F& f, std::ostream* msgs,
+                  const Eigen::VectorXd& y0, double relative_tolerance,
+                  double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  const T_Args&... args)
+        : function_name_(function_name),
+          f_(f),
+          msgs_(msgs),
+          N_(y0.size()),
+          num_args_vars_(count_vars(args...)),
+          relative_tolerance_(relative_tolerance),
+          absolute_tolerance_(absolute_tolerance),
+          max_num_steps_(max_num_steps),
+          value_of_args_tuple_(value_of(args)...),
+          local_args_tuple_(deep_copy_vars(args)...),
+          state_forward_(y0),
+          state_backward_(Eigen::VectorXd::Zero(N_)),
+          quad_(Eigen::VectorXd::Zero(num_args_vars_)),
+          nv_state_forward_(N_VMake_Serial(N_, state_forward_.data())),
+          nv_state_backward_(N_VMake_Serial(N_, state_backward_.data())),
+          nv_quad_(num_args_vars_ > 0
+                       ? N_VMake_Serial(num_args_vars_, quad_.data())
+                       : nullptr),
+          A_forward_(SUNDenseMatrix(N_, N_)),
+          A_backward_(SUNDenseMatrix(N_, N_)),
+          LS_forward_(SUNDenseLinearSolver(nv_state_forward_, A_forward_)),
+          LS_backward_(SUNDenseLinearSolver(nv_state_backward_, A_backward_)),
+          cvodes_mem_(CVodeCreate(Lmm)),
+          index_backward_(0),
+          backward_is_initialized_(false) {
+      if (cvodes_mem_ == nullptr) {
+        throw std::runtime_error("CVodeCreate failed to allocate memory");
+      }
+    }
+
+    virtual ~cvodes_solver() {
+      SUNLinSolFree(LS_forward_);
+      SUNLinSolFree(LS_backward_);
+      SUNMatDestroy(A_forward_);
+      SUNMatDestroy(A_backward_);
+      N_VDestroy_Serial(nv_state_forward_);
+      N_VDestroy_Serial(nv_state_backward_);
+      if (nv_quad_ != nullptr) {
+        N_VDestroy_Serial(nv_quad_);
+      }
+      CVodeFree(&cvodes_mem_);
+    }
+
+    /**
+     * Calculates the ODE RHS, dy_dt, using the user-supplied functor at
+     * the given time t and state y.
+     */
+    Eigen::VectorXd rhs(double t, const Eigen::VectorXd& y) const {
+      Eigen::VectorXd dy_dt
+          = apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
+                  value_of_args_tuple_);
+      check_size_match(function_name_.c_str(), "dy_dt", dy_dt.size(),
+                       "states", N_);
+      return dy_dt;
+    }
+
+    /**
+     * Calculates the jacobian of the ODE RHS wrt to its states y at the
+     * given time-point t and state y.
+     */
+    Eigen::MatrixXd jacobian_states(double t, const double y[]) const {
+      Eigen::VectorXd fy;
+      Eigen::MatrixXd Jfy;
+
+      auto f_wrapped = [&](const Eigen::Matrix<var, Eigen::Dynamic, 1>& y) {
+        return apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
+                     value_of_args_tuple_);
+      };
+
+      jacobian(f_wrapped, Eigen::Map<const Eigen::VectorXd>(y, N_), fy, Jfy);
+      return Jfy;
+    }
+
+    /**
+     * Calculates the vector-Jacobian products of the ODE RHS with the
+     * backward state at the given time-point t and state y using a
+     * single reverse sweep. The product wrt to the states is stored
+     * in y_adj and the product wrt to the parameters in args_adj.
+     */
+    void rhs_adj(double t, const double y[], const double yB[], double y_adj[],
+                 double args_adj[]) {
+      nested_rev_autodiff nested;
+
+      Eigen::Matrix<var, Eigen::Dynamic, 1> y_vars
+          = Eigen::Map<const Eigen::VectorXd>(y, N_);
+
+      Eigen::Matrix<var, Eigen::Dynamic, 1> f_y_t_vars = apply(
+          [&](auto&&... args) { return f_(t, y_vars, msgs_, args...); },
+          local_args_tuple_);
+
+      check_size_match(function_name_.c_str(), "dy_dt", f_y_t_vars.size(),
+                       "states", N_);
+
+      for (size_t i = 0; i < N_; ++i) {
+        f_y_t_vars.coeffRef(i).vi_->adj_ += yB[i];
+      }
+      grad();
+
+      if (y_adj != nullptr) {
+        for (size_t i = 0; i < N_; ++i) {
+          y_adj[i] = y_vars.coeffRef(i).adj();
+        }
+      }
+      if (args_adj != nullptr) {
+        // memset was faster than Eigen setZero
+        memset(args_adj, 0, sizeof(double) * num_args_vars_);
+        apply([&](auto&&... args) { accumulate_adjoints(args_adj, args...); },
+              local_args_tuple_);
+      }
+
+      // The vars here do not live on the nested stack so must be zero'd
+      // separately
+      apply([&](auto&&... args) { zero_adjoints(args...); }, local_args_tuple_);
+    }
+
+    /**
+     * Integrates the backward problem from t_init to t_final starting
+     * at the current backward state and quadrature.
+     */
+    void solve_backward(double t_init, double t_final) {
+      if (!backward_is_initialized_) {
+        check_flag_sundials(CVodeCreateB(cvodes_mem_, Lmm, &index_backward_),
+                            "CVodeCreateB");
+        check_flag_sundials(
+            CVodeInitB(cvodes_mem_, index_backward_,
+                       &cvodes_integrator_adjoint_vari::cv_rhs_adj, t_init,
+                       nv_state_backward_),
+            "CVodeInitB");
+        check_flag_sundials(
+            CVodeSStolerancesB(cvodes_mem_, index_backward_,
+                               relative_tolerance_, absolute_tolerance_),
+            "CVodeSStolerancesB");
+        check_flag_sundials(
+            CVodeSetUserDataB(cvodes_mem_, index_backward_,
+                              reinterpret_cast<void*>(this)),
+            "CVodeSetUserDataB");
+        check_flag_sundials(CVodeSetMaxNumStepsB(cvodes_mem_, index_backward_,
+                                                 max_num_steps_),
+                            "CVodeSetMaxNumStepsB");
+        check_flag_sundials(
+            CVodeSetLinearSolverB(cvodes_mem_, index_backward_, LS_backward_,
+                                  A_backward_),
+            "CVodeSetLinearSolverB");
+        check_flag_sundials(
+            CVodeSetJacFnB(cvodes_mem_, index_backward_,
+                           &cvodes_integrator_adjoint_vari::cv_jacobian_adj),
+            "CVodeSetJacFnB");
+
+        if (num_args_vars_ > 0) {
+          check_flag_sundials(
+              CVodeQuadInitB(cvodes_mem_, index_backward_,
+                             &cvodes_integrator_adjoint_vari::cv_quad_rhs_adj,
+                             nv_quad_),
+              "CVodeQuadInitB");
+          check_flag_sundials(
+              CVodeQuadSStolerancesB(cvodes_mem_, index_backward_,
+                                     relative_tolerance_, absolute_tolerance_),
+              "CVodeQuadSStolerancesB");
+          check_flag_sundials(
+              CVodeSetQuadErrConB(cvodes_mem_, index_backward_, SUNTRUE),
+              "CVodeSetQuadErrConB");
+        }
+
+        backward_is_initialized_ = true;
+      } else {
+        // the adjoints of the solution make the backward state jump at
+        // each output time such that the backward problem is restarted
+        check_flag_sundials(CVodeReInitB(cvodes_mem_, index_backward_, t_init,
+                                         nv_state_backward_),
+                            "CVodeReInitB");
+        if (num_args_vars_ > 0) {
+          check_flag_sundials(
+              CVodeQuadReInitB(cvodes_mem_, index_backward_, nv_quad_),
+              "CVodeQuadReInitB");
+        }
+      }
+
+      int error_code = CVodeB(cvodes_mem_, t_final, CV_NORMAL);
+
+      if (error_code == CV_TOO_MUCH_WORK) {
+        throw_domain_error(function_name_.c_str(), "", t_final,
+                           "Failed to integrate backward to output time (",
+                           ") in less than max_num_steps steps");
+      } else {
+        check_flag_sundials(error_code, "CVodeB");
+      }
+
+      double t_ret;
+      check_flag_sundials(
+          CVodeGetB(cvodes_mem_, index_backward_, &t_ret, nv_state_backward_),
+          "CVodeGetB");
+      if (num_args_vars_ > 0) {
+        check_flag_sundials(
+            CVodeGetQuadB(cvodes_mem_, index_backward_, &t_ret, nv_quad_),
+            "CVodeGetQuadB");
+      }
+    }
+  };
+
+  /**
+   * Implements the function of type CVRhsFn which is the user-defined
+   * ODE RHS passed to CVODES.
+   */
+  static int cv_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data) {
+    cvodes_solver* solver = static_cast<cvodes_solver*>(user_data);
+    const Eigen::VectorXd dy_dt = solver->rhs(
+        t, Eigen::Map<const Eigen::VectorXd>(NV_DATA_S(y), solver->N_));
+    std::copy(dy_dt.data(), dy_dt.data() + dy_dt.size(), NV_DATA_S(ydot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVDlsJacFn which is the
+   * user-defined callback for CVODES to calculate the jacobian of the
+   * ode_rhs wrt to the states y. The jacobian is stored in column
+   * major format.
+   */
+  static int cv_jacobian_states(realtype t, N_Vector y, N_Vector fy,
+                                SUNMatrix J, void* user_data, N_Vector tmp1,
+                                N_Vector tmp2, N_Vector tmp3) {
+    cvodes_solver* solver = static_cast<cvodes_solver*>(user_data);
+    const Eigen::MatrixXd Jfy = solver->jacobian_states(t, NV_DATA_S(y));
+    for (size_t j = 0; j < Jfy.cols(); ++j) {
+      for (size_t i = 0; i < Jfy.rows(); ++i) {
+        SM_ELEMENT_D(J, i, j) = Jfy(i, j);
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVRhsFnB which is the RHS of the
+   * adjoint ODE, -J_y^T * yB.
+   */
+  static int cv_rhs_adj(realtype t, N_Vector y, N_Vector yB, N_Vector yBdot,
+                        void* user_data) {
+    cvodes_solver* solver = static_cast<cvodes_solver*>(user_data);
+    double* dyB_dt = NV_DATA_S(yBdot);
+    solver->rhs_adj(t, NV_DATA_S(y), NV_DATA_S(yB), dyB_dt, nullptr);
+    for (size_t i = 0; i < solver->N_; ++i) {
+      dyB_dt[i] = -dyB_dt[i];
+    }
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVQuadRhsFnB which is the RHS of
+   * the quadrature of the parameter adjoints, -J_theta^T * yB.
+   */
+  static int cv_quad_rhs_adj(realtype t, N_Vector y, N_Vector yB,
+                             N_Vector qBdot, void* user_data) {
+    cvodes_solver* solver = static_cast<cvodes_solver*>(user_data);
+    double* dqB_dt = NV_DATA_S(qBdot);
+    solver->rhs_adj(t, NV_DATA_S(y), NV_DATA_S(yB), nullptr, dqB_dt);
+    for (size_t j = 0; j < solver->num_args_vars_; ++j) {
+      dqB_dt[j] = -dqB_dt[j];
+    }
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVLsJacFnB which is the jacobian
+   * of the adjoint ODE RHS wrt to the backward state, -J_y^T.
+   */
+  static int cv_jacobian_adj(realtype t, N_Vector y, N_Vector yB,
+                             N_Vector fyB, SUNMatrix JB, void* user_data,
+                             N_Vector tmp1B, N_Vector tmp2B, N_Vector tmp3B) {
+    cvodes_solver* solver = static_cast<cvodes_solver*>(user_data);
+    const Eigen::MatrixXd Jfy = solver->jacobian_states(t, NV_DATA_S(y));
+    for (size_t j = 0; j < Jfy.cols(); ++j) {
+      for (size_t i = 0; i < Jfy.rows(); ++i) {
+        SM_ELEMENT_D(JB, j, i) = -Jfy(i, j);
+      }
+    }
+    return 0;
+  }
+
+  const size_t N_;
+  const size_t num_y0_vars_;
+  const size_t num_t0_vars_;
+  const size_t num_ts_vars_;
+  const size_t num_args_vars_;
+  const double t0_;
+  std::vector<double> ts_;
+  Eigen::VectorXd y0_;
+  vari** y0_varis_;
+  vari** t0_varis_;
+  vari** ts_varis_;
+  vari** args_varis_;
+  vari** non_chaining_varis_;
+  cvodes_solver* solver_;
+
+ public:
+  /**
+   * Construct cvodes_integrator_adjoint_vari object and solve the
+   * forward problem.
+   *
+   * @param function_name Calling function name (for printing debugging
+   * messages)
+   * @param f Right hand side of the ODE
+   * @param y0 Initial state
+   * @param t0 Initial time
+   * @param ts Times at which to solve the ODE at. All values must be sorted and
+   *   not less than t0.
+   * @param relative_tolerance Relative tolerance passed to CVODES
+   * @param absolute_tolerance Absolute tolerance passed to CVODES
+   * @param max_num_steps Upper limit on the number of integration steps to
+   *   take between each output (error if exceeded)
+   * @param num_steps_between_checkpoints Number of integration steps
+   *   between two checkpoints of the forward solution
+   * @param[in, out] msgs the print stream for warning messages
+   * @param args Extra arguments passed unmodified through to ODE right hand
+   * side function
+   * @throw <code>std::domain_error</code> if y0, t0, ts, theta, x are not
+   *   finite, all elements of ts are not greater than t0, or ts is not
+   *   sorted in strictly increasing order.
+   * @throw <code>std::invalid_argument</code> if arguments are the wrong
+   *   size or tolerances, max_num_steps or num_steps_between_checkpoints
+   *   are out of range.
+   */
+  cvodes_integrator_adjoint_vari(
+      const char* function_name, const F& f,
+      const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0, const T_t0& t0,
+      const std::vector<T_ts>& ts, double relative_tolerance,
+      double absolute_tolerance,
+      long int max_num_steps,                  // NOLINT(runtime/int)
+      long int num_steps_between_checkpoints,  // NOLINT(runtime/int)
+      std::ostream* msgs, const T_Args&... args)
+      : N_(y0.size()),
+        num_y0_vars_(count_vars(y0)),
+        num_t0_vars_(count_vars(t0)),
+        num_ts_vars_(count_vars(ts)),
+        num_args_vars_(count_vars(args...)),
+        t0_(value_of(t0)),
+        ts_(value_of(ts)),
+        y0_(value_of(y0)),
+        y0_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+                num_y0_vars_)),
+        t0_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+                num_t0_vars_)),
+        ts_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+                num_ts_vars_)),
+        args_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+                num_args_vars_)),
+        non_chaining_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+                ts.size() * y0.size())),
+        solver_(nullptr) {
+    check_finite(function_name, "initial state", y0);
+    check_finite(function_name, "initial time", t0);
+    check_finite(function_name, "times", ts);
+
+    // Code from: https://stackoverflow.com/a/17340003 . Should probably do
+    // something better
+    std::vector<int> unused_temp{
+        0, (check_finite(function_name, "ode parameters and data", args),
+            0)...};
+
+    check_nonzero_size(function_name, "times", ts);
+    check_nonzero_size(function_name, "initial state", y0);
+    check_sorted(function_name, "times", ts);
+    check_less(function_name, "initial time", t0, ts[0]);
+    check_positive_finite(function_name, "relative_tolerance",
+                          relative_tolerance);
+    check_positive_finite(function_name, "absolute_tolerance",
+                          absolute_tolerance);
+    check_positive(function_name, "max_num_steps", max_num_steps);
+    check_positive(function_name, "num_steps_between_checkpoints",
+                   num_steps_between_checkpoints);
+
+    save_varis(y0_varis_, y0);
+    save_varis(t0_varis_, t0);
+    save_varis(ts_varis_, ts);
+    save_varis(args_varis_, args...);
+
+    solver_ = new cvodes_solver(function_name, f, msgs, y0_,
+                                relative_tolerance, absolute_tolerance,
+                                max_num_steps, args...);
+    void* cvodes_mem = solver_->cvodes_mem_;
+
+    check_flag_sundials(
+        CVodeInit(cvodes_mem, &cvodes_integrator_adjoint_vari::cv_rhs, t0_,
+                  solver_->nv_state_forward_),
+        "CVodeInit");
+
+    // Assign pointer to the solver as user data
+    check_flag_sundials(
+        CVodeSetUserData(cvodes_mem, reinterpret_cast<void*>(solver_)),
+        "CVodeSetUserData");
+
+    cvodes_set_options(cvodes_mem, relative_tolerance, absolute_tolerance,
+                       max_num_steps);
+
+    check_flag_sundials(CVodeSetLinearSolver(cvodes_mem, solver_->LS_forward_,
+                                             solver_->A_forward_),
+                        "CVodeSetLinearSolver");
+    check_flag_sundials(
+        CVodeSetJacFn(cvodes_mem,
+                      &cvodes_integrator_adjoint_vari::cv_jacobian_states),
+        "CVodeSetJacFn");
+
+    check_flag_sundials(
+        CVodeAdjInit(cvodes_mem, num_steps_between_checkpoints, CV_HERMITE),
+        "CVodeAdjInit");
+
+    // CVodeF takes single steps internally regardless of max_num_steps
+    // such that the steps are taken and counted here. The solution at
+    // the output times is interpolated from the last step.
+    double t_init = t0_;
+    double t_step = t0_;
+    for (size_t n = 0; n < ts_.size(); ++n) {
+      double t_final = ts_[n];
+
+      if (t_final != t_init) {
+        long int num_steps = 0;  // NOLINT(runtime/int)
+        while (t_step < t_final) {
+          if (num_steps++ == max_num_steps) {
+            throw_domain_error(function_name, "", t_final,
+                               "Failed to integrate to next output time (",
+                               ") in less than max_num_steps steps");
+          }
+          int ncheck;
+          check_flag_sundials(CVodeF(cvodes_mem, t_final,
+                                     solver_->nv_state_forward_, &t_step,
+                                     CV_ONE_STEP, &ncheck),
+                              "CVodeF");
+        }
+        check_flag_sundials(
+            CVodeGetDky(cvodes_mem, t_final, 0, solver_->nv_state_forward_),
+            "CVodeGetDky");
+      }
+
+      solver_->y_.emplace_back(solver_->state_forward_);
+      for (size_t i = 0; i < N_; ++i) {
+        non_chaining_varis_[n * N_ + i]
+            = new vari(solver_->state_forward_.coeff(i), false);
+      }
+
+      t_init = t_final;
+    }
+
+    ChainableStack::instance_->var_stack_.push_back(this);
+  }
+
+  /**
+   * Return the solution of the ODE at the output times as vars.
+   */
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> solution() const {
+    std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> y;
+    y.reserve(ts_.size());
+    for (size_t n = 0; n < ts_.size(); ++n) {
+      Eigen::Matrix<var, Eigen::Dynamic, 1> y_n(N_);
+      for (size_t i = 0; i < N_; ++i) {
+        y_n.coeffRef(i) = var(non_chaining_varis_[n * N_ + i]);
+      }
+      y.emplace_back(std::move(y_n));
+    }
+    return y;
+  }
+
+  /**
+   * Propagate the adjoints of the solution to the initial state, the
+   * times and the parameters by integrating the adjoint ODE backwards
+   * in time.
+   */
+  void chain() final {
+    solver_->state_backward_.setZero();
+    solver_->quad_.setZero();
+
+    double t_init = ts_.back();
+    for (size_t n = ts_.size(); n-- > 0;) {
+      Eigen::VectorXd y_adj_n(N_);
+      for (size_t i = 0; i < N_; ++i) {
+        y_adj_n.coeffRef(i) = non_chaining_varis_[n * N_ + i]->adj_;
+      }
+
+      if (num_ts_vars_ > 0) {
+        ts_varis_[n]->adj_ += y_adj_n.dot(solver_->rhs(ts_[n], solver_->y_[n]));
+      }
+
+      solver_->state_backward_ += y_adj_n;
+
+      double t_final = n > 0 ? ts_[n - 1] : t0_;
+      if (t_final != t_init) {
+        solver_->solve_backward(t_init, t_final);
+      }
+      t_init = t_final;
+    }
+
+    if (num_t0_vars_ > 0) {
+      t0_varis_[0]->adj_
+          -= solver_->state_backward_.dot(solver_->rhs(t0_, y0_));
+    }
+
+    for (size_t i = 0; i < num_y0_vars_; ++i) {
+      y0_varis_[i]->adj_ += solver_->state_backward_.coeff(i);
+    }
+
+    for (size_t j = 0; j < num_args_vars_; ++j) {
+      args_varis_[j]->adj_ += solver_->quad_.coeff(j);
+    }
+  }
+
+  void set_zero_adjoint() final {}
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
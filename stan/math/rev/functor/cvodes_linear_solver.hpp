@@ -0,0 +1,156 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CVODES_LINEAR_SOLVER_HPP
+#define STAN_MATH_REV_FUNCTOR_CVODES_LINEAR_SOLVER_HPP
+
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <functional>
+
+namespace stan {
+namespace math {
+
+/**
+ * Linear solver used by the Newton iterations of the CVODES
+ * integrators, which solve linear systems with the matrix
+ * I - gamma * J where J is the Jacobian of the ODE right hand side wrt
+ * to the states.
+ *
+ * <ul>
+ * <li>dense: Dense direct solver with a dense Jacobian (default).</li>
+ * <li>band: Banded direct solver. Only the given lower and upper
+ * bandwidths of the Jacobian are computed, which takes
+ * lower_bandwidth + upper_bandwidth + 1 reverse sweeps instead of one
+ * per state. The Jacobian must not have any entries outside of these
+ * bandwidths.</li>
+ * <li>spgmr, spbcgs: Preconditioned Krylov solvers (GMRES and
+ * Bi-CGStab) which only require products of the Jacobian with
+ * vectors. These are approximated by CVODES with difference quotients
+ * of the right hand side, such that the Jacobian is neither formed
+ * nor factorized.</li>
+ * </ul>
+ *
+ * The Krylov solvers can be given a left preconditioner P which
+ * approximates I - gamma * J. The setup hook is called whenever CVODES
+ * updates the preconditioner and the solve hook returns the solution z
+ * of P z = r. The setup hook is given the jacobian J, which CVODES
+ * reuses from an earlier setup as long as it deems J to be accurate
+ * enough, such that J is only recomputed on some of the setups.
+ */
+class cvodes_linear_solver {
+ public:
+  enum class solver_type { dense, band, spgmr, spbcgs };
+
+  using preconditioner_setup_t
+      = std::function<void(double t, const Eigen::VectorXd& y,
+                           const Eigen::MatrixXd& J, double gamma)>;
+  using preconditioner_solve_t = std::function<Eigen::VectorXd(
+      double t, const Eigen::VectorXd& y, const Eigen::VectorXd& r,
+      double gamma)>;
+
+  /**
+   * Return a dense direct solver.
+   */
+  static cvodes_linear_solver dense() {
+    return cvodes_linear_solver(solver_type::dense);
+  }
+
+  /**
+   * Return a banded direct solver.
+   *
+   * @param lower_bandwidth Number of sub-diagonals of the Jacobian
+   * @param upper_bandwidth Number of super-diagonals of the Jacobian
+   * @throw std::domain_error if a bandwidth is negative
+   */
+  static cvodes_linear_solver band(int lower_bandwidth, int upper_bandwidth) {
+    check_nonnegative("cvodes_linear_solver", "lower_bandwidth",
+                      lower_bandwidth);
+    check_nonnegative("cvodes_linear_solver", "upper_bandwidth",
+                      upper_bandwidth);
+    cvodes_linear_solver solver(solver_type::band);
+    solver.lower_bandwidth_ = lower_bandwidth;
+    solver.upper_bandwidth_ = upper_bandwidth;
+    return solver;
+  }
+
+  /**
+   * Return a GMRES solver.
+   *
+   * @param max_krylov_dim Maximum dimension of the Krylov subspace; 0
+   *   selects the SUNDIALS default
+   * @throw std::domain_error if max_krylov_dim is negative
+   */
+  static cvodes_linear_solver spgmr(int max_krylov_dim = 0) {
+    return krylov(solver_type::spgmr, max_krylov_dim);
+  }
+
+  /**
+   * Return a Bi-CGStab solver.
+   *
+   * @param max_krylov_dim Maximum dimension of the Krylov subspace; 0
+   *   selects the SUNDIALS default
+   * @throw std::domain_error if max_krylov_dim is negative
+   */
+  static cvodes_linear_solver spbcgs(int max_krylov_dim = 0) {
+    return krylov(solver_type::spbcgs, max_krylov_dim);
+  }
+
+  /**
+   * Set a left preconditioner of a Krylov solver.
+   *
+   * @param setup Called whenever the preconditioner for I - gamma * J
+   *   at the time t and the state y is to be updated, where J is the
+   *   jacobian of the ODE RHS wrt to the states (possibly of an
+   *   earlier time and state)
+   * @param solve Returns the solution z of P z = r
+   * @return this solver
+   * @throw std::invalid_argument if this is not a Krylov solver
+   */
+  cvodes_linear_solver& preconditioner(const preconditioner_setup_t& setup,
+                                       const preconditioner_solve_t& solve) {
+    if (!is_krylov()) {
+      invalid_argument("cvodes_linear_solver", "preconditioner", "",
+                       "is only supported by the Krylov solvers", "");
+    }
+    preconditioner_setup_ = setup;
+    preconditioner_solve_ = solve;
+    return *this;
+  }
+
+  solver_type type() const { return type_; }
+  int lower_bandwidth() const { return lower_bandwidth_; }
+  int upper_bandwidth() const { return upper_bandwidth_; }
+  int max_krylov_dim() const { return max_krylov_dim_; }
+  bool is_krylov() const {
+    return type_ == solver_type::spgmr || type_ == solver_type::spbcgs;
+  }
+  bool has_preconditioner() const {
+    return static_cast<bool>(preconditioner_solve_);
+  }
+  const preconditioner_setup_t& preconditioner_setup() const {
+    return preconditioner_setup_;
+  }
+  const preconditioner_solve_t& preconditioner_solve() const {
+    return preconditioner_solve_;
+  }
+
+ private:
+  explicit cvodes_linear_solver(solver_type type) : type_(type) {}
+
+  static cvodes_linear_solver krylov(solver_type type, int max_krylov_dim) {
+    check_nonnegative("cvodes_linear_solver", "max_krylov_dim",
+                      max_krylov_dim);
+    cvodes_linear_solver solver(type);
+    solver.max_krylov_dim_ = max_krylov_dim;
+    return solver;
+  }
+
+  solver_type type_;
+  int lower_bandwidth_ = 0;
+  int upper_bandwidth_ = 0;
+  int max_krylov_dim_ = 0;
+  preconditioner_setup_t preconditioner_setup_;
+  preconditioner_solve_t preconditioner_solve_;
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -3,6 +3,7 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/prim/err.hpp>
+#include <stan/math/prim/functor/ode_stats.hpp>
 #include <cvodes/cvodes.h>
 #include <sstream>
 #include <stdexcept>
@@ -47,6 +48,52 @@ inline void cvodes_set_options(void* cvodes_mem, double rel_tol, double abs_tol,
                       "CVodeSetMaxConvFails");
 }
 
+/**
+ * Overwrite the counters of an ODE solve with the ones of the CVODES
+ * memory.
+ *
+ * @param cvodes_mem CVODES memory
+ * @param has_sensitivities Whether forward sensitivities were solved
+ * @param[out] stats counters of the solve
+ */
+inline void cvodes_get_stats(void* cvodes_mem, bool has_sensitivities,
+                             ode_stats& stats) {
+  stats = ode_stats();
+  check_flag_sundials(CVodeGetNumSteps(cvodes_mem, &stats.num_steps),
+                      "CVodeGetNumSteps");
+  check_flag_sundials(CVodeGetNumRhsEvals(cvodes_mem, &stats.num_rhs_evals),
+                      "CVodeGetNumRhsEvals");
+  long int num_jacobian_evals = 0;  // NOLINT(runtime/int)
+  long int num_preconditioner_evals = 0;  // NOLINT(runtime/int)
+  check_flag_sundials(CVodeGetNumJacEvals(cvodes_mem, &num_jacobian_evals),
+                      "CVodeGetNumJacEvals");
+  check_flag_sundials(
+      CVodeGetNumPrecEvals(cvodes_mem, &num_preconditioner_evals),
+      "CVodeGetNumPrecEvals");
+  stats.num_jacobian_evals = num_jacobian_evals + num_preconditioner_evals;
+  check_flag_sundials(
+      CVodeGetNumLinSolvSetups(cvodes_mem, &stats.num_linear_solver_setups),
+      "CVodeGetNumLinSolvSetups");
+  check_flag_sundials(
+      CVodeGetNumErrTestFails(cvodes_mem, &stats.num_error_test_failures),
+      "CVodeGetNumErrTestFails");
+  check_flag_sundials(
+      CVodeGetNumNonlinSolvIters(cvodes_mem,
+                                 &stats.num_nonlinear_solver_iterations),
+      "CVodeGetNumNonlinSolvIters");
+  check_flag_sundials(
+      CVodeGetNumNonlinSolvConvFails(
+          cvodes_mem, &stats.num_nonlinear_solver_convergence_failures),
+      "CVodeGetNumNonlinSolvConvFails");
+  if (has_sensitivities) {
+    check_flag_sundials(
+        CVodeGetSensNumRhsEvals(cvodes_mem, &stats.num_sensitivity_rhs_evals),
+        "CVodeGetSensNumRhsEvals");
+  }
+  check_flag_sundials(CVodeGetLastStep(cvodes_mem, &stats.last_step_size),
+                      "CVodeGetLastStep");
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
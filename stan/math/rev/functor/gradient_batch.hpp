@@ -0,0 +1,86 @@
+#ifndef STAN_MATH_REV_FUNCTOR_GRADIENT_BATCH_HPP
+#define STAN_MATH_REV_FUNCTOR_GRADIENT_BATCH_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <cstddef>
+
+namespace stan {
+namespace math {
+
+/**
+ * Calculate the values and the gradients of the specified function
+ * for a batch of arguments. Each column of the argument matrix is
+ * one argument to the function.
+ *
+ * <p>The functor must implement
+ *
+ * <code>
+ * var
+ * operator()(const
+ * Eigen::Matrix<var, Eigen::Dynamic, 1>&)
+ * </code>
+ *
+ * using only operations that are defined for <code>var</code> and it
+ * must be safe to call it concurrently from different threads.
+ *
+ * <p>Whenever STAN_THREADS is defined the columns are split into
+ * chunks of at least <code>grainsize</code> columns which are
+ * distributed over the TBB worker threads. Every column is evaluated
+ * in a nested autodiff scope on the thread local AD tape of the
+ * executing thread such that the arena memory of the tape is reused
+ * from column to column. Without STAN_THREADS the columns are
+ * evaluated in turn on the calling thread.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Matrix of arguments, one argument per column
+ * @param[out] fx Function applied to each column of the arguments
+ * @param[out] grad_fx Gradients of the function, one gradient per column
+ * @param[in] grainsize Suggested number of columns evaluated by one task
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F>
+void gradient_batch(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& x,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& fx,
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& grad_fx,
+    int grainsize = 1) {
+  check_positive("gradient_batch", "grainsize", grainsize);
+
+  const std::size_t num_args = x.cols();
+  fx.resize(num_args);
+  grad_fx.resize(x.rows(), num_args);
+
+  auto execute_chunk = [&](std::size_t start, std::size_t end) -> void {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x.rows());
+    for (std::size_t j = start; j != end; ++j) {
+      nested_rev_autodiff nested;
+      x_var = x.col(j).template cast<var>();
+      var fx_var = f(x_var);
+      fx(j) = fx_var.val();
+      grad(fx_var.vi_);
+      grad_fx.col(j) = x_var.adj();
+    }
+  };
+
+#ifdef STAN_THREADS
+  tbb::parallel_for(
+      tbb::blocked_range<std::size_t>(0, num_args, grainsize),
+      [&](const tbb::blocked_range<std::size_t>& r) {
+        execute_chunk(r.begin(), r.end());
+      });
+#else
+  execute_chunk(0, num_args);
+#endif
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -85,7 +85,7 @@ class idas_forward_system : public idas_system<F, Tyy, Typ, Tpar> {
    * Convert to void pointer for IDAS callbacks
    */
   void* to_user_data() {  // prepare to inject DAE info
-    return static_cast<void*>(this);
+    return static_cast<void*>(&this->user_data_);
   }
 
   /**
@@ -101,7 +101,8 @@ class idas_forward_system : public idas_system<F, Tyy, Typ, Tpar> {
       using Eigen::Dynamic;
 
       using DAE = idas_forward_system<F, Tyy, Typ, Tpar>;
-      DAE* dae = static_cast<DAE*>(user_data);
+      DAE* dae = static_cast<DAE*>(
+          static_cast<internal::idas_user_data*>(user_data)->dae_);
 
       static const char* caller = "sensitivity_residual";
       check_greater(caller, "number of parameters", ns, 0);
@@ -3,12 +3,15 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/idas_forward_system.hpp>
+#include <stan/math/rev/functor/sundials_workspace_cache.hpp>
 #include <stan/math/prim/err.hpp>
+#include <stan/math/prim/functor/ode_stats.hpp>
 #include <idas/idas.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
 #include <nvector/nvector_serial.h>
 #include <ostream>
+#include <tuple>
 #include <vector>
 #include <algorithm>
 
@@ -17,6 +20,60 @@ enum IDAS_SENSITIVITY { forward };
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * IDAS memory together with the linear solver used by an
+ * idas_integrator. The workspace is created and initialized by the
+ * first solve and only re-initialized by later solves of a DAE system
+ * with the same number of unknowns and sensitivity parameters.
+ */
+struct idas_workspace {
+  using key_type = std::tuple<size_t, size_t>;
+
+  const key_type key_;
+  void* mem_;
+  SUNMatrix A_;
+  SUNLinearSolver LS_;
+  idas_user_data user_data_;
+  bool is_initialized_;
+
+  /**
+   * Allocate the IDAS memory and the linear solver. The IDAS memory is
+   * not initialized yet.
+   *
+   * @param[in] n number of unknowns
+   * @param[in] ns number of sensitivity parameters
+   * @param[in] yy N_Vector of the unknowns of the DAE system
+   */
+  idas_workspace(size_t n, size_t ns, N_Vector yy)
+      : key_(n, ns),
+        mem_(IDACreate()),
+        A_(nullptr),
+        LS_(nullptr),
+        user_data_{nullptr},
+        is_initialized_(false) {
+    if (mem_ == NULL) {
+      throw std::runtime_error("IDACreate failed to allocate memory");
+    }
+    A_ = SUNDenseMatrix(n, n);
+    LS_ = SUNDenseLinearSolver(yy, A_);
+  }
+
+  idas_workspace(const idas_workspace&) = delete;
+  idas_workspace& operator=(const idas_workspace&) = delete;
+
+  ~idas_workspace() {
+    IDAFree(&mem_);
+    SUNLinSolFree(LS_);
+    SUNMatDestroy(A_);
+  }
+
+  const key_type& key() const { return key_; }
+};
+
+}  // namespace internal
+
 /**
  * IDAS DAE integrator.
  */
@@ -28,16 +85,18 @@ class idas_integrator {
    * Forward decl
    */
   template <typename Dae>
-  void init_sensitivity(Dae& dae);
+  void init_sensitivity(Dae& dae, internal::idas_workspace& workspace);
 
   /**
    * Placeholder for data-only idas_forward_system, no sensitivity
    *
    * @tparam F DAE functor type.
    * @param[in] dae DAE system
+   * @param[in] workspace IDAS workspace
    */
   template <typename F>
-  void init_sensitivity(idas_forward_system<F, double, double, double>& dae) {}
+  void init_sensitivity(idas_forward_system<F, double, double, double>& dae,
+                        internal::idas_workspace& workspace) {}
 
   // \cond
   // template <typename F, typename Tyy, typename Typ, typename Tpar>
@@ -55,21 +114,52 @@ class idas_integrator {
    * @tparam Tpar type of DAE parameters.
    *
    * @param[out] dae DAE system
+   * @param[in] mem IDAS memory
    * @param[in] t0 initial time.
    * @param[in] ts times of the desired solutions
    * @param[out] res_yy DAE solutions
    */
   template <typename F>
-  void solve(idas_forward_system<F, double, double, double>& dae,
+  void solve(idas_forward_system<F, double, double, double>& dae, void* mem,
              const double& t0, const std::vector<double>& ts,
              std::vector<std::vector<double> >& res_yy);
 
   template <typename Dae>
-  void solve(Dae& dae, const double& t0, const std::vector<double>& ts,
-             typename Dae::return_type& res_yy);
+  void solve(Dae& dae, void* mem, const double& t0,
+             const std::vector<double>& ts, typename Dae::return_type& res_yy);
 
   // TODO(yizhang): adjoint sensitivity solver
 
+  /**
+   * Overwrite the counters of a DAE solve with the ones of the IDAS
+   * memory.
+   *
+   * @param[in] mem IDAS memory
+   * @param[in] has_sensitivities whether forward sensitivities were solved
+   * @param[out] stats counters of the solve
+   */
+  static void get_stats(void* mem, bool has_sensitivities, ode_stats& stats) {
+    stats = ode_stats();
+    CHECK_IDAS_CALL(IDAGetNumSteps(mem, &stats.num_steps));
+    CHECK_IDAS_CALL(IDAGetNumResEvals(mem, &stats.num_rhs_evals));
+    long int num_jacobian_evals = 0;  // NOLINT(runtime/int)
+    CHECK_IDAS_CALL(IDAGetNumJacEvals(mem, &num_jacobian_evals));
+    stats.num_jacobian_evals = num_jacobian_evals;
+    CHECK_IDAS_CALL(
+        IDAGetNumLinSolvSetups(mem, &stats.num_linear_solver_setups));
+    CHECK_IDAS_CALL(
+        IDAGetNumErrTestFails(mem, &stats.num_error_test_failures));
+    CHECK_IDAS_CALL(
+        IDAGetNumNonlinSolvIters(mem, &stats.num_nonlinear_solver_iterations));
+    CHECK_IDAS_CALL(IDAGetNumNonlinSolvConvFails(
+        mem, &stats.num_nonlinear_solver_convergence_failures));
+    if (has_sensitivities) {
+      CHECK_IDAS_CALL(
+          IDAGetSensNumResEvals(mem, &stats.num_sensitivity_rhs_evals));
+    }
+    CHECK_IDAS_CALL(IDAGetLastStep(mem, &stats.last_step_size));
+  }
+
  public:
   static constexpr int IDAS_MAX_STEPS = 500;
   /**
@@ -111,12 +201,15 @@ class idas_integrator {
    * @param[in] t0 initial time.
    * @param[in] ts times of the desired solutions, in strictly
    * increasing order, all greater than the initial time.
+   * @param[out] stats if not null, the counters of the solve are
+   * written to it, also if the solve fails.
    * @return a vector of states, each state being a vector of the
    * same size as the state variable, corresponding to a time in ts.
    */
   template <typename Dae>
   typename Dae::return_type integrate(Dae& dae, double t0,
-                                      const std::vector<double>& ts) {
+                                      const std::vector<double>& ts,
+                                      ode_stats* stats = nullptr) {
     using Eigen::Dynamic;
     using Eigen::Matrix;
     using Eigen::MatrixXd;
@@ -129,7 +222,6 @@ class idas_integrator {
     check_nonzero_size(caller, "times", ts);
     check_less(caller, "initial time", t0, ts.front());
 
-    auto mem = dae.mem();
     auto yy = dae.nv_yy();
     auto yp = dae.nv_yp();
     const size_t n = dae.n();
@@ -137,28 +229,46 @@ class idas_integrator {
     typename Dae::return_type res_yy(
         ts.size(), std::vector<typename Dae::scalar_type>(n, 0));
 
-    auto A = SUNDenseMatrix(n, n);
-    auto LS = SUNDenseLinearSolver(yy, A);
-
-    try {
-      CHECK_IDAS_CALL(IDASetUserData(mem, dae.to_user_data()));
+    // the workspace is freed instead of cached if the solve throws
+    using workspace_cache
+        = sundials_workspace_cache<internal::idas_workspace, Dae>;
+    const size_t ns = dae.ns();
+    typename workspace_cache::workspace_ptr workspace
+        = workspace_cache::acquire(internal::idas_workspace::key_type(n, ns),
+                                   n, ns, yy);
+    void* mem = workspace->mem_;
+    workspace->user_data_.dae_ = static_cast<void*>(&dae);
 
+    if (workspace->is_initialized_) {
+      CHECK_IDAS_CALL(IDAReInit(mem, t0, yy, yp));
+    } else {
+      CHECK_IDAS_CALL(IDASetUserData(mem, &workspace->user_data_));
       CHECK_IDAS_CALL(IDAInit(mem, dae.residual(), t0, yy, yp));
-      CHECK_IDAS_CALL(IDASetLinearSolver(mem, LS, A));
-      CHECK_IDAS_CALL(IDASStolerances(mem, rtol_, atol_));
-      CHECK_IDAS_CALL(IDASetMaxNumSteps(mem, max_num_steps_));
+      CHECK_IDAS_CALL(IDASetLinearSolver(mem, workspace->LS_, workspace->A_));
+    }
+    CHECK_IDAS_CALL(IDASStolerances(mem, rtol_, atol_));
+    CHECK_IDAS_CALL(IDASetMaxNumSteps(mem, max_num_steps_));
 
-      init_sensitivity(dae);
+    init_sensitivity(dae, *workspace);
+    workspace->is_initialized_ = true;
 
-      solve(dae, t0, ts, res_yy);
+    try {
+      solve(dae, mem, t0, ts, res_yy);
     } catch (const std::exception& e) {
-      SUNLinSolFree(LS);
-      SUNMatDestroy(A);
+      if (stats != nullptr) {
+        try {
+          get_stats(mem, ns > 0, *stats);
+        } catch (const std::exception&) {
+          // the error of the solve is reported instead
+        }
+      }
       throw;
     }
+    if (stats != nullptr) {
+      get_stats(mem, ns > 0, *stats);
+    }
 
-    SUNLinSolFree(LS);
-    SUNMatDestroy(A);
+    workspace_cache::release(std::move(workspace));
 
     return res_yy;
   }
@@ -167,15 +277,19 @@ class idas_integrator {
 /**
  * Initialize sensitivity calculation and set
  * tolerance. For sensitivity with respect to initial
- * conditions, set sensitivity to identity
+ * conditions, set sensitivity to identity. The
+ * sensitivities of a workspace which has been initialized
+ * before are only re-initialized.
  *
  * @tparam Dae DAE system type
  * @param[in, out] dae DAE system
+ * @param[in] workspace IDAS workspace
  */
 template <typename Dae>
-void idas_integrator::init_sensitivity(Dae& dae) {
+void idas_integrator::init_sensitivity(Dae& dae,
+                                       internal::idas_workspace& workspace) {
   if (Dae::need_sens) {
-    auto mem = dae.mem();
+    auto mem = workspace.mem_;
     auto yys = dae.nv_yys();
     auto yps = dae.nv_yps();
     auto n = dae.n();
@@ -190,9 +304,13 @@ void idas_integrator::init_sensitivity(Dae& dae) {
         NV_Ith_S(yps[i + n], i) = 1.0;
       }
     }
-    CHECK_IDAS_CALL(IDASensInit(mem, dae.ns(), IDA_SIMULTANEOUS,
-                                dae.sensitivity_residual(), yys, yps));
-    CHECK_IDAS_CALL(IDASensEEtolerances(mem));
+    if (workspace.is_initialized_) {
+      CHECK_IDAS_CALL(IDASensReInit(mem, IDA_SIMULTANEOUS, yys, yps));
+    } else {
+      CHECK_IDAS_CALL(IDASensInit(mem, dae.ns(), IDA_SIMULTANEOUS,
+                                  dae.sensitivity_residual(), yys, yps));
+      CHECK_IDAS_CALL(IDASensEEtolerances(mem));
+    }
     CHECK_IDAS_CALL(IDAGetSensConsistentIC(mem, yys, yps));
   }
 }
@@ -203,17 +321,18 @@ void idas_integrator::init_sensitivity(Dae& dae) {
  *
  * @tparam F DAE functor type
  * @param[out] dae DAE system
+ * @param[in] mem IDAS memory
  * @param[in] t0 initial time
  * @param[in] ts times of the desired solutions
  * @param[out] res_yy DAE solutions
  */
 template <typename F>
 void idas_integrator::solve(idas_forward_system<F, double, double, double>& dae,
-                            const double& t0, const std::vector<double>& ts,
+                            void* mem, const double& t0,
+                            const std::vector<double>& ts,
                             std::vector<std::vector<double> >& res_yy) {
   double t1 = t0;
   size_t i = 0;
-  auto mem = dae.mem();
   auto yy = dae.nv_yy();
   auto yp = dae.nv_yp();
 
@@ -231,17 +350,17 @@ void idas_integrator::solve(idas_forward_system<F, double, double, double>& dae,
  *
  * @tparam Dae DAE system type
  * @param[out] dae DAE system
+ * @param[in] mem IDAS memory
  * @param[in] t0 initial time
  * @param[in] ts times of the desired solutions
  * @param[out] res_yy DAE solutions
  */
 template <typename Dae>
-void idas_integrator::solve(Dae& dae, const double& t0,
+void idas_integrator::solve(Dae& dae, void* mem, const double& t0,
                             const std::vector<double>& ts,
                             typename Dae::return_type& res_yy) {
   double t1 = t0;
   size_t i = 0;
-  auto mem = dae.mem();
   auto yy = dae.nv_yy();
   auto yp = dae.nv_yp();
   auto yys = dae.nv_yys();
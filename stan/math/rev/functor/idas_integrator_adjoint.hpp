@@ -0,0 +1,714 @@
+#ifndef STAN_MATH_REV_FUNCTOR_IDAS_INTEGRATOR_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_IDAS_INTEGRATOR_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/idas_system.hpp>
+#include <stan/math/rev/functor/sundials_workspace_cache.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <idas/idas.h>
+#include <nvector/nvector_serial.h>
+#include <sunlinsol/sunlinsol_dense.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * IDAS memory together with the state vectors and the linear solvers
+ * of the forward and the backward problem used by an
+ * idas_integrator_adjoint_vari. The workspace is created and
+ * initialized by the first solve and only re-initialized by later
+ * solves with the same number of unknowns, number of parameters and
+ * number of steps between checkpoints.
+ */
+struct idas_adjoint_workspace {
+  using key_type = std::tuple<size_t, size_t, long int>;  // NOLINT
+
+  const key_type key_;
+  const size_t N_;
+  const size_t M_;
+  Eigen::VectorXd yy_;
+  Eigen::VectorXd yp_;
+  Eigen::VectorXd yyB_;
+  Eigen::VectorXd ypB_;
+  Eigen::VectorXd qB_;
+  N_Vector nv_yy_;
+  N_Vector nv_yp_;
+  N_Vector nv_yyB_;
+  N_Vector nv_ypB_;
+  N_Vector nv_qB_;
+  SUNMatrix A_;
+  SUNMatrix AB_;
+  SUNLinearSolver LS_;
+  SUNLinearSolver LSB_;
+  void* mem_;
+  int index_backward_;
+  bool is_initialized_;
+  bool backward_is_initialized_;
+  /**
+   * The workspace is the user data of the IDAS memory, since IDAS
+   * keeps copies of the user data pointer. This points to the solver
+   * which currently uses the workspace.
+   */
+  void* solver_;
+
+  /**
+   * Allocate the IDAS memory, the state vectors and the linear
+   * solvers. The IDAS memory is not initialized yet.
+   *
+   * @param N Number of unknowns
+   * @param M Number of parameters
+   * @param num_steps_between_checkpoints Number of integration steps
+   *   between two checkpoints of the forward solution
+   */
+  idas_adjoint_workspace(size_t N, size_t M,
+                         long int num_steps_between_checkpoints)  // NOLINT
+      : key_(N, M, num_steps_between_checkpoints),
+        N_(N),
+        M_(M),
+        yy_(Eigen::VectorXd::Zero(N)),
+        yp_(Eigen::VectorXd::Zero(N)),
+        yyB_(Eigen::VectorXd::Zero(N)),
+        ypB_(Eigen::VectorXd::Zero(N)),
+        qB_(Eigen::VectorXd::Zero(M)),
+        nv_yy_(N_VMake_Serial(N, yy_.data())),
+        nv_yp_(N_VMake_Serial(N, yp_.data())),
+        nv_yyB_(N_VMake_Serial(N, yyB_.data())),
+        nv_ypB_(N_VMake_Serial(N, ypB_.data())),
+        nv_qB_(M > 0 ? N_VMake_Serial(M, qB_.data()) : nullptr),
+        A_(SUNDenseMatrix(N, N)),
+        AB_(SUNDenseMatrix(N, N)),
+        LS_(SUNDenseLinearSolver(nv_yy_, A_)),
+        LSB_(SUNDenseLinearSolver(nv_yyB_, AB_)),
+        mem_(IDACreate()),
+        index_backward_(0),
+        is_initialized_(false),
+        backward_is_initialized_(false),
+        solver_(nullptr) {
+    if (mem_ == nullptr) {
+      throw std::runtime_error("IDACreate failed to allocate memory");
+    }
+  }
+
+  idas_adjoint_workspace(const idas_adjoint_workspace&) = delete;
+  idas_adjoint_workspace& operator=(const idas_adjoint_workspace&) = delete;
+
+  ~idas_adjoint_workspace() {
+    IDAFree(&mem_);
+    SUNLinSolFree(LS_);
+    SUNLinSolFree(LSB_);
+    SUNMatDestroy(A_);
+    SUNMatDestroy(AB_);
+    N_VDestroy_Serial(nv_yy_);
+    N_VDestroy_Serial(nv_yp_);
+    N_VDestroy_Serial(nv_yyB_);
+    N_VDestroy_Serial(nv_ypB_);
+    if (nv_qB_ != nullptr) {
+      N_VDestroy_Serial(nv_qB_);
+    }
+  }
+
+  const key_type& key() const { return key_; }
+};
+
+}  // namespace internal
+
+/**
+ * Integrator interface for the IDAS DAE solver using the adjoint
+ * method to propagate the gradients wrt to the parameters.
+ *
+ * <p>The forward pass solves the DAE F(t, y, y', theta) = 0 only and
+ * stores checkpoints of the solution every
+ * num_steps_between_checkpoints steps. The reverse pass solves the
+ * adjoint DAE
+ *
+ * \f[
+ *   F_y^T \lambda - F_{y'}^T \lambda' = 0
+ * \f]
+ *
+ * backwards in time from the last to the first output time and
+ * integrates the quadrature
+ *
+ * \f[
+ *   \frac{d \mu}{dt} = F_{\theta}^T \lambda
+ * \f]
+ *
+ * for the adjoints of the parameters. The forward solution needed in
+ * between the checkpoints is recomputed by IDAS.
+ *
+ * <p>At each output time the adjoints w of the solution enter the
+ * adjoint DAE as a jump of lambda. The part of w which belongs to the
+ * algebraic components of the solution can not be represented by
+ * F_{y'}^T lambda and is eliminated with the algebraic constraints.
+ * With Q the orthogonal projector onto the null space of F_{y'} and
+ * G = F_{y'} + F_y Q, which is non-singular for a DAE of index one,
+ * the jump is
+ *
+ * \f[
+ *   u = G^{-T} Q w, \quad
+ *   \lambda = G^{-T} (I - Q) (w - F_y^T u), \quad
+ *   \lambda' = G^{-T} F_y^T \lambda,
+ * \f]
+ *
+ * which is consistent with the adjoint DAE, and the adjoints of the
+ * parameters are decreased by F_{\theta}^T u.
+ *
+ * <p>The adjoint DAE assumes that F_{y'} does not change over time,
+ * which is the case for semi-explicit DAEs and for residuals which are
+ * linear in y' with constant coefficients. The initial state and its
+ * derivative are data such that their sensitivities vanish.
+ *
+ * @tparam F Type of DAE residual
+ */
+template <typename F>
+class idas_integrator_adjoint_vari : public vari_base {
+  using workspace_cache
+      = sundials_workspace_cache<internal::idas_adjoint_workspace,
+                                 idas_integrator_adjoint_vari>;
+
+  /**
+   * DAE residual, data and IDAS workspace which are needed during the
+   * reverse pass. The workspace is returned to the cache together with
+   * the memory of the AD tape.
+   */
+  struct idas_solver : public chainable_alloc {
+    const std::string function_name_;
+    const F f_;
+    const std::vector<double> theta_;
+    const std::vector<double> x_r_;
+    const std::vector<int> x_i_;
+    std::ostream* msgs_;
+    const size_t N_;
+    const size_t M_;
+    const double relative_tolerance_;
+    const double absolute_tolerance_;
+    const long int max_num_steps_;  // NOLINT(runtime/int)
+    std::vector<Eigen::VectorXd> yy_;
+    std::vector<Eigen::VectorXd> yp_;
+    typename workspace_cache::workspace_ptr workspace_;
+
+    idas_solver(const char* function_name, const F& f,
+                const std::vector<double>& theta,
+                const std::vector<double>& x_r, const std::vector<int>& x_i,
+                std::ostream* msgs, size_t N, double relative_tolerance,
+                double absolute_tolerance,
+                long int max_num_steps,                  // NOLINT
+                long int num_steps_between_checkpoints)  // NOLINT
+        : function_name_(function_name),
+          f_(f),
+          theta_(theta),
+          x_r_(x_r),
+          x_i_(x_i),
+          msgs_(msgs),
+          N_(N),
+          M_(theta.size()),
+          relative_tolerance_(relative_tolerance),
+          absolute_tolerance_(absolute_tolerance),
+          max_num_steps_(max_num_steps),
+          workspace_(workspace_cache::acquire(
+              internal::idas_adjoint_workspace::key_type(
+                  N, theta.size(), num_steps_between_checkpoints),
+              N, theta.size(), num_steps_between_checkpoints)) {
+      workspace_->solver_ = this;
+    }
+
+    /**
+     * Return an idle workspace to the cache. A workspace whose solve
+     * threw has been reset before.
+     */
+    virtual ~idas_solver() {
+      if (workspace_) {
+        workspace_cache::release(std::move(workspace_));
+      }
+    }
+
+    /**
+     * Calculates the DAE residual at the given time t, unknowns yy and
+     * derivatives yp.
+     */
+    void residual(double t, const double yy[], const double yp[],
+                  double rr[]) const {
+      const std::vector<double> yy_vec(yy, yy + N_);
+      const std::vector<double> yp_vec(yp, yp + N_);
+      const std::vector<double> res
+          = f_(t, yy_vec, yp_vec, theta_, x_r_, x_i_, msgs_);
+      check_size_match(function_name_.c_str(), "residual", res.size(),
+                       "states", N_);
+      std::copy(res.begin(), res.end(), rr);
+    }
+
+    /**
+     * Calculates the residual of the adjoint DAE, F_y^T yB - F_yp^T ypB,
+     * using one evaluation of the DAE residual and two reverse sweeps.
+     */
+    void adjoint_residual(double t, const double yy[], const double yp[],
+                          const double yyB[], const double ypB[],
+                          double rrB[]) const {
+      nested_rev_autodiff nested;
+
+      const std::vector<var> yy_vars(yy, yy + N_);
+      const std::vector<var> yp_vars(yp, yp + N_);
+      std::vector<var> res
+          = f_(t, yy_vars, yp_vars, theta_, x_r_, x_i_, msgs_);
+      check_size_match(function_name_.c_str(), "residual", res.size(),
+                       "states", N_);
+
+      for (size_t i = 0; i < N_; ++i) {
+        res[i].vi_->adj_ += yyB[i];
+      }
+      grad();
+      for (size_t i = 0; i < N_; ++i) {
+        rrB[i] = yy_vars[i].adj();
+      }
+
+      nested.set_zero_all_adjoints();
+      for (size_t i = 0; i < N_; ++i) {
+        res[i].vi_->adj_ += ypB[i];
+      }
+      grad();
+      for (size_t i = 0; i < N_; ++i) {
+        rrB[i] -= yp_vars[i].adj();
+      }
+    }
+
+    /**
+     * Calculates the product F_theta^T w of the jacobian of the DAE
+     * residual wrt to the parameters with the vector w using a single
+     * reverse sweep.
+     */
+    void theta_adjoint(double t, const double yy[], const double yp[],
+                       const double w[], double theta_adj[]) const {
+      nested_rev_autodiff nested;
+
+      const std::vector<double> yy_vec(yy, yy + N_);
+      const std::vector<double> yp_vec(yp, yp + N_);
+      const std::vector<var> theta_vars(theta_.begin(), theta_.end());
+      std::vector<var> res
+          = f_(t, yy_vec, yp_vec, theta_vars, x_r_, x_i_, msgs_);
+      check_size_match(function_name_.c_str(), "residual", res.size(),
+                       "states", N_);
+
+      for (size_t i = 0; i < N_; ++i) {
+        res[i].vi_->adj_ += w[i];
+      }
+      grad();
+      for (size_t j = 0; j < M_; ++j) {
+        theta_adj[j] = theta_vars[j].adj();
+      }
+    }
+
+    /**
+     * Calculates the jacobians J and K of the DAE residual wrt to the
+     * unknowns and wrt to their derivatives.
+     */
+    void jacobians(double t, const Eigen::VectorXd& yy,
+                   const Eigen::VectorXd& yp, Eigen::MatrixXd& J,
+                   Eigen::MatrixXd& K) const {
+      nested_rev_autodiff nested;
+
+      const std::vector<var> yy_vars(yy.data(), yy.data() + N_);
+      const std::vector<var> yp_vars(yp.data(), yp.data() + N_);
+      std::vector<var> res
+          = f_(t, yy_vars, yp_vars, theta_, x_r_, x_i_, msgs_);
+      check_size_match(function_name_.c_str(), "residual", res.size(),
+                       "states", N_);
+
+      J.resize(N_, N_);
+      K.resize(N_, N_);
+      for (size_t i = 0; i < N_; ++i) {
+        if (i > 0) {
+          nested.set_zero_all_adjoints();
+        }
+        res[i].grad();
+        for (size_t j = 0; j < N_; ++j) {
+          J.coeffRef(i, j) = yy_vars[j].adj();
+          K.coeffRef(i, j) = yp_vars[j].adj();
+        }
+      }
+    }
+
+    /**
+     * Integrates the backward problem from t_init to t_final starting
+     * at the current backward state and quadrature.
+     */
+    void solve_backward(double t_init, double t_final,
+                        bool is_first_backward_solve) {
+      internal::idas_adjoint_workspace& ws = *workspace_;
+      void* mem = ws.mem_;
+      if (!ws.backward_is_initialized_) {
+        CHECK_IDAS_CALL(IDACreateB(mem, &ws.index_backward_));
+        CHECK_IDAS_CALL(IDAInitB(mem, ws.index_backward_,
+                                 &idas_integrator_adjoint_vari::ida_res_adj,
+                                 t_init, ws.nv_yyB_, ws.nv_ypB_));
+        CHECK_IDAS_CALL(
+            IDASetUserDataB(mem, ws.index_backward_, workspace_.get()));
+        CHECK_IDAS_CALL(
+            IDASetLinearSolverB(mem, ws.index_backward_, ws.LSB_, ws.AB_));
+        if (M_ > 0) {
+          CHECK_IDAS_CALL(
+              IDAQuadInitB(mem, ws.index_backward_,
+                           &idas_integrator_adjoint_vari::ida_quad_rhs_adj,
+                           ws.nv_qB_));
+          CHECK_IDAS_CALL(IDASetQuadErrConB(mem, ws.index_backward_, SUNTRUE));
+        }
+        ws.backward_is_initialized_ = true;
+      } else {
+        // the adjoints of the solution make the backward state jump at
+        // each output time such that the backward problem is restarted
+        CHECK_IDAS_CALL(IDAReInitB(mem, ws.index_backward_, t_init,
+                                   ws.nv_yyB_, ws.nv_ypB_));
+        if (M_ > 0) {
+          CHECK_IDAS_CALL(IDAQuadReInitB(mem, ws.index_backward_, ws.nv_qB_));
+        }
+      }
+
+      if (is_first_backward_solve) {
+        CHECK_IDAS_CALL(IDASStolerancesB(mem, ws.index_backward_,
+                                         relative_tolerance_,
+                                         absolute_tolerance_));
+        CHECK_IDAS_CALL(
+            IDASetMaxNumStepsB(mem, ws.index_backward_, max_num_steps_));
+        if (M_ > 0) {
+          CHECK_IDAS_CALL(IDAQuadSStolerancesB(mem, ws.index_backward_,
+                                               relative_tolerance_,
+                                               absolute_tolerance_));
+        }
+      }
+
+      int error_code = IDASolveB(mem, t_final, IDA_NORMAL);
+      if (error_code == IDA_TOO_MUCH_WORK) {
+        throw_domain_error(function_name_.c_str(), "", t_final,
+                           "Failed to integrate backward to output time (",
+                           ") in less than max_num_steps steps");
+      } else {
+        CHECK_IDAS_CALL(error_code);
+      }
+
+      double t_ret;
+      CHECK_IDAS_CALL(
+          IDAGetB(mem, ws.index_backward_, &t_ret, ws.nv_yyB_, ws.nv_ypB_));
+      if (M_ > 0) {
+        CHECK_IDAS_CALL(
+            IDAGetQuadB(mem, ws.index_backward_, &t_ret, ws.nv_qB_));
+      }
+    }
+  };
+
+  /**
+   * Return the solver which uses the workspace that IDAS passes as
+   * user data to the callbacks.
+   */
+  static idas_solver* solver_of(void* user_data) {
+    return static_cast<idas_solver*>(
+        static_cast<internal::idas_adjoint_workspace*>(user_data)->solver_);
+  }
+
+  /**
+   * Implements the function of type IDAResFn which is the DAE residual
+   * passed to IDAS.
+   */
+  static int ida_res(realtype t, N_Vector yy, N_Vector yp, N_Vector rr,
+                     void* user_data) {
+    solver_of(user_data)->residual(t, NV_DATA_S(yy), NV_DATA_S(yp),
+                                   NV_DATA_S(rr));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type IDAResFnB which is the residual of
+   * the adjoint DAE.
+   */
+  static int ida_res_adj(realtype t, N_Vector yy, N_Vector yp, N_Vector yyB,
+                         N_Vector ypB, N_Vector rrB, void* user_data) {
+    solver_of(user_data)->adjoint_residual(t, NV_DATA_S(yy), NV_DATA_S(yp),
+                                           NV_DATA_S(yyB), NV_DATA_S(ypB),
+                                           NV_DATA_S(rrB));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type IDAQuadRhsFnB which is the RHS of
+   * the quadrature of the parameter adjoints, F_theta^T * yB.
+   */
+  static int ida_quad_rhs_adj(realtype t, N_Vector yy, N_Vector yp,
+                              N_Vector yyB, N_Vector ypB, N_Vector qBdot,
+                              void* user_data) {
+    solver_of(user_data)->theta_adjoint(t, NV_DATA_S(yy), NV_DATA_S(yp),
+                                        NV_DATA_S(yyB), NV_DATA_S(qBdot));
+    return 0;
+  }
+
+  const size_t N_;
+  const size_t M_;
+  const double t0_;
+  std::vector<double> ts_;
+  vari** theta_varis_;
+  vari** non_chaining_varis_;
+  idas_solver* solver_;
+
+ public:
+  /**
+   * Construct idas_integrator_adjoint_vari object and solve the
+   * forward problem.
+   *
+   * @param function_name Calling function name (for printing debugging
+   *   messages)
+   * @param f DAE residual
+   * @param yy0 Initial state
+   * @param yp0 Initial derivative state
+   * @param t0 Initial time
+   * @param ts Times of the desired solutions, in strictly increasing
+   *   order, all greater than the initial time
+   * @param theta Parameters
+   * @param x_r Real data
+   * @param x_i Int data
+   * @param relative_tolerance Relative tolerance passed to IDAS
+   * @param absolute_tolerance Absolute tolerance passed to IDAS
+   * @param max_num_steps Upper limit on the number of integration steps to
+   *   take between each output (error if exceeded)
+   * @param num_steps_between_checkpoints Number of integration steps
+   *   between two checkpoints of the forward solution
+   * @param[in, out] msgs the print stream for warning messages
+   * @throw <code>std::domain_error</code> if the inputs are not finite,
+   *   the initial state is not consistent or ts is not sorted in
+   *   strictly increasing order.
+   * @throw <code>std::invalid_argument</code> if tolerances,
+   *   max_num_steps or num_steps_between_checkpoints are out of range.
+   */
+  idas_integrator_adjoint_vari(
+      const char* function_name, const F& f, const std::vector<double>& yy0,
+      const std::vector<double>& yp0, double t0, const std::vector<double>& ts,
+      const std::vector<var>& theta, const std::vector<double>& x_r,
+      const std::vector<int>& x_i, double relative_tolerance,
+      double absolute_tolerance,
+      long int max_num_steps,                  // NOLINT(runtime/int)
+      long int num_steps_between_checkpoints,  // NOLINT(runtime/int)
+      std::ostream* msgs)
+      : N_(yy0.size()),
+        M_(theta.size()),
+        t0_(t0),
+        ts_(ts),
+        theta_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(M_)),
+        non_chaining_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+                ts.size() * yy0.size())),
+        solver_(nullptr) {
+    check_finite(function_name, "initial state", yy0);
+    check_finite(function_name, "derivative initial state", yp0);
+    check_finite(function_name, "initial time", t0);
+    check_finite(function_name, "times", ts);
+    check_finite(function_name, "parameter vector", theta);
+    check_finite(function_name, "continuous data", x_r);
+    check_nonzero_size(function_name, "initial state", yy0);
+    check_nonzero_size(function_name, "times", ts);
+    check_consistent_sizes(function_name, "initial state", yy0,
+                           "derivative initial state", yp0);
+    check_ordered(function_name, "times", ts);
+    check_less(function_name, "initial time", t0, ts.front());
+    check_positive_finite(function_name, "relative_tolerance",
+                          relative_tolerance);
+    check_less_or_equal(function_name, "relative_tolerance",
+                        relative_tolerance, 1.0E-3);
+    check_positive_finite(function_name, "absolute_tolerance",
+                          absolute_tolerance);
+    check_positive(function_name, "max_num_steps", max_num_steps);
+    check_positive(function_name, "num_steps_between_checkpoints",
+                   num_steps_between_checkpoints);
+
+    save_varis(theta_varis_, theta);
+
+    solver_ = new idas_solver(function_name, f, value_of(theta), x_r, x_i,
+                              msgs, N_, relative_tolerance,
+                              absolute_tolerance, max_num_steps,
+                              num_steps_between_checkpoints);
+
+    try {
+      solve_forward(yy0, yp0, num_steps_between_checkpoints);
+    } catch (const std::exception& e) {
+      solver_->workspace_.reset();
+      throw;
+    }
+
+    ChainableStack::instance_->var_stack_.push_back(this);
+  }
+
+  /**
+   * Return the solution of the DAE at the output times as vars.
+   */
+  std::vector<std::vector<var>> solution() const {
+    std::vector<std::vector<var>> yy(ts_.size(), std::vector<var>(N_));
+    for (size_t n = 0; n < ts_.size(); ++n) {
+      for (size_t i = 0; i < N_; ++i) {
+        yy[n][i] = var(non_chaining_varis_[n * N_ + i]);
+      }
+    }
+    return yy;
+  }
+
+  /**
+   * Propagate the adjoints of the solution to the parameters by
+   * solving the adjoint DAE backwards in time.
+   */
+  void chain() final {
+    try {
+      solve_backward();
+    } catch (const std::exception& e) {
+      solver_->workspace_.reset();
+      throw;
+    }
+  }
+
+  void set_zero_adjoint() final {}
+
+ private:
+  /**
+   * Solve the DAE at the output times and store the checkpoints of
+   * the forward solution.
+   */
+  void solve_forward(const std::vector<double>& yy0,
+                     const std::vector<double>& yp0,
+                     long int num_steps_between_checkpoints) {  // NOLINT
+    internal::idas_adjoint_workspace& ws = *solver_->workspace_;
+    void* mem = ws.mem_;
+    const char* function_name = solver_->function_name_.c_str();
+
+    ws.yy_ = Eigen::Map<const Eigen::VectorXd>(yy0.data(), N_);
+    ws.yp_ = Eigen::Map<const Eigen::VectorXd>(yp0.data(), N_);
+
+    Eigen::VectorXd res0(N_);
+    solver_->residual(t0_, ws.yy_.data(), ws.yp_.data(), res0.data());
+    check_less_or_equal(function_name, "DAE residual at t0", res0.norm(),
+                        solver_->absolute_tolerance_);
+
+    if (ws.is_initialized_) {
+      CHECK_IDAS_CALL(IDAReInit(mem, t0_, ws.nv_yy_, ws.nv_yp_));
+      CHECK_IDAS_CALL(IDAAdjReInit(mem));
+    } else {
+      CHECK_IDAS_CALL(IDASetUserData(mem, solver_->workspace_.get()));
+      CHECK_IDAS_CALL(IDAInit(mem, &idas_integrator_adjoint_vari::ida_res,
+                              t0_, ws.nv_yy_, ws.nv_yp_));
+      CHECK_IDAS_CALL(IDASetLinearSolver(mem, ws.LS_, ws.A_));
+      CHECK_IDAS_CALL(
+          IDAAdjInit(mem, num_steps_between_checkpoints, IDA_HERMITE));
+      ws.is_initialized_ = true;
+    }
+    CHECK_IDAS_CALL(IDASStolerances(mem, solver_->relative_tolerance_,
+                                    solver_->absolute_tolerance_));
+    CHECK_IDAS_CALL(IDASetMaxNumSteps(mem, solver_->max_num_steps_));
+
+    // IDASolveF does not limit the number of steps, such that the steps
+    // are taken one by one and the solution is interpolated at ts
+    double t_ret = t0_;
+    for (size_t n = 0; n < ts_.size(); ++n) {
+      long int num_steps = 0;  // NOLINT(runtime/int)
+      while (t_ret < ts_[n]) {
+        if (num_steps == solver_->max_num_steps_) {
+          throw_domain_error(function_name, "", ts_[n],
+                             "Failed to integrate to next output time (",
+                             ") in less than max_num_steps steps");
+        }
+        int ncheck;
+        CHECK_IDAS_CALL(IDASolveF(mem, ts_[n], &t_ret, ws.nv_yy_, ws.nv_yp_,
+                                  IDA_ONE_STEP, &ncheck));
+        ++num_steps;
+      }
+      CHECK_IDAS_CALL(IDAGetDky(mem, ts_[n], 0, ws.nv_yy_));
+      CHECK_IDAS_CALL(IDAGetDky(mem, ts_[n], 1, ws.nv_yp_));
+
+      solver_->yy_.emplace_back(ws.yy_);
+      solver_->yp_.emplace_back(ws.yp_);
+      for (size_t i = 0; i < N_; ++i) {
+        non_chaining_varis_[n * N_ + i] = new vari(ws.yy_.coeff(i), false);
+      }
+    }
+  }
+
+  /**
+   * Add the jump of the backward state at the output time with index n
+   * which is due to the adjoints of the solution at that time.
+   */
+  void add_output_adjoints(size_t n, Eigen::VectorXd& theta_adj) {
+    internal::idas_adjoint_workspace& ws = *solver_->workspace_;
+    Eigen::VectorXd w(N_);
+    for (size_t i = 0; i < N_; ++i) {
+      w.coeffRef(i) = non_chaining_varis_[n * N_ + i]->adj_;
+    }
+    if (w.isZero(0.0)) {
+      return;
+    }
+
+    Eigen::MatrixXd J;
+    Eigen::MatrixXd K;
+    solver_->jacobians(ts_[n], solver_->yy_[n], solver_->yp_[n], J, K);
+
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(K, Eigen::ComputeFullV);
+    const Eigen::Index num_algebraic = N_ - svd.rank();
+    const Eigen::MatrixXd Q
+        = svd.matrixV().rightCols(num_algebraic)
+          * svd.matrixV().rightCols(num_algebraic).transpose();
+
+    Eigen::FullPivLU<Eigen::MatrixXd> G_t((K + J * Q).transpose());
+    if (!G_t.isInvertible()) {
+      throw_domain_error(solver_->function_name_.c_str(), "", ts_[n],
+                         "DAE at output time (", ") is not of index one");
+    }
+
+    const Eigen::VectorXd u = G_t.solve(Q * w);
+    Eigen::VectorXd v = w - J.transpose() * u;
+    v -= Q * v;
+    const Eigen::VectorXd lambda = G_t.solve(v);
+
+    ws.yyB_ += lambda;
+    ws.ypB_ += G_t.solve(J.transpose() * lambda);
+
+    if (M_ > 0 && !u.isZero(0.0)) {
+      Eigen::VectorXd theta_adj_u(M_);
+      solver_->theta_adjoint(ts_[n], solver_->yy_[n].data(),
+                             solver_->yp_[n].data(), u.data(),
+                             theta_adj_u.data());
+      theta_adj -= theta_adj_u;
+    }
+  }
+
+  /**
+   * Solve the adjoint DAE from the last to the first output time and
+   * add the adjoints of the parameters.
+   */
+  void solve_backward() {
+    internal::idas_adjoint_workspace& ws = *solver_->workspace_;
+    ws.yyB_.setZero();
+    ws.ypB_.setZero();
+    ws.qB_.setZero();
+    Eigen::VectorXd theta_adj = Eigen::VectorXd::Zero(M_);
+
+    bool is_first_backward_solve = true;
+    double t_init = ts_.back();
+    for (size_t n = ts_.size(); n-- > 0;) {
+      add_output_adjoints(n, theta_adj);
+
+      double t_final = n > 0 ? ts_[n - 1] : t0_;
+      solver_->solve_backward(t_init, t_final, is_first_backward_solve);
+      is_first_backward_solve = false;
+      t_init = t_final;
+    }
+
+    for (size_t j = 0; j < M_; ++j) {
+      theta_varis_[j]->adj_ += theta_adj.coeff(j) + ws.qB_.coeff(j);
+    }
+  }
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -72,6 +72,20 @@ inline void matrix_d_to_NVarray(const Eigen::MatrixXd& mat, N_Vector* nv,
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * User data passed to the IDAS callbacks. IDAS keeps copies of the
+ * user data pointer, such that a cached IDAS memory is given a
+ * pointer to this indirection instead, which points to the DAE system
+ * currently being solved.
+ */
+struct idas_user_data {
+  void* dae_;
+};
+
+}  // namespace internal
+
 /**
  * IDAS DAE system that contains information on residual
  * equation functor, sensitivity residual equation functor,
@@ -103,8 +117,8 @@ class idas_system {
   std::vector<double> rr_val_;  // workspace
   N_Vector nv_rr_;
   N_Vector id_;
-  void* mem_;
   std::ostream* msgs_;
+  internal::idas_user_data user_data_;
 
  public:
   static constexpr bool is_var_yy0 = stan::is_var<Tyy>::value;
@@ -149,16 +163,12 @@ class idas_system {
         rr_val_(N_, 0.0),
         nv_rr_(N_VMake_Serial(N_, rr_val_.data())),
         id_(N_VNew_Serial(N_)),
-        mem_(IDACreate()),
-        msgs_(msgs) {
+        msgs_(msgs),
+        user_data_{this} {
     if (nv_yy_ == NULL || nv_yp_ == NULL) {
       throw std::runtime_error("N_VMake_Serial failed to allocate memory");
     }
 
-    if (mem_ == NULL) {
-      throw std::runtime_error("IDACreate failed to allocate memory");
-    }
-
     static const char* caller = "idas_system";
     check_finite(caller, "initial state", yy0);
     check_finite(caller, "derivative initial state", yp0);
@@ -179,14 +189,13 @@ class idas_system {
   }
 
   /**
-   * Destructor to deallocate IDAS solution memory and workspace.
+   * Destructor to deallocate workspace.
    */
   ~idas_system() {
     N_VDestroy_Serial(nv_yy_);
     N_VDestroy_Serial(nv_yp_);
     N_VDestroy_Serial(nv_rr_);
     N_VDestroy_Serial(id_);
-    IDAFree(&mem_);
   }
 
   /**
@@ -295,11 +304,6 @@ class idas_system {
    */
   const size_t n_par() { return theta_.size(); }
 
-  /**
-   * Return IDAS memory handle
-   */
-  void* mem() { return mem_; }
-
   /**
    * Return reference to DAE functor
    */
@@ -312,7 +316,8 @@ class idas_system {
     return [](double t, N_Vector yy, N_Vector yp, N_Vector rr,
               void* user_data) -> int {
       using DAE = idas_system<F, Tyy, Typ, Tpar>;
-      DAE* dae = static_cast<DAE*>(user_data);
+      DAE* dae = static_cast<DAE*>(
+          static_cast<internal::idas_user_data*>(user_data)->dae_);
 
       size_t N = NV_LENGTH_S(yy);
       auto yy_val = N_VGetArrayPointer(yy);
@@ -32,6 +32,8 @@ namespace math {
  * @param[in] max_num_steps maximal number of admissable steps
  * between time-points
  * @param[in] msgs message
+ * @param[out] stats if not null, the counters of the solve are written
+ * to it, also if the solve fails
  * @return a vector of states, each state being a vector of the
  * same size as the state variable, corresponding to a time in ts.
  */
@@ -42,7 +44,7 @@ std::vector<std::vector<Tpar> > integrate_dae(
     const std::vector<double>& x_r, const std::vector<int>& x_i,
     const double rtol, const double atol,
     const int64_t max_num_steps = idas_integrator::IDAS_MAX_STEPS,
-    std::ostream* msgs = nullptr) {
+    std::ostream* msgs = nullptr, ode_stats* stats = nullptr) {
   /* it doesn't matter here what values \c eq_id has, as we
      don't allow yy0 or yp0 to be parameters */
   const std::vector<int> dummy_eq_id(yy0.size(), 0);
@@ -53,7 +55,7 @@ std::vector<std::vector<Tpar> > integrate_dae(
 
   dae.check_ic_consistency(t0, atol);
 
-  return solver.integrate(dae, t0, ts);
+  return solver.integrate(dae, t0, ts, stats);
 }
 
 }  // namespace math
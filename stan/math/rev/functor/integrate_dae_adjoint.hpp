@@ -0,0 +1,93 @@
+#ifndef STAN_MATH_REV_FUNCTOR_INTEGRATE_DAE_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_INTEGRATE_DAE_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/idas_integrator.hpp>
+#include <stan/math/rev/functor/idas_integrator_adjoint.hpp>
+#include <stan/math/rev/functor/integrate_dae.hpp>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Return the solutions for a semi-explicit DAE system with residual
+ * specified by functor F, given the specified consistent initial state
+ * yy0 and yp0. The gradients wrt to the parameters are calculated with
+ * the adjoint method of IDAS, which solves a single backward problem
+ * of the size of the DAE and one quadrature instead of one forward
+ * sensitivity problem per parameter. This makes DAEs with many
+ * parameters practical.
+ *
+ * <p>The forward solution is checkpointed every
+ * num_steps_between_checkpoints steps. Fewer steps between checkpoints
+ * need more memory and less recomputation in the reverse pass.
+ *
+ * <p>Since the adjoint DAE is formulated for a residual whose jacobian
+ * wrt to yp is constant, the residual must be linear in yp with
+ * constant coefficients, as for semi-explicit DAEs, and of index one.
+ *
+ * @tparam F type of DAE residual
+ *
+ * @param[in] f functor for the DAE residual
+ * @param[in] yy0 initial state
+ * @param[in] yp0 initial derivative state
+ * @param[in] t0 initial time
+ * @param[in] ts times of the desired solutions, in strictly
+ * increasing order, all greater than the initial time
+ * @param[in] theta parameters
+ * @param[in] x_r real data
+ * @param[in] x_i int data
+ * @param[in] rtol relative tolerance passed to IDAS, required <10^-3
+ * @param[in] atol absolute tolerance passed to IDAS, problem-dependent
+ * @param[in] max_num_steps maximal number of admissable steps
+ * between time-points
+ * @param[in] num_steps_between_checkpoints number of steps between
+ * two checkpoints of the forward solution
+ * @param[in] msgs message
+ * @return a vector of states, each state being a vector of the
+ * same size as the state variable, corresponding to a time in ts.
+ */
+template <typename F>
+std::vector<std::vector<var> > integrate_dae_adjoint(
+    const F& f, const std::vector<double>& yy0, const std::vector<double>& yp0,
+    double t0, const std::vector<double>& ts, const std::vector<var>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    const double rtol, const double atol,
+    const int64_t max_num_steps = idas_integrator::IDAS_MAX_STEPS,
+    const int64_t num_steps_between_checkpoints = 150,
+    std::ostream* msgs = nullptr) {
+  auto* integrator = new idas_integrator_adjoint_vari<F>(
+      "integrate_dae_adjoint", f, yy0, yp0, t0, ts, theta, x_r, x_i, rtol,
+      atol, max_num_steps, num_steps_between_checkpoints, msgs);
+  return integrator->solution();
+}
+
+/**
+ * Return the solutions for a semi-explicit DAE system with data only
+ * parameters. Without gradients there is no adjoint problem, such that
+ * this is the same as integrate_dae.
+ *
+ * @tparam F type of DAE residual
+ */
+template <typename F>
+std::vector<std::vector<double> > integrate_dae_adjoint(
+    const F& f, const std::vector<double>& yy0, const std::vector<double>& yp0,
+    double t0, const std::vector<double>& ts, const std::vector<double>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    const double rtol, const double atol,
+    const int64_t max_num_steps = idas_integrator::IDAS_MAX_STEPS,
+    const int64_t num_steps_between_checkpoints = 150,
+    std::ostream* msgs = nullptr) {
+  check_positive("integrate_dae_adjoint", "num_steps_between_checkpoints",
+                 num_steps_between_checkpoints);
+  return integrate_dae(f, yy0, yp0, t0, ts, theta, x_r, x_i, rtol, atol,
+                       max_num_steps, msgs);
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -3,7 +3,13 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <cstddef>
 #include <stdexcept>
 #include <vector>
 
@@ -34,6 +40,61 @@ void jacobian(const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
   J.transposeInPlace();
 }
 
+/**
+ * Calculate the value and the Jacobian of the specified function at
+ * the specified argument, splitting the reverse sweeps for the rows
+ * of the Jacobian over the TBB worker threads.
+ *
+ * <p>Whenever STAN_THREADS is defined the rows are split into chunks
+ * of at least <code>grainsize</code> rows. Each chunk evaluates the
+ * function once on the thread local AD tape of the executing thread
+ * and then runs one reverse sweep per row of the chunk. The function
+ * is therefore evaluated once more per chunk than in the serial
+ * version and it must be safe to call it concurrently from different
+ * threads. Without STAN_THREADS the serial version is used.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[out] fx Function applied to argument
+ * @param[out] J Jacobian of function at argument
+ * @param[in] grainsize Suggested number of rows computed by one task
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F>
+void jacobian(const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+              Eigen::Matrix<double, Eigen::Dynamic, 1>& fx,
+              Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& J,
+              int grainsize) {
+  using Eigen::Dynamic;
+  using Eigen::Matrix;
+  check_positive("jacobian", "grainsize", grainsize);
+#ifdef STAN_THREADS
+  {
+    nested_rev_autodiff nested;
+    Matrix<var, Dynamic, 1> x_var(x);
+    fx = value_of(f(x_var));
+  }
+  const std::size_t M = fx.size();
+  J.resize(M, x.size());
+
+  tbb::parallel_for(
+      tbb::blocked_range<std::size_t>(0, M, grainsize),
+      [&](const tbb::blocked_range<std::size_t>& r) {
+        nested_rev_autodiff nested;
+        Matrix<var, Dynamic, 1> x_var(x);
+        Matrix<var, Dynamic, 1> fx_var = f(x_var);
+        for (std::size_t i = r.begin(); i != r.end(); ++i) {
+          nested.set_zero_all_adjoints();
+          grad(fx_var(i).vi_);
+          J.row(i) = x_var.adj();
+        }
+      });
+#else
+  jacobian(f, x, fx, J);
+#endif
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
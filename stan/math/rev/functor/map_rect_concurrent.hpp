@@ -6,22 +6,30 @@
 #include <stan/math/prim/functor/map_rect_concurrent.hpp>
 #include <stan/math/prim/functor/map_rect_reduce.hpp>
 #include <stan/math/prim/functor/map_rect_combine.hpp>
-#include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/chunk_tapes.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
-#include <algorithm>
+#include <numeric>
+#include <type_traits>
 #include <vector>
 
 namespace stan {
 namespace math {
 namespace internal {
 
+/**
+ * Evaluate all jobs of map_rect through the reduce and combine steps
+ * (see map_rect_reduce and map_rect_combine). For var arguments the
+ * reduce step computes the full Jacobian of each job with one reverse
+ * sweep per job output.
+ */
 template <int call_id, typename F, typename T_shared_param,
           typename T_job_param>
 Eigen::Matrix<return_type_t<T_shared_param, T_job_param>, Eigen::Dynamic, 1>
-map_rect_concurrent(
+map_rect_concurrent_reduce(
     const Eigen::Matrix<T_shared_param, Eigen::Dynamic, 1>& shared_params,
     const std::vector<Eigen::Matrix<T_job_param, Eigen::Dynamic, 1>>&
         job_params,
@@ -69,6 +77,205 @@ map_rect_concurrent(
   return combine(world_output, world_f_out);
 }
 
+/**
+ * Reverse mode map_rect which avoids computing the per job Jacobians.
+ *
+ * The jobs are recorded on chunk tapes (see chunk_tapes). The outputs
+ * of all jobs are inserted into the main AD tape together with this
+ * vari. During the reverse pass, the adjoints of the outputs are
+ * copied to the chunk tapes and a single reverse sweep per chunk
+ * computes the vector-Jacobian product with respect to the copies of
+ * the parameters held on the chunk tape.
+ *
+ * @tparam F type of user functor
+ * @tparam T_shared_param type of shared parameters
+ * @tparam T_job_param type of job specific parameters
+ */
+template <typename F, typename T_shared_param, typename T_job_param>
+class map_rect_adjoint_vari : public vari_base {
+  /**
+   * Local parameters and outputs of the jobs of a chunk.
+   */
+  struct chunk_locals {
+    Eigen::Matrix<T_shared_param, Eigen::Dynamic, 1> shared_params_;
+    std::vector<Eigen::Matrix<T_job_param, Eigen::Dynamic, 1>> job_params_;
+    std::vector<vector_v> outputs_;
+  };
+
+  using chunk_tapes_t = chunk_tapes<chunk_locals>;
+  using chunk_tape = typename chunk_tapes_t::chunk_tape;
+
+ public:
+  map_rect_adjoint_vari(
+      const Eigen::Matrix<T_shared_param, Eigen::Dynamic, 1>& shared_params,
+      const std::vector<Eigen::Matrix<T_job_param, Eigen::Dynamic, 1>>&
+          job_params,
+      const std::vector<std::vector<double>>& x_r,
+      const std::vector<std::vector<int>>& x_i, std::ostream* msgs)
+      : num_shared_params_(is_var<T_shared_param>::value ? shared_params.size()
+                                                         : 0),
+        num_job_params_(is_var<T_job_param>::value ? job_params[0].size() : 0),
+        num_jobs_(job_params.size()),
+        job_offsets_(ChainableStack::instance_->memalloc_.alloc_array<int>(
+            num_jobs_ + 1)),
+        tapes_(new chunk_tapes_t()) {
+    const vector_d shared_params_dbl = value_of(shared_params);
+    tapes_->record(num_jobs_, [&](chunk_locals& local, std::size_t start,
+                                  std::size_t end) {
+      local.shared_params_ = shared_params_dbl.template cast<T_shared_param>();
+      local.job_params_.reserve(end - start);
+      local.outputs_.reserve(end - start);
+      for (std::size_t i = start; i != end; ++i) {
+        local.job_params_.emplace_back(
+            value_of(job_params[i]).template cast<T_job_param>());
+        local.outputs_.emplace_back(F()(local.shared_params_,
+                                        local.job_params_.back(), x_r[i],
+                                        x_i[i], msgs));
+      }
+    });
+
+    job_offsets_[0] = 0;
+    for (const auto& tape : tapes_->tapes()) {
+      for (std::size_t i = tape->start_; i != tape->end_; ++i) {
+        job_offsets_[i + 1] = job_offsets_[i]
+                              + tape->local_.outputs_[i - tape->start_].size();
+      }
+    }
+    num_outputs_ = job_offsets_[num_jobs_];
+
+    outputs_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+        num_outputs_);
+    for (const auto& tape : tapes_->tapes()) {
+      for (std::size_t i = tape->start_; i != tape->end_; ++i) {
+        const vector_v& job_outputs = tape->local_.outputs_[i - tape->start_];
+        for (int k = 0; k < job_outputs.size(); ++k) {
+          outputs_[job_offsets_[i] + k]
+              = new vari(job_outputs.coeff(k).val(), false);
+        }
+      }
+    }
+
+    shared_params_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+        num_shared_params_);
+    for (std::size_t j = 0; j < num_shared_params_; ++j) {
+      shared_params_[j] = var_operand(shared_params.coeff(j));
+    }
+    job_params_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+        num_jobs_ * num_job_params_);
+    for (std::size_t i = 0; i < num_jobs_ && num_job_params_ > 0; ++i) {
+      for (std::size_t j = 0; j < num_job_params_; ++j) {
+        job_params_[i * num_job_params_ + j]
+            = var_operand(job_params[i].coeff(j));
+      }
+    }
+
+    ChainableStack::instance_->var_stack_.push_back(this);
+  }
+
+  /**
+   * Return the outputs of all jobs as vars.
+   */
+  vector_v outputs() const {
+    vector_v out(num_outputs_);
+    for (std::size_t k = 0; k < num_outputs_; ++k) {
+      out.coeffRef(k) = var(outputs_[k]);
+    }
+    return out;
+  }
+
+  void chain() final {
+    tapes_->reverse_sweep([&](chunk_tape& tape) {
+      for (std::size_t i = tape.start_; i != tape.end_; ++i) {
+        vector_v& job_outputs = tape.local_.outputs_[i - tape.start_];
+        for (int k = 0; k < job_outputs.size(); ++k) {
+          job_outputs.coeffRef(k).vi_->adj_
+              += outputs_[job_offsets_[i] + k]->adj_;
+        }
+      }
+    });
+
+    for (const auto& tape : tapes_->tapes()) {
+      const chunk_locals& local = tape->local_;
+      for (std::size_t j = 0; j < num_shared_params_; ++j) {
+        shared_params_[j]->adj_ += adjoint_of(local.shared_params_.coeff(j));
+      }
+      for (std::size_t i = tape->start_; i != tape->end_; ++i) {
+        for (std::size_t j = 0; j < num_job_params_; ++j) {
+          job_params_[i * num_job_params_ + j]->adj_
+              += adjoint_of(local.job_params_[i - tape->start_].coeff(j));
+        }
+      }
+    }
+  }
+
+  void set_zero_adjoint() final {}
+
+ private:
+  static vari* var_operand(const var& x) { return x.vi_; }
+  static vari* var_operand(double x) { return nullptr; }
+  static double adjoint_of(const var& x) { return x.adj(); }
+  static double adjoint_of(double x) { return 0.0; }
+
+  const std::size_t num_shared_params_;
+  const std::size_t num_job_params_;
+  const std::size_t num_jobs_;
+  std::size_t num_outputs_;
+  int* job_offsets_;
+  chunk_tapes_t* tapes_;
+  vari** outputs_;
+  vari** shared_params_;
+  vari** job_params_;
+};
+
+/**
+ * Dispatch map_rect without vars to the reduce and combine steps.
+ */
+template <int call_id, typename F, typename T_shared_param,
+          typename T_job_param>
+Eigen::Matrix<return_type_t<T_shared_param, T_job_param>, Eigen::Dynamic, 1>
+map_rect_concurrent_impl(
+    const Eigen::Matrix<T_shared_param, Eigen::Dynamic, 1>& shared_params,
+    const std::vector<Eigen::Matrix<T_job_param, Eigen::Dynamic, 1>>&
+        job_params,
+    const std::vector<std::vector<double>>& x_r,
+    const std::vector<std::vector<int>>& x_i, std::ostream* msgs,
+    std::false_type /* is_var */) {
+  return map_rect_concurrent_reduce<call_id, F>(shared_params, job_params,
+                                                x_r, x_i, msgs);
+}
+
+/**
+ * Dispatch map_rect with vars to the adjoint method.
+ */
+template <int call_id, typename F, typename T_shared_param,
+          typename T_job_param>
+Eigen::Matrix<return_type_t<T_shared_param, T_job_param>, Eigen::Dynamic, 1>
+map_rect_concurrent_impl(
+    const Eigen::Matrix<T_shared_param, Eigen::Dynamic, 1>& shared_params,
+    const std::vector<Eigen::Matrix<T_job_param, Eigen::Dynamic, 1>>&
+        job_params,
+    const std::vector<std::vector<double>>& x_r,
+    const std::vector<std::vector<int>>& x_i, std::ostream* msgs,
+    std::true_type /* is_var */) {
+  auto* vi = new map_rect_adjoint_vari<F, T_shared_param, T_job_param>(
+      shared_params, job_params, x_r, x_i, msgs);
+  return vi->outputs();
+}
+
+template <int call_id, typename F, typename T_shared_param,
+          typename T_job_param>
+Eigen::Matrix<return_type_t<T_shared_param, T_job_param>, Eigen::Dynamic, 1>
+map_rect_concurrent(
+    const Eigen::Matrix<T_shared_param, Eigen::Dynamic, 1>& shared_params,
+    const std::vector<Eigen::Matrix<T_job_param, Eigen::Dynamic, 1>>&
+        job_params,
+    const std::vector<std::vector<double>>& x_r,
+    const std::vector<std::vector<int>>& x_i, std::ostream* msgs) {
+  return map_rect_concurrent_impl<call_id, F>(
+      shared_params, job_params, x_r, x_i, msgs,
+      is_var<return_type_t<T_shared_param, T_job_param>>());
+}
+
 }  // namespace internal
 }  // namespace math
 }  // namespace stan
@@ -4,6 +4,7 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/cvodes_integrator.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/functor/ode_stats.hpp>
 #include <ostream>
 #include <vector>
 
@@ -40,6 +41,8 @@ namespace math {
  * @param absolute_tolerance Absolute tolerance passed to CVODES
  * @param max_num_steps Upper limit on the number of integration steps to
  *   take between each output (error if exceeded)
+ * @param linear_solver Linear solver used by the Newton iterations
+ * @param[out] stats If not null, the counters of the solve are written to it
  * @param[in, out] msgs the print stream for warning messages
  * @param args Extra arguments passed unmodified through to ODE right hand side
  * @return Solution to ODE at times \p ts
@@ -53,12 +56,53 @@ ode_adams_tol_impl(const char* function_name, const F& f,
                    const T_t0& t0, const std::vector<T_ts>& ts,
                    double relative_tolerance, double absolute_tolerance,
                    long int max_num_steps,  // NOLINT(runtime/int)
-                   std::ostream* msgs, const T_Args&... args) {
+                   const cvodes_linear_solver& linear_solver,
+                   ode_stats* stats, std::ostream* msgs,
+                   const T_Args&... args) {
   cvodes_integrator<CV_ADAMS, F, T_y0, T_t0, T_ts, T_Args...> integrator(
       function_name, f, y0, t0, ts, relative_tolerance, absolute_tolerance,
-      max_num_steps, msgs, args...);
+      max_num_steps, linear_solver, msgs, args...);
 
-  return integrator();
+  return integrator(stats);
+}
+
+/**
+ * Solve the ODE initial value problem without counters. See
+ * ode_adams_tol_impl above.
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_tol_impl(const char* function_name, const F& f,
+                   const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+                   const T_t0& t0, const std::vector<T_ts>& ts,
+                   double relative_tolerance, double absolute_tolerance,
+                   long int max_num_steps,  // NOLINT(runtime/int)
+                   const cvodes_linear_solver& linear_solver,
+                   std::ostream* msgs, const T_Args&... args) {
+  return ode_adams_tol_impl(function_name, f, y0, t0, ts, relative_tolerance,
+                            absolute_tolerance, max_num_steps, linear_solver,
+                            static_cast<ode_stats*>(nullptr), msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem with the dense linear solver. See
+ * ode_adams_tol_impl above.
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_tol_impl(const char* function_name, const F& f,
+                   const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+                   const T_t0& t0, const std::vector<T_ts>& ts,
+                   double relative_tolerance, double absolute_tolerance,
+                   long int max_num_steps,  // NOLINT(runtime/int)
+                   std::ostream* msgs, const T_Args&... args) {
+  return ode_adams_tol_impl(function_name, f, y0, t0, ts, relative_tolerance,
+                            absolute_tolerance, max_num_steps,
+                            cvodes_linear_solver::dense(), msgs, args...);
 }
 
 /**
@@ -107,6 +151,128 @@ ode_adams_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
                             absolute_tolerance, max_num_steps, msgs, args...);
 }
 
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the non-stiff Adams-Moulton solver from
+ * CVODES with the given linear solver for its Newton iterations. The
+ * banded and the Krylov solvers avoid the dense factorization of the
+ * Jacobian for large ODE systems, see cvodes_linear_solver.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param linear_solver Linear solver used by the Newton iterations
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+              const T_t0& t0, const std::vector<T_ts>& ts,
+              double relative_tolerance, double absolute_tolerance,
+              long int max_num_steps,  // NOLINT(runtime/int)
+              const cvodes_linear_solver& linear_solver, std::ostream* msgs,
+              const T_Args&... args) {
+  return ode_adams_tol_impl("ode_adams_tol", f, y0, t0, ts, relative_tolerance,
+                            absolute_tolerance, max_num_steps, linear_solver,
+                            msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the non-stiff Adams-Moulton solver from
+ * CVODES and write the counters of the solve to \p stats, also if the solve
+ * fails.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[out] stats Counters of the solve
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+              const T_t0& t0, const std::vector<T_ts>& ts,
+              double relative_tolerance, double absolute_tolerance,
+              long int max_num_steps,  // NOLINT(runtime/int)
+              ode_stats& stats, std::ostream* msgs, const T_Args&... args) {
+  return ode_adams_tol_impl("ode_adams_tol", f, y0, t0, ts, relative_tolerance,
+                            absolute_tolerance, max_num_steps,
+                            cvodes_linear_solver::dense(), &stats, msgs,
+                            args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the non-stiff Adams-Moulton solver from
+ * CVODES with the given linear solver and write the counters of the solve to \p
+ * stats, also if the solve fails.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param linear_solver Linear solver used by the Newton iterations
+ * @param[out] stats Counters of the solve
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+              const T_t0& t0, const std::vector<T_ts>& ts,
+              double relative_tolerance, double absolute_tolerance,
+              long int max_num_steps,  // NOLINT(runtime/int)
+              const cvodes_linear_solver& linear_solver, ode_stats& stats,
+              std::ostream* msgs, const T_Args&... args) {
+  return ode_adams_tol_impl("ode_adams_tol", f, y0, t0, ts, relative_tolerance,
+                            absolute_tolerance, max_num_steps, linear_solver,
+                            &stats, msgs, args...);
+}
+
 /**
  * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
  * times, { t1, t2, t3, ... } using the non-stiff Adams-Moulton
@@ -0,0 +1,442 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ODE_AUTO_HPP
+#define STAN_MATH_REV_FUNCTOR_ODE_AUTO_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/functor/cvodes_integrator.hpp>
+#include <stan/math/rev/functor/cvodes_linear_solver.hpp>
+#include <stan/math/rev/functor/ode_store_sensitivities.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <stan/math/prim/functor/coupled_ode_system.hpp>
+#include <stan/math/prim/functor/ode_stats.hpp>
+#include <boost/numeric/odeint.hpp>
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * Stiffness detection of the Dormand-Prince 5(4) method following
+ * Hairer & Wanner, Solving Ordinary Differential Equations II, Section
+ * IV.2. The last two stages of an accepted step are both evaluated at
+ * the end of the step, such that
+ *
+ *   h * ||k7 - k6|| / ||y7 - y6||
+ *
+ * estimates h times the dominant eigenvalue of the Jacobian of the ODE
+ * right hand side. Once it exceeds the boundary 3.25 of the stability
+ * region for 15 accepted steps before it stays below it for 6 steps,
+ * the step size is limited by stability rather than accuracy and the
+ * problem is considered stiff.
+ *
+ * Only the states of the ODE, which are the first N entries of the
+ * coupled state, enter the estimate.
+ */
+class dopri5_stiffness_detector {
+  static constexpr double stability_boundary = 3.25;
+  static constexpr int max_num_stiff_steps = 15;
+  static constexpr int max_num_nonstiff_steps = 6;
+
+  const size_t N_;
+  Eigen::VectorXd y_[2];
+  Eigen::VectorXd dy_dt_[2];
+  double t_[2];
+  int last_;
+  int num_stiff_steps_;
+  int num_nonstiff_steps_;
+
+ public:
+  /**
+   * Construct a stiffness detector.
+   *
+   * @param N Number of states
+   */
+  explicit dopri5_stiffness_detector(size_t N)
+      : N_(N),
+        y_{Eigen::VectorXd::Zero(N), Eigen::VectorXd::Zero(N)},
+        dy_dt_{Eigen::VectorXd::Zero(N), Eigen::VectorXd::Zero(N)},
+        t_{0.0, 1.0},
+        last_(0),
+        num_stiff_steps_(0),
+        num_nonstiff_steps_(0) {}
+
+  /**
+   * Record an evaluation of the coupled ODE right hand side.
+   *
+   * @param z Coupled state
+   * @param dz_dt Right hand side of the coupled ODE at z
+   * @param t Time
+   */
+  void record(const std::vector<double>& z, const std::vector<double>& dz_dt,
+              double t) {
+    last_ = 1 - last_;
+    y_[last_] = Eigen::Map<const Eigen::VectorXd>(z.data(), N_);
+    dy_dt_[last_] = Eigen::Map<const Eigen::VectorXd>(dz_dt.data(), N_);
+    t_[last_] = t;
+  }
+
+  /**
+   * Update the stiffness test with the last accepted step, whose last
+   * two stages are the last two recorded evaluations.
+   *
+   * @param h Size of the accepted step
+   * @return true if the problem is considered stiff
+   */
+  bool update(double h) {
+    if (t_[0] != t_[1]) {
+      return false;
+    }
+    const double y_diff = (y_[1] - y_[0]).squaredNorm();
+    if (!(y_diff > 0)) {
+      return false;
+    }
+    const double h_lambda
+        = h * std::sqrt((dy_dt_[1] - dy_dt_[0]).squaredNorm() / y_diff);
+    if (h_lambda > stability_boundary) {
+      num_nonstiff_steps_ = 0;
+      ++num_stiff_steps_;
+    } else if (++num_nonstiff_steps_ == max_num_nonstiff_steps) {
+      num_stiff_steps_ = 0;
+    }
+    return num_stiff_steps_ == max_num_stiff_steps;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } starting with the non-stiff Runge-Kutta 45
+ * solver in Boost and switching to the stiff backward differentiation
+ * formula (BDF) solver from CVODES as soon as the ODE is detected to be
+ * stiff.
+ *
+ * Stiffness is detected from the last two stages of each step of the
+ * Dormand-Prince method, see internal::dopri5_stiffness_detector. At the
+ * switch the coupled state of the ODE and its sensitivities is handed
+ * over to CVODES, which continues the solve from the time of the last
+ * Runge-Kutta step. The sensitivities are therefore wrt to the inputs of
+ * the whole solve, no matter which method computed the output.
+ *
+ * The switch only happens once; an ODE which is stiff in parts of the
+ * time interval is solved with BDF after the first stiff part.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial condition
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param function_name Calling function name (for printing debugging messages)
+ * @param f Right hand side of the ODE
+ * @param y0_arg Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   greater than t0.
+ * @param relative_tolerance Relative tolerance passed to Boost and CVODES
+ * @param absolute_tolerance Absolute tolerance passed to Boost and CVODES
+ * @param max_num_steps Upper limit on the number of integration steps of
+ *   each method between each output (error if exceeded)
+ * @param[out] stats If not null, the counters of the solve are written to
+ *   it, which are the sums of the counters of both methods
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_auto_tol_impl(const char* function_name, const F& f,
+                  const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0_arg,
+                  const T_t0& t0, const std::vector<T_ts>& ts,
+                  double relative_tolerance, double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  ode_stats* stats, std::ostream* msgs,
+                  const T_Args&... args) {
+  using boost::numeric::odeint::make_dense_output;
+  using boost::numeric::odeint::runge_kutta_dopri5;
+
+  using T_y0_t0 = return_type_t<T_y0, T_t0>;
+  using return_t = return_type_t<T_y0, T_t0, T_ts, T_Args...>;
+
+  Eigen::Matrix<T_y0_t0, Eigen::Dynamic, 1> y0
+      = y0_arg.template cast<T_y0_t0>();
+
+  check_finite(function_name, "initial state", y0);
+  check_finite(function_name, "initial time", t0);
+  check_finite(function_name, "times", ts);
+
+  // Code from https://stackoverflow.com/a/17340003
+  std::vector<int> unused_temp{
+      0, (check_finite(function_name, "ode parameters and data", args), 0)...};
+
+  check_nonzero_size(function_name, "initial state", y0);
+  check_nonzero_size(function_name, "times", ts);
+  check_sorted(function_name, "times", ts);
+  check_less(function_name, "initial time", t0, ts[0]);
+
+  check_positive_finite(function_name, "relative_tolerance",
+                        relative_tolerance);
+  check_positive_finite(function_name, "absolute_tolerance",
+                        absolute_tolerance);
+  check_positive(function_name, "max_num_steps", max_num_steps);
+
+  coupled_ode_system<F, T_y0_t0, T_Args...> coupled_system(f, y0, msgs,
+                                                            args...);
+  std::vector<double> coupled_state = coupled_system.initial_state();
+
+  internal::dopri5_stiffness_detector detector(y0.size());
+  long int num_rhs_evals = 0;  // NOLINT(runtime/int)
+  auto counted_system = [&](const std::vector<double>& z,
+                            std::vector<double>& dz_dt, double t) {
+    ++num_rhs_evals;
+    coupled_system(z, dz_dt, t);
+    detector.record(z, dz_dt, t);
+  };
+
+  auto stepper = make_dense_output(
+      absolute_tolerance, relative_tolerance,
+      runge_kutta_dopri5<std::vector<double>, double, std::vector<double>,
+                         double>());
+  const double step_size = 0.1;
+  stepper.initialize(coupled_state, value_of(t0), step_size);
+
+  long int num_steps = 0;  // NOLINT(runtime/int)
+  double last_step_size = 0;
+  auto write_stats = [&](const ode_stats* stiff_stats) {
+    if (stats == nullptr) {
+      return;
+    }
+    *stats = ode_stats();
+    stats->num_steps = num_steps;
+    // the Runge-Kutta steps evaluate the sensitivities as part of the
+    // coupled right hand side, see ode_rk45
+    stats->num_rhs_evals = num_rhs_evals;
+    stats->last_step_size = last_step_size;
+    if (stiff_stats != nullptr) {
+      stats->num_steps += stiff_stats->num_steps;
+      stats->num_rhs_evals += stiff_stats->num_rhs_evals;
+      stats->num_jacobian_evals = stiff_stats->num_jacobian_evals;
+      stats->num_linear_solver_setups = stiff_stats->num_linear_solver_setups;
+      stats->num_error_test_failures = stiff_stats->num_error_test_failures;
+      stats->num_nonlinear_solver_iterations
+          = stiff_stats->num_nonlinear_solver_iterations;
+      stats->num_nonlinear_solver_convergence_failures
+          = stiff_stats->num_nonlinear_solver_convergence_failures;
+      stats->num_sensitivity_rhs_evals
+          = stiff_stats->num_sensitivity_rhs_evals;
+      stats->num_method_switches = 1;
+      stats->last_step_size = stiff_stats->last_step_size;
+    }
+  };
+
+  std::vector<Eigen::Matrix<return_t, Eigen::Dynamic, 1>> y;
+  y.reserve(ts.size());
+  size_t n = 0;
+  bool is_stiff = false;
+  try {
+    long int num_steps_since_output = 0;  // NOLINT(runtime/int)
+    while (n < ts.size() && !is_stiff) {
+      if (stepper.current_time() < value_of(ts[n])) {
+        if (num_steps_since_output == max_num_steps) {
+          throw_domain_error(function_name, "", value_of(ts[n]),
+                             "Failed to integrate to next output time (",
+                             ") in less than max_num_steps steps");
+        }
+        stepper.do_step(counted_system);
+        ++num_steps;
+        ++num_steps_since_output;
+        last_step_size = stepper.current_time() - stepper.previous_time();
+        is_stiff = detector.update(last_step_size);
+      }
+      while (n < ts.size() && value_of(ts[n]) <= stepper.current_time()) {
+        stepper.calc_state(value_of(ts[n]), coupled_state);
+        y.emplace_back(ode_store_sensitivities(f, coupled_state, y0, t0,
+                                               ts[n], msgs, args...));
+        num_steps_since_output = 0;
+        ++n;
+      }
+    }
+  } catch (const std::exception& e) {
+    write_stats(nullptr);
+    throw;
+  }
+
+  if (n == ts.size()) {
+    write_stats(nullptr);
+    return y;
+  }
+
+  const std::vector<T_ts> ts_stiff(ts.begin() + n, ts.end());
+  cvodes_integrator<CV_BDF, F, T_y0, T_t0, T_ts, T_Args...> integrator(
+      function_name, f, y0_arg, t0, ts_stiff, relative_tolerance,
+      absolute_tolerance, max_num_steps, cvodes_linear_solver::dense(), msgs,
+      args...);
+  ode_stats stiff_stats;
+  std::vector<Eigen::Matrix<return_t, Eigen::Dynamic, 1>> y_stiff;
+  try {
+    y_stiff = integrator(stepper.current_time(), stepper.current_state(),
+                         &stiff_stats);
+  } catch (const std::exception& e) {
+    write_stats(&stiff_stats);
+    throw;
+  }
+  write_stats(&stiff_stats);
+
+  for (auto& y_n : y_stiff) {
+    y.emplace_back(std::move(y_n));
+  }
+  return y;
+}
+
+/**
+ * Solve the ODE initial value problem without counters. See
+ * ode_auto_tol_impl above.
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_auto_tol_impl(const char* function_name, const F& f,
+                  const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+                  const T_t0& t0, const std::vector<T_ts>& ts,
+                  double relative_tolerance, double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  std::ostream* msgs, const T_Args&... args) {
+  return ode_auto_tol_impl(function_name, f, y0, t0, ts, relative_tolerance,
+                           absolute_tolerance, max_num_steps,
+                           static_cast<ode_stats*>(nullptr), msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } with the non-stiff Runge-Kutta 45 solver in
+ * Boost until the ODE is detected to be stiff and with the stiff BDF
+ * solver from CVODES afterwards.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   greater than t0.
+ * @param relative_tolerance Relative tolerance passed to Boost and CVODES
+ * @param absolute_tolerance Absolute tolerance passed to Boost and CVODES
+ * @param max_num_steps Upper limit on the number of integration steps of
+ *   each method between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_auto_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+             const T_t0& t0, const std::vector<T_ts>& ts,
+             double relative_tolerance, double absolute_tolerance,
+             long int max_num_steps,  // NOLINT(runtime/int)
+             std::ostream* msgs, const T_Args&... args) {
+  return ode_auto_tol_impl("ode_auto_tol", f, y0, t0, ts, relative_tolerance,
+                           absolute_tolerance, max_num_steps, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } with the non-stiff Runge-Kutta 45 solver in
+ * Boost until the ODE is detected to be stiff and with the stiff BDF
+ * solver from CVODES afterwards, and write the counters of the solve to
+ * \p stats.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   greater than t0.
+ * @param relative_tolerance Relative tolerance passed to Boost and CVODES
+ * @param absolute_tolerance Absolute tolerance passed to Boost and CVODES
+ * @param max_num_steps Upper limit on the number of integration steps of
+ *   each method between each output (error if exceeded)
+ * @param[out] stats Counters of the solve
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_auto_tol(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+             const T_t0& t0, const std::vector<T_ts>& ts,
+             double relative_tolerance, double absolute_tolerance,
+             long int max_num_steps,  // NOLINT(runtime/int)
+             ode_stats& stats, std::ostream* msgs, const T_Args&... args) {
+  return ode_auto_tol_impl("ode_auto_tol", f, y0, t0, ts, relative_tolerance,
+                           absolute_tolerance, max_num_steps, &stats, msgs,
+                           args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } with the non-stiff Runge-Kutta 45 solver in
+ * Boost until the ODE is detected to be stiff and with the stiff BDF
+ * solver from CVODES afterwards, with defaults for relative_tolerance,
+ * absolute_tolerance, and max_num_steps.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   greater than t0.
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_auto(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+         const T_t0& t0, const std::vector<T_ts>& ts, std::ostream* msgs,
+         const T_Args&... args) {
+  double relative_tolerance = 1e-6;
+  double absolute_tolerance = 1e-6;
+  long int max_num_steps = 1e6;  // NOLINT(runtime/int)
+
+  return ode_auto_tol_impl("ode_auto", f, y0, t0, ts, relative_tolerance,
+                           absolute_tolerance, max_num_steps, msgs, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
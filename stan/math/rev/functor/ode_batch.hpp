@@ -0,0 +1,208 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ODE_BATCH_HPP
+#define STAN_MATH_REV_FUNCTOR_ODE_BATCH_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/chunk_tapes.hpp>
+#include <stan/math/prim/functor/apply.hpp>
+#include <stan/math/prim/functor/ode_batch.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Reverse mode solution of a batch of independent ODE systems.
+ *
+ * The systems are solved on chunk tapes (see chunk_tapes), each for
+ * copies of its operands. The solutions of all systems are inserted
+ * into the main AD tape together with this vari. During the reverse
+ * pass, the adjoints of the solutions are copied to the chunk tapes
+ * and a single reverse sweep per chunk computes the vector-Jacobian
+ * product with respect to the operand copies.
+ *
+ * @tparam Solve Type of functor solving a single system
+ * @tparam T_y0 Type of initial conditions
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of the arguments of a single system
+ */
+template <typename Solve, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+class ode_batch_vari : public vari_base {
+  template <typename T>
+  using local_t = std::decay_t<decltype(deep_copy_vars(std::declval<T>()))>;
+
+  using y0_t = Eigen::Matrix<T_y0, Eigen::Dynamic, 1>;
+  using ts_t = std::vector<T_ts>;
+  using inputs_t = std::tuple<local_t<const y0_t&>, local_t<const T_t0&>,
+                              local_t<const ts_t&>, local_t<const T_Args&>...>;
+
+  /**
+   * Local operands and solutions of the systems of a chunk.
+   */
+  struct chunk_locals {
+    std::vector<inputs_t> inputs_;
+    std::vector<std::vector<vector_v>> outputs_;
+  };
+
+  using chunk_tapes_t = chunk_tapes<chunk_locals>;
+  using chunk_tape = typename chunk_tapes_t::chunk_tape;
+
+ public:
+  ode_batch_vari(const Solve& solve, const std::vector<y0_t>& y0,
+                 const T_t0& t0, const std::vector<ts_t>& ts,
+                 const std::vector<T_Args>&... args)
+      : num_systems_(y0.size()),
+        output_offsets_(ChainableStack::instance_->memalloc_.alloc_array<int>(
+            num_systems_ + 1)),
+        operand_offsets_(ChainableStack::instance_->memalloc_.alloc_array<int>(
+            num_systems_ + 1)),
+        tapes_(new chunk_tapes_t()) {
+    tapes_->record(num_systems_, [&](chunk_locals& local, std::size_t start,
+                                     std::size_t end) {
+      local.inputs_.reserve(end - start);
+      local.outputs_.reserve(end - start);
+      for (std::size_t k = start; k != end; ++k) {
+        local.inputs_.emplace_back(deep_copy_vars(y0[k]), deep_copy_vars(t0),
+                                   deep_copy_vars(ts[k]),
+                                   deep_copy_vars(args[k])...);
+        local.outputs_.emplace_back(apply(solve, local.inputs_.back()));
+      }
+    });
+
+    output_offsets_[0] = 0;
+    operand_offsets_[0] = 0;
+    for (std::size_t k = 0; k != num_systems_; ++k) {
+      const std::vector<vector_v>& y_k = system_outputs(k);
+      const int num_states = y_k.empty() ? 0 : y_k[0].size();
+      output_offsets_[k + 1] = output_offsets_[k] + y_k.size() * num_states;
+      operand_offsets_[k + 1]
+          = operand_offsets_[k] + count_vars(y0[k], t0, ts[k], args[k]...);
+    }
+
+    outputs_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+        output_offsets_[num_systems_]);
+    for (std::size_t k = 0; k != num_systems_; ++k) {
+      vari** y_k_varis = outputs_ + output_offsets_[k];
+      for (const vector_v& y_kt : system_outputs(k)) {
+        for (int i = 0; i < y_kt.size(); ++i) {
+          *(y_k_varis++) = new vari(y_kt.coeff(i).val(), false);
+        }
+      }
+    }
+
+    operands_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+        operand_offsets_[num_systems_]);
+    for (std::size_t k = 0; k != num_systems_; ++k) {
+      save_varis(operands_ + operand_offsets_[k], y0[k], t0, ts[k], args[k]...);
+    }
+
+    ChainableStack::instance_->var_stack_.push_back(this);
+  }
+
+  /**
+   * Return the solutions of all systems as vars.
+   */
+  std::vector<std::vector<vector_v>> outputs() const {
+    std::vector<std::vector<vector_v>> ys(num_systems_);
+    for (std::size_t k = 0; k != num_systems_; ++k) {
+      const std::vector<vector_v>& y_k = system_outputs(k);
+      vari** y_k_varis = outputs_ + output_offsets_[k];
+      ys[k].reserve(y_k.size());
+      for (const vector_v& y_kt : y_k) {
+        vector_v y(y_kt.size());
+        for (int i = 0; i < y.size(); ++i) {
+          y.coeffRef(i) = var(*(y_k_varis++));
+        }
+        ys[k].emplace_back(std::move(y));
+      }
+    }
+    return ys;
+  }
+
+  void chain() final {
+    std::vector<double> adjoints(operand_offsets_[num_systems_], 0.0);
+
+    tapes_->reverse_sweep(
+        [&](chunk_tape& tape) {
+          for (std::size_t k = tape.start_; k != tape.end_; ++k) {
+            vari** y_k_varis = outputs_ + output_offsets_[k];
+            for (vector_v& y_kt : tape.local_.outputs_[k - tape.start_]) {
+              for (int i = 0; i < y_kt.size(); ++i) {
+                y_kt.coeffRef(i).vi_->adj_ += (*(y_k_varis++))->adj_;
+              }
+            }
+          }
+        },
+        [&](chunk_tape& tape) {
+          for (std::size_t k = tape.start_; k != tape.end_; ++k) {
+            double* dest = adjoints.data() + operand_offsets_[k];
+            apply([&](auto&&... inputs) {
+                    accumulate_adjoints(dest, inputs...);
+                  },
+                  tape.local_.inputs_[k - tape.start_]);
+          }
+        });
+
+    for (std::size_t j = 0; j != adjoints.size(); ++j) {
+      operands_[j]->adj_ += adjoints[j];
+    }
+  }
+
+  void set_zero_adjoint() final {}
+
+ private:
+  /**
+   * Return the solution of the k-th system on its chunk tape.
+   */
+  const std::vector<vector_v>& system_outputs(std::size_t k) const {
+    const chunk_tape& tape = tapes_->tape_of(k);
+    return tape.local_.outputs_[k - tape.start_];
+  }
+
+  const std::size_t num_systems_;
+  int* output_offsets_;
+  int* operand_offsets_;
+  chunk_tapes_t* tapes_;
+  vari** outputs_;
+  vari** operands_;
+};
+
+/**
+ * Solve a batch of independent ODE systems with vars using the adjoint
+ * method of ode_batch_vari.
+ *
+ * @tparam Solve Type of functor solving a single system
+ * @param solve Functor solving a single system given its initial
+ *   state, the initial time, its output times and its arguments
+ * @param y0 Initial state of each system
+ * @param t0 Initial time of all systems
+ * @param ts Output times of each system
+ * @param args Arguments of each system
+ * @return Solution of each system at its output times
+ */
+template <typename Solve, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+ode_batch_return_t<T_y0, T_t0, T_ts, T_Args...> ode_batch_impl(
+    std::true_type /* is_var */, const Solve& solve,
+    const std::vector<Eigen::Matrix<T_y0, Eigen::Dynamic, 1>>& y0,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& ts,
+    const std::vector<T_Args>&... args) {
+  auto* vi = new ode_batch_vari<Solve, T_y0, T_t0, T_ts, T_Args...>(
+      solve, y0, t0, ts, args...);
+  return vi->outputs();
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+
+#endif
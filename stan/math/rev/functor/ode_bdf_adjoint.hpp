@@ -0,0 +1,169 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ODE_BDF_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_ODE_BDF_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/functor/cvodes_integrator_adjoint.hpp>
+#include <stan/math/rev/functor/ode_bdf.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * Solve the ODE without any vars. There are no gradients to propagate
+ * such that the forward solver is used.
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_adjoint_tol_impl(std::false_type /* is_var */,
+                         const char* function_name, const F& f,
+                         const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+                         const T_t0& t0, const std::vector<T_ts>& ts,
+                         double relative_tolerance, double absolute_tolerance,
+                         long int max_num_steps,  // NOLINT(runtime/int)
+                         long int num_steps_between_checkpoints,  // NOLINT
+                         std::ostream* msgs, const T_Args&... args) {
+  check_positive(function_name, "num_steps_between_checkpoints",
+                 num_steps_between_checkpoints);
+  return ode_bdf_tol_impl(function_name, f, y0, t0, ts, relative_tolerance,
+                          absolute_tolerance, max_num_steps, msgs, args...);
+}
+
+/**
+ * Solve the ODE with vars and propagate the gradients with the adjoint
+ * method of cvodes_integrator_adjoint_vari.
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ode_bdf_adjoint_tol_impl(
+    std::true_type /* is_var */, const char* function_name, const F& f,
+    const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0, const T_t0& t0,
+    const std::vector<T_ts>& ts, double relative_tolerance,
+    double absolute_tolerance,
+    long int max_num_steps,                  // NOLINT(runtime/int)
+    long int num_steps_between_checkpoints,  // NOLINT(runtime/int)
+    std::ostream* msgs, const T_Args&... args) {
+  auto* integrator
+      = new cvodes_integrator_adjoint_vari<CV_BDF, F, T_y0, T_t0, T_ts,
+                                           T_Args...>(
+          function_name, f, y0, t0, ts, relative_tolerance,
+          absolute_tolerance, max_num_steps, num_steps_between_checkpoints,
+          msgs, args...);
+  return integrator->solution();
+}
+
+}  // namespace internal
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
+ * BDF solver from CVODES. The gradients are computed with the adjoint
+ * method, which integrates the adjoint ODE backwards in time during the
+ * reverse pass instead of integrating the forward sensitivities along
+ * with the ODE. The cost of the gradient is then about two solves of
+ * the ODE regardless of the number of parameters, which is preferable
+ * to ode_bdf_tol whenever there are many parameters compared to the
+ * number of states.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification). \p f is
+ * copied, since it is needed again during the reverse pass.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES for the
+ *   forward and the backward problem
+ * @param absolute_tolerance Absolute tolerance passed to CVODES for the
+ *   forward and the backward problem
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param num_steps_between_checkpoints Number of integration steps
+ *   between two checkpoints of the forward solution. Fewer steps use
+ *   more memory but require less recomputation of the forward solution
+ *   during the reverse pass.
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_adjoint_tol(const F& f,
+                    const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+                    const T_t0& t0, const std::vector<T_ts>& ts,
+                    double relative_tolerance, double absolute_tolerance,
+                    long int max_num_steps,  // NOLINT(runtime/int)
+                    long int num_steps_between_checkpoints,  // NOLINT
+                    std::ostream* msgs, const T_Args&... args) {
+  return internal::ode_bdf_adjoint_tol_impl(
+      is_var<return_type_t<T_y0, T_t0, T_ts, T_Args...>>(),
+      "ode_bdf_adjoint_tol", f, y0, t0, ts, relative_tolerance,
+      absolute_tolerance, max_num_steps, num_steps_between_checkpoints, msgs,
+      args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
+ * (BDF) solver in CVODES and the adjoint method for the gradients with
+ * defaults for relative_tolerance, absolute_tolerance, max_num_steps and
+ * num_steps_between_checkpoints. See ode_bdf_adjoint_tol.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_adjoint(const F& f, const Eigen::Matrix<T_y0, Eigen::Dynamic, 1>& y0,
+                const T_t0& t0, const std::vector<T_ts>& ts,
+                std::ostream* msgs, const T_Args&... args) {
+  double relative_tolerance = 1e-10;
+  double absolute_tolerance = 1e-10;
+  long int max_num_steps = 1e8;                   // NOLINT(runtime/int)
+  long int num_steps_between_checkpoints = 150;  // NOLINT(runtime/int)
+
+  return internal::ode_bdf_adjoint_tol_impl(
+      is_var<return_type_t<T_y0, T_t0, T_ts, T_Args...>>(), "ode_bdf_adjoint",
+      f, y0, t0, ts, relative_tolerance, absolute_tolerance, max_num_steps,
+      num_steps_between_checkpoints, msgs, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -7,8 +7,11 @@
 #include <tbb/task_arena.h>
 #include <tbb/parallel_reduce.h>
 #include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
 
+#include <memory>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -27,6 +30,40 @@ template <typename ReduceFunction, typename ReturnType, typename Vec,
           typename... Args>
 struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
                        Vec, Args...> {
+  /**
+   * Type of the tuple holding the nested autodiff copies of the shared
+   *  arguments. Arguments without vars are held by const reference.
+   */
+  using local_args_tuple_t = std::tuple<decltype(
+      deep_copy_vars(std::declval<const std::decay_t<Args>&>()))...>;
+
+  /**
+   * Copies of the shared arguments which are created at most once per
+   *  thread (or per reducer for the deterministic partitioning) and call
+   *  of reduce_sum. The varis of the copies are allocated on a separate
+   *  AD tape owned by this struct such that they outlive the nested
+   *  autodiff scopes of the individual chunks. The adjoints of the
+   *  copies accumulate over all chunks executed with the same copies.
+   */
+  struct local_shared_args {
+    ScopedChainableStack stack_;
+    local_args_tuple_t args_tuple_;
+
+    template <typename ArgsTuple>
+    explicit local_shared_args(const ArgsTuple& args_tuple)
+        : stack_(), args_tuple_(stack_.execute([&] {
+            return apply(
+                [](auto&&... args) {
+                  return local_args_tuple_t(deep_copy_vars(args)...);
+                },
+                args_tuple);
+          })) {}
+  };
+
+  using local_shared_args_ptr = std::unique_ptr<local_shared_args>;
+  using thread_local_shared_args
+      = tbb::enumerable_thread_specific<local_shared_args_ptr>;
+
   /**
    * This struct is used by the TBB to accumulate partial
    *  sums over consecutive ranges of the input. To distribute the workload,
@@ -34,34 +71,46 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
    *  case the splitting copy constructor is used. It is designed to
    *  meet the Imperative form requirements of `tbb::parallel_reduce`.
    *
+   * The sliced and shared arguments are held by reference such that
+   *  splitting a reducer does not copy any of them.
+   *
+   * The copies of the shared arguments are kept per thread if local_args_
+   *  is given. Otherwise each reducer creates its own copies and the
+   *  adjoints of these are summed up along with the partial sums in
+   *  join, which keeps the order of the accumulation fixed for a fixed
+   *  partitioning of the work.
+   *
    * @note see link [here](https://tinyurl.com/vp7xw2t) for requirements.
    */
   struct recursive_reducer {
     const size_t num_vars_per_term_;
     const size_t num_vars_shared_terms_;  // Number of vars in shared arguments
     double* sliced_partials_;  // Points to adjoints of the partial calculations
-    Vec vmapped_;
+    const std::decay_t<Vec>& vmapped_;
     std::ostream* msgs_;
-    std::tuple<Args...> args_tuple_;
+    std::tuple<const std::decay_t<Args>&...> args_tuple_;
+    thread_local_shared_args* local_args_;
+    local_shared_args_ptr own_args_;
+    std::vector<double> shared_adjoints_;
     double sum_{0.0};
-    Eigen::VectorXd args_adjoints_{0};
 
-    template <typename VecT, typename... ArgsT>
     recursive_reducer(size_t num_vars_per_term, size_t num_vars_shared_terms,
-                      double* sliced_partials, VecT&& vmapped,
-                      std::ostream* msgs, ArgsT&&... args)
+                      double* sliced_partials, const std::decay_t<Vec>& vmapped,
+                      std::ostream* msgs, thread_local_shared_args* local_args,
+                      const std::decay_t<Args>&... args)
         : num_vars_per_term_(num_vars_per_term),
           num_vars_shared_terms_(num_vars_shared_terms),
           sliced_partials_(sliced_partials),
-          vmapped_(std::forward<VecT>(vmapped)),
+          vmapped_(vmapped),
           msgs_(msgs),
-          args_tuple_(std::forward<ArgsT>(args)...) {}
+          args_tuple_(args...),
+          local_args_(local_args) {}
 
     /*
      * This is the copy operator as required for tbb::parallel_reduce
-     *   Imperative form. This requires sum_ and arg_adjoints_ be reset
-     *   to zero since the newly created reducer is used to accumulate
-     *   an independent partial sum.
+     *   Imperative form. This requires sum_ be reset to zero since the
+     *   newly created reducer is used to accumulate an independent
+     *   partial sum.
      */
     recursive_reducer(recursive_reducer& other, tbb::split)
         : num_vars_per_term_(other.num_vars_per_term_),
@@ -69,18 +118,23 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
           sliced_partials_(other.sliced_partials_),
           vmapped_(other.vmapped_),
           msgs_(other.msgs_),
-          args_tuple_(other.args_tuple_) {}
+          args_tuple_(other.args_tuple_),
+          local_args_(other.local_args_) {}
 
     /**
      * Compute, using nested autodiff, the value and Jacobian of
      *  `ReduceFunction` called over the range defined by r and accumulate those
-     *  in member variable sum_ (for the value) and args_adjoints_ (for the
-     *  Jacobian). The nested autodiff uses deep copies of the involved operands
+     *  in member variable sum_ (for the value) and in the adjoints of the
+     *  thread local copies of the shared arguments (for the Jacobian). The
+     *  nested autodiff uses deep copies of the involved operands
      *  ensuring that no side effects are implied to the adjoints of the input
      *  operands which reside potentially on a autodiff tape stored in a
-     *  different thread other than the current thread of execution. This
-     * function may be called multiple times per object instantiation (so the
-     * sum_ and args_adjoints_ must be accumulated, not just assigned).
+     *  different thread other than the current thread of execution. The
+     *  copies of the shared arguments are made once per thread and reused
+     *  by all chunks the thread executes, while arguments without vars are
+     *  not copied at all. This function may be called multiple times per
+     *  object instantiation (so the sum_ must be accumulated, not just
+     *  assigned).
      *
      * @param r Range over which to compute reduce_sum
      */
@@ -89,10 +143,6 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
         return;
       }
 
-      if (args_adjoints_.size() == 0) {
-        args_adjoints_ = Eigen::VectorXd::Zero(num_vars_shared_terms_);
-      }
-
       // Initialize nested autodiff stack
       const nested_rev_autodiff begin_nest;
 
@@ -104,22 +154,29 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
         local_sub_slice.emplace_back(deep_copy_vars(vmapped_[i]));
       }
 
-      // Create nested autodiff copies of all shared arguments that do not point
-      //   back to main autodiff stack
-      auto args_tuple_local_copy = apply(
-          [&](auto&&... args) {
-            return std::tuple<decltype(deep_copy_vars(args))...>(
-                deep_copy_vars(args)...);
-          },
-          args_tuple_);
+      auto compute_sub_sum = [&](auto&& args_tuple) {
+        return apply(
+            [&](auto&&... args) {
+              return ReduceFunction()(local_sub_slice, r.begin(), r.end() - 1,
+                                      msgs_, args...);
+            },
+            args_tuple);
+      };
 
-      // Perform calculation
-      var sub_sum_v = apply(
-          [&](auto&&... args) {
-            return ReduceFunction()(local_sub_slice, r.begin(), r.end() - 1,
-                                    msgs_, args...);
-          },
-          args_tuple_local_copy);
+      // Perform calculation. Shared arguments without vars are passed on
+      //   as they are, otherwise the thread local (or reducer) copies are
+      //   used which are created by the first chunk executed with them.
+      var sub_sum_v;
+      if (num_vars_shared_terms_ == 0) {
+        sub_sum_v = compute_sub_sum(args_tuple_);
+      } else {
+        local_shared_args_ptr& local_args
+            = local_args_ ? local_args_->local() : own_args_;
+        if (!local_args) {
+          local_args = std::make_unique<local_shared_args>(args_tuple_);
+        }
+        sub_sum_v = compute_sub_sum(local_args->args_tuple_);
+      }
 
       // Compute Jacobian
       sub_sum_v.grad();
@@ -130,28 +187,43 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
       // Accumulate adjoints of sliced_arguments
       accumulate_adjoints(sliced_partials_ + r.begin() * num_vars_per_term_,
                           std::move(local_sub_slice));
+    }
 
-      // Accumulate adjoints of shared_arguments
+    /**
+     * Adds the adjoints of the copies of the shared arguments owned by
+     *  this reducer to shared_adjoints_ and releases the copies.
+     */
+    inline void collect_shared_adjoints() {
+      if (!own_args_) {
+        return;
+      }
+      if (shared_adjoints_.empty()) {
+        shared_adjoints_.resize(num_vars_shared_terms_, 0.0);
+      }
       apply(
           [&](auto&&... args) {
-            accumulate_adjoints(args_adjoints_.data(),
-                                std::forward<decltype(args)>(args)...);
+            accumulate_adjoints(shared_adjoints_.data(), args...);
           },
-          std::move(args_tuple_local_copy));
+          own_args_->args_tuple_);
+      own_args_.reset();
     }
 
     /**
-     * Join reducers. Accumuluate the value (sum_) and Jacobian (arg_adoints_)
-     *   of the other reducer.
+     * Join reducers. Accumuluate the value (sum_) of the other reducer
+     *  and the adjoints of the shared arguments owned by the reducers.
      *
      * @param rhs Another partial sum
      */
-    inline void join(const recursive_reducer& rhs) {
+    inline void join(recursive_reducer& rhs) {
       sum_ += rhs.sum_;
-      if (args_adjoints_.size() != 0 && rhs.args_adjoints_.size() != 0) {
-        args_adjoints_ += rhs.args_adjoints_;
-      } else if (args_adjoints_.size() == 0 && rhs.args_adjoints_.size() != 0) {
-        args_adjoints_ = rhs.args_adjoints_;
+      collect_shared_adjoints();
+      rhs.collect_shared_adjoints();
+      if (shared_adjoints_.empty()) {
+        shared_adjoints_ = std::move(rhs.shared_adjoints_);
+      } else {
+        for (size_t i = 0; i < rhs.shared_adjoints_.size(); ++i) {
+          shared_adjoints_[i] += rhs.shared_adjoints_[i];
+        }
       }
     }
   };
@@ -189,6 +261,12 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
    *  than or equal to grainsize and accumulate all the partial sums
    *  in the same order. This still may not achieve bitwise reproducibility.
    *
+   * With auto partitioning the copies of the shared arguments are made
+   *  once per thread, such that the adjoints of the shared arguments are
+   *  accumulated in an order which depends on the scheduling. Otherwise
+   *  the copies are made per reducer and their adjoints are accumulated
+   *  along with the partial sums.
+   *
    * @param vmapped Vector containing one element per term of sum
    * @param auto_partitioning Work partitioning style
    * @param grainsize Suggested grainsize for tbb
@@ -220,9 +298,15 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
       partials[i] = 0.0;
     }
 
+    for (size_t i = 0; i < num_vars_shared_terms; ++i) {
+      partials[num_vars_sliced_terms + i] = 0.0;
+    }
+
+    thread_local_shared_args local_args;
     recursive_reducer worker(num_vars_per_term, num_vars_shared_terms, partials,
-                             std::forward<Vec>(vmapped), msgs,
-                             std::forward<Args>(args)...);
+                             vmapped, msgs,
+                             auto_partitioning ? &local_args : nullptr,
+                             args...);
 
     if (auto_partitioning) {
       tbb::parallel_reduce(
@@ -234,8 +318,21 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
           partitioner);
     }
 
-    for (size_t i = 0; i < num_vars_shared_terms; ++i) {
-      partials[num_vars_sliced_terms + i] = worker.args_adjoints_(i);
+    // Accumulate adjoints of the thread local copies of shared_arguments
+    for (const local_shared_args_ptr& local_args_ptr : local_args) {
+      if (local_args_ptr) {
+        apply(
+            [&](auto&&... args) {
+              accumulate_adjoints(partials + num_vars_sliced_terms, args...);
+            },
+            local_args_ptr->args_tuple_);
+      }
+    }
+
+    // Accumulate adjoints of the copies owned by the reducers
+    worker.collect_shared_adjoints();
+    for (size_t i = 0; i < worker.shared_adjoints_.size(); ++i) {
+      partials[num_vars_sliced_terms + i] += worker.shared_adjoints_[i];
     }
 
     return var(new precomputed_gradients_vari(
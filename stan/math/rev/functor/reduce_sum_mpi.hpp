@@ -0,0 +1,509 @@
+#ifndef STAN_MATH_REV_FUNCTOR_REDUCE_SUM_MPI_HPP
+#define STAN_MATH_REV_FUNCTOR_REDUCE_SUM_MPI_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/reduce_sum.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/functor/apply.hpp>
+#include <stan/math/prim/functor/reduce_sum.hpp>
+
+#ifdef STAN_MPI
+#include <stan/math/prim/functor/mpi_cluster.hpp>
+#include <stan/math/prim/functor/mpi_distributed_apply.hpp>
+#endif
+
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+#ifdef STAN_MPI
+
+namespace internal {
+
+/**
+ * Append the values of the argument to a buffer of doubles. The
+ * shapes of containers are stored in front of their elements such
+ * that the argument can be restored with mpi_unpack.
+ *
+ * @param[in, out] buffer buffer to append to
+ * @param x argument
+ */
+inline void mpi_pack(std::vector<double>& buffer, double x) {
+  buffer.push_back(x);
+}
+
+inline void mpi_pack(std::vector<double>& buffer, const var& x) {
+  buffer.push_back(x.val());
+}
+
+template <typename T, require_eigen_t<T>* = nullptr>
+inline void mpi_pack(std::vector<double>& buffer, const T& x) {
+  buffer.push_back(x.rows());
+  buffer.push_back(x.cols());
+  for (Eigen::Index i = 0; i < x.size(); ++i) {
+    mpi_pack(buffer, x.coeff(i));
+  }
+}
+
+template <typename T>
+inline void mpi_pack(std::vector<double>& buffer, const std::vector<T>& x) {
+  buffer.push_back(x.size());
+  for (const auto& x_i : x) {
+    mpi_pack(buffer, x_i);
+  }
+}
+
+/**
+ * Restore an argument from a buffer filled by mpi_pack. Values
+ * restored into vars create new vars on the current AD tape.
+ *
+ * @param buffer buffer to read from
+ * @param[in, out] pos position of the next value in the buffer
+ * @param[out] x argument
+ */
+inline void mpi_unpack(const std::vector<double>& buffer, std::size_t& pos,
+                       double& x) {
+  x = buffer[pos++];
+}
+
+inline void mpi_unpack(const std::vector<double>& buffer, std::size_t& pos,
+                       int& x) {
+  x = static_cast<int>(buffer[pos++]);
+}
+
+inline void mpi_unpack(const std::vector<double>& buffer, std::size_t& pos,
+                       var& x) {
+  x = var(buffer[pos++]);
+}
+
+template <typename T, require_eigen_t<T>* = nullptr>
+inline void mpi_unpack(const std::vector<double>& buffer, std::size_t& pos,
+                       T& x) {
+  const Eigen::Index rows = buffer[pos++];
+  const Eigen::Index cols = buffer[pos++];
+  x.resize(rows, cols);
+  for (Eigen::Index i = 0; i < x.size(); ++i) {
+    mpi_unpack(buffer, pos, x.coeffRef(i));
+  }
+}
+
+template <typename T>
+inline void mpi_unpack(const std::vector<double>& buffer, std::size_t& pos,
+                       std::vector<T>& x) {
+  x.resize(buffer[pos++]);
+  for (auto& x_i : x) {
+    mpi_unpack(buffer, pos, x_i);
+  }
+}
+
+/**
+ * Distributed evaluation of reduce_sum over the MPI cluster.
+ *
+ * The terms of the sliced argument are split into consecutive
+ * ranges, one per process (see mpi_map_chunks). On the first call
+ * the root scatters the sliced argument and broadcasts the shared
+ * arguments which do not contain vars (data only arguments). These
+ * are cached on all processes for the given call_id and are never
+ * transferred again. Every call then only broadcasts the values of
+ * the shared arguments which contain vars. Each process evaluates
+ * `ReduceFunction` over its range of terms in a nested autodiff
+ * scope and the partial sums together with the adjoints of the
+ * shared arguments are summed up on the root. The root finally
+ * inserts the sum into its AD tape with the precomputed gradients.
+ *
+ * The sliced argument must be data only. As with map_rect, the data
+ * only arguments of a given call_id must not change between calls.
+ *
+ * @tparam call_id label for the cached data
+ * @tparam ReduceFunction Type of reducer function
+ * @tparam Vec Type of sliced argument
+ * @tparam Args Types of shared arguments
+ */
+template <int call_id, typename ReduceFunction, typename Vec,
+          typename... Args>
+class mpi_reduce_sum_call {
+  static_assert(is_constant<Vec>::value,
+                "reduce_sum_mpi requires a data only sliced argument.");
+
+  using args_tuple_t = std::tuple<Args...>;
+  using return_type = return_type_t<Vec, Args...>;
+  using args_index_t = std::index_sequence_for<Args...>;
+
+  // cached local range of the sliced argument and the local copies
+  // of the shared arguments
+  static bool& is_cached() {
+    static bool cached = false;
+    return cached;
+  }
+
+  static std::size_t& num_terms() {
+    static std::size_t terms = 0;
+    return terms;
+  }
+
+  static std::size_t& local_start() {
+    static std::size_t start = 0;
+    return start;
+  }
+
+  static Vec& local_slice() {
+    static Vec slice;
+    return slice;
+  }
+
+  static args_tuple_t& local_args() {
+    static args_tuple_t args;
+    return args;
+  }
+
+  template <typename T>
+  static void pack_if(std::true_type, std::vector<double>& buffer,
+                      const T& x) {
+    mpi_pack(buffer, x);
+  }
+
+  template <typename T>
+  static void pack_if(std::false_type, std::vector<double>& buffer,
+                      const T& x) {}
+
+  template <typename T>
+  static void unpack_if(std::true_type, const std::vector<double>& buffer,
+                        std::size_t& pos, T& x) {
+    mpi_unpack(buffer, pos, x);
+  }
+
+  template <typename T>
+  static void unpack_if(std::false_type, const std::vector<double>& buffer,
+                        std::size_t& pos, T& x) {}
+
+  /**
+   * Restore the data only (or all others) shared arguments from the
+   * buffer into the local copies of the shared arguments.
+   */
+  template <bool data_only, std::size_t... I>
+  static void unpack_args(const std::vector<double>& buffer,
+                          std::index_sequence<I...>) {
+    std::size_t pos = 0;
+    static_cast<void>(std::initializer_list<int>{
+        (unpack_if(bool_constant<data_only
+                                 == is_constant<std::tuple_element_t<
+                                     I, args_tuple_t>>::value>(),
+                   buffer, pos, std::get<I>(local_args())),
+         0)...});
+  }
+
+  /**
+   * Broadcast a buffer of doubles from the root to all processes.
+   */
+  static void broadcast_buffer(const boost::mpi::communicator& world,
+                               std::vector<double>& buffer) {
+    std::size_t buffer_size = buffer.size();
+    boost::mpi::broadcast(world, buffer_size, 0);
+    buffer.resize(buffer_size);
+    boost::mpi::broadcast(world, buffer.data(), buffer_size, 0);
+  }
+
+  /**
+   * Distribute and cache the sliced argument and the data only
+   * shared arguments. Must be called on all processes during the
+   * first call. The arguments are only read on the root.
+   */
+  static void cache_data(const boost::mpi::communicator& world,
+                         const Vec* vmapped, const Args*... args) {
+    const std::size_t rank = world.rank();
+    const std::size_t world_size = world.size();
+
+    std::size_t terms = rank == 0 ? vmapped->size() : 0;
+    boost::mpi::broadcast(world, terms, 0);
+    const std::vector<int> chunks = mpi_map_chunks(terms, 1);
+
+    std::vector<double> slice_buffer;
+    std::vector<int> buffer_sizes(world_size, 0);
+    if (rank == 0) {
+      for (std::size_t r = 0, i = 0; r != world_size; ++r) {
+        const std::size_t buffer_start = slice_buffer.size();
+        for (int j = 0; j != chunks[r]; ++j, ++i) {
+          mpi_pack(slice_buffer, (*vmapped)[i]);
+        }
+        buffer_sizes[r] = slice_buffer.size() - buffer_start;
+      }
+    }
+    boost::mpi::broadcast(world, buffer_sizes.data(), world_size, 0);
+
+    std::vector<double> local_buffer(buffer_sizes[rank]);
+    if (rank == 0) {
+      boost::mpi::scatterv(world, slice_buffer.data(), buffer_sizes,
+                           local_buffer.data(), 0);
+    } else {
+      boost::mpi::scatterv(world, local_buffer.data(), buffer_sizes[rank],
+                           0);
+    }
+
+    Vec& slice = local_slice();
+    slice.resize(chunks[rank]);
+    std::size_t pos = 0;
+    for (auto& term : slice) {
+      mpi_unpack(local_buffer, pos, term);
+    }
+
+    std::vector<double> data_buffer;
+    if (rank == 0) {
+      static_cast<void>(std::initializer_list<int>{
+          (pack_if(bool_constant<is_constant<Args>::value>(), data_buffer,
+                   *args),
+           0)...});
+    }
+    broadcast_buffer(world, data_buffer);
+    unpack_args<true>(data_buffer, args_index_t());
+
+    num_terms() = terms;
+    local_start() = std::accumulate(chunks.begin(), chunks.begin() + rank, 0);
+    is_cached() = true;
+  }
+
+  /**
+   * Evaluate the local range of terms for the given values of the
+   * shared arguments containing vars and sum the results over the
+   * cluster on the root. Must be called on all processes.
+   *
+   * @return the number of successful processes, the sum and the
+   * adjoints of the shared arguments (only valid on the root)
+   */
+  static std::vector<double> evaluate_local(
+      const boost::mpi::communicator& world, std::vector<double>& params,
+      std::ostream* msgs) {
+    broadcast_buffer(world, params);
+
+    std::vector<double> local_result;
+    {
+      nested_rev_autodiff nested;
+      unpack_args<false>(params, args_index_t());
+
+      const std::size_t num_vars = apply(
+          [](auto&&... args) { return count_vars(args...); }, local_args());
+      local_result.resize(2 + num_vars, 0.0);
+      local_result[0] = 1.0;
+
+      const Vec& slice = local_slice();
+      if (!slice.empty()) {
+        try {
+          return_type sum = apply(
+              [&](auto&&... args) {
+                return ReduceFunction()(slice, local_start(),
+                                        local_start() + slice.size() - 1,
+                                        msgs, args...);
+              },
+              local_args());
+          local_result[1] = value_of(sum);
+          accumulate_gradient(sum, local_result.data() + 2);
+        } catch (const std::exception& e) {
+          // keep the cluster synchronized and flag the failure
+          local_result[0] = 0.0;
+        }
+      }
+    }
+
+    std::vector<double> result(local_result.size(), 0.0);
+    boost::mpi::reduce(world, local_result.data(), local_result.size(),
+                       result.data(), std::plus<double>(), 0);
+    return result;
+  }
+
+  static void accumulate_gradient(double sum, double* adjoints) {}
+
+  static void accumulate_gradient(var& sum, double* adjoints) {
+    sum.grad();
+    apply(
+        [&](auto&&... args) {
+          accumulate_adjoints(adjoints, std::forward<decltype(args)>(args)...);
+        },
+        local_args());
+  }
+
+  static double make_result(std::false_type,
+                            const std::vector<double>& result,
+                            const Args&... args) {
+    return result[1];
+  }
+
+  static var make_result(std::true_type, const std::vector<double>& result,
+                         const Args&... args) {
+    std::vector<vari*> varis(count_vars(args...));
+    save_varis(varis.data(), args...);
+    std::vector<var> operands(varis.begin(), varis.end());
+    std::vector<double> gradients(result.begin() + 2, result.end());
+    return precomputed_gradients(result[1], operands, gradients);
+  }
+
+ public:
+  /**
+   * Entry point on the root. Acquires the MPI cluster, instructs the
+   * workers to take part and evaluates the sum.
+   *
+   * @param vmapped Sliced arguments
+   * @param[in, out] msgs The print stream for warning messages
+   * @param args Shared arguments
+   * @return Sum of terms
+   * @throw mpi_is_in_use if the MPI cluster is busy
+   * @throw std::invalid_argument if the number of terms differs from
+   * the cached number of terms
+   * @throw std::domain_error if the evaluation failed on any process
+   */
+  static return_type evaluate(const Vec& vmapped, std::ostream* msgs,
+                              const Args&... args) {
+    boost::mpi::communicator world;
+    if (world.rank() != 0)
+      throw std::runtime_error(
+          "problem sizes may only be defined on the root.");
+
+    if (is_cached()) {
+      check_size_match("reduce_sum_mpi", "cached number of terms",
+                       num_terms(), "number of terms", vmapped.size());
+    }
+
+    std::unique_lock<std::mutex> cluster_lock
+        = mpi_broadcast_command<mpi_distributed_apply<mpi_reduce_sum_call>>();
+
+    bool cached = is_cached();
+    boost::mpi::broadcast(world, cached, 0);
+    if (!cached) {
+      cache_data(world, &vmapped, &args...);
+    }
+
+    std::vector<double> params;
+    static_cast<void>(std::initializer_list<int>{
+        (pack_if(bool_constant<!is_constant<Args>::value>(), params, args),
+         0)...});
+    const std::vector<double> result = evaluate_local(world, params, msgs);
+
+    if (result[0] != world.size())
+      throw std::domain_error("Error during MPI evaluation.");
+
+    return make_result(is_var<return_type>(), result, args...);
+  }
+
+  /**
+   * Entry point on the workers.
+   */
+  static void distributed_apply() {
+    boost::mpi::communicator world;
+    if (world.rank() == 0)
+      throw std::runtime_error("problem sizes must be defined on the root.");
+
+    bool cached = false;
+    boost::mpi::broadcast(world, cached, 0);
+    if (!cached) {
+      cache_data(world, nullptr, static_cast<const Args*>(nullptr)...);
+    }
+
+    std::vector<double> params;
+    evaluate_local(world, params, nullptr);
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Call an instance of the function `ReduceFunction` on every element
+ *   of an input sequence and sum these terms, distributing the terms
+ *   over the processes of the MPI cluster.
+ *
+ * ReduceFunction must define an operator() with the same signature as:
+ *   T f(Vec&& vmapped_subset, int start, int end, std::ostream* msgs, Args&&...
+ * args)
+ *
+ * `ReduceFunction` must be default constructible without any arguments
+ *
+ * The sliced argument must be data only. It is scattered over the
+ *   cluster on the first call and is cached together with all shared
+ *   arguments which do not contain vars. These must therefore not
+ *   change between calls with the same `call_id`. Every call only
+ *   transfers the values of the shared arguments with vars. See
+ *   `internal::mpi_reduce_sum_call` for details.
+ *
+ * Each combination of `call_id`, `ReduceFunction` and argument types
+ *   must be registered with STAN_REGISTER_MPI_REDUCE_SUM. Whenever the
+ *   cluster is busy (for example for nested calls), the sum is
+ *   evaluated with `reduce_sum` instead. If STAN_MPI is not defined,
+ *   `reduce_sum` is used always.
+ *
+ * @tparam call_id label for the cached data
+ * @tparam ReduceFunction Type of reducer function
+ * @tparam Vec Type of sliced argument
+ * @tparam Args Types of shared arguments
+ * @param vmapped Sliced arguments used only in some sum terms
+ * @param[in, out] msgs The print stream for warning messages
+ * @param args Shared arguments used in every sum term
+ * @return Sum of terms
+ */
+template <int call_id, typename ReduceFunction, typename Vec,
+          typename = require_vector_like_t<Vec>, typename... Args>
+inline auto reduce_sum_mpi(const Vec& vmapped, std::ostream* msgs,
+                           const Args&... args) {
+  using return_type = return_type_t<Vec, Args...>;
+  using call_t = internal::mpi_reduce_sum_call<call_id, ReduceFunction,
+                                               plain_type_t<Vec>,
+                                               plain_type_t<Args>...>;
+
+  if (vmapped.empty()) {
+    return return_type(0);
+  }
+
+  try {
+    return call_t::evaluate(vmapped, msgs, args...);
+  } catch (const mpi_is_in_use& e) {
+    return reduce_sum<ReduceFunction>(vmapped, 1, msgs, args...);
+  }
+}
+
+#else
+
+template <int call_id, typename ReduceFunction, typename Vec,
+          typename = require_vector_like_t<Vec>, typename... Args>
+inline auto reduce_sum_mpi(const Vec& vmapped, std::ostream* msgs,
+                           const Args&... args) {
+  return reduce_sum<ReduceFunction>(vmapped, 1, msgs, args...);
+}
+
+#endif
+
+}  // namespace math
+}  // namespace stan
+
+#ifdef STAN_MPI
+
+/**
+ * Register a reduce_sum_mpi call. The variadic arguments are the
+ * plain types of the sliced argument followed by the plain types of
+ * all shared arguments. Must be called in the root namespace.
+ */
+#define STAN_REGISTER_MPI_REDUCE_SUM(CALLID, FUNCTOR, ...)               \
+  namespace stan {                                                       \
+  namespace math {                                                       \
+  namespace internal {                                                   \
+  typedef mpi_reduce_sum_call<CALLID, FUNCTOR, __VA_ARGS__>              \
+      mpi_rs_##CALLID##_;                                                \
+  }                                                                      \
+  }                                                                      \
+  }                                                                      \
+  STAN_REGISTER_MPI_DISTRIBUTED_APPLY(                                   \
+      stan::math::internal::mpi_rs_##CALLID##_)
+
+#else
+
+#define STAN_REGISTER_MPI_REDUCE_SUM(CALLID, FUNCTOR, ...)
+
+#endif
+
+#endif
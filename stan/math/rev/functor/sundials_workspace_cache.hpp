@@ -0,0 +1,106 @@
+#ifndef STAN_MATH_REV_FUNCTOR_SUNDIALS_WORKSPACE_CACHE_HPP
+#define STAN_MATH_REV_FUNCTOR_SUNDIALS_WORKSPACE_CACHE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Cache of idle SUNDIALS workspaces such as the solver memory, the
+ * N_Vectors and the linear solver of an integrator. Creating and
+ * initializing these allocates on every solve, while a cached
+ * workspace only needs to be re-initialized for the next problem of
+ * the same size.
+ *
+ * A workspace is taken out of the cache while it is in use such that
+ * nested solves, for example a DAE solved within an ODE right hand
+ * side, never share a workspace. Workspaces are only returned to the
+ * cache after a successful solve; a workspace whose solve threw is
+ * freed, since its solver state is unknown. Whenever STAN_THREADS is
+ * defined every thread has its own cache.
+ *
+ * Workspaces are only interchangeable if they are used with the same
+ * callbacks, which is why each integrator instantiation passes itself
+ * as the Tag.
+ *
+ * @tparam Workspace Type of workspace, which must be constructible from
+ *   the arguments given to acquire and return its key from key()
+ * @tparam Tag Type which distinguishes caches of the same Workspace
+ */
+template <typename Workspace, typename Tag>
+class sundials_workspace_cache {
+ public:
+  using workspace_ptr = std::unique_ptr<Workspace>;
+
+  /**
+   * Maximum number of idle workspaces kept per cache.
+   */
+  static constexpr std::size_t max_idle_workspaces = 4;
+
+  /**
+   * Return an idle workspace with the given key or a new workspace
+   * constructed from args if there is none.
+   *
+   * @param key Key of the workspace
+   * @param args Arguments of the Workspace constructor
+   * @return workspace which is owned by the caller until it is released
+   */
+  template <typename Key, typename... Args>
+  static workspace_ptr acquire(const Key& key, Args&&... args) {
+    std::vector<workspace_ptr>& idle = idle_workspaces();
+    for (auto it = idle.begin(); it != idle.end(); ++it) {
+      if ((*it)->key() == key) {
+        workspace_ptr workspace = std::move(*it);
+        idle.erase(it);
+        return workspace;
+      }
+    }
+    return workspace_ptr(new Workspace(std::forward<Args>(args)...));
+  }
+
+  /**
+   * Return a workspace to the cache. The least recently released
+   * workspace is freed if the cache is full.
+   *
+   * @param workspace Workspace which is no longer in use
+   */
+  static void release(workspace_ptr workspace) {
+    std::vector<workspace_ptr>& idle = idle_workspaces();
+    if (idle.size() >= max_idle_workspaces) {
+      idle.erase(idle.begin());
+    }
+    idle.push_back(std::move(workspace));
+  }
+
+  /**
+   * Free all idle workspaces.
+   */
+  static void clear() { idle_workspaces().clear(); }
+
+  /**
+   * Return the number of idle workspaces.
+   */
+  static std::size_t size() { return idle_workspaces().size(); }
+
+ private:
+  static std::vector<workspace_ptr>& idle_workspaces() {
+#ifdef STAN_THREADS
+    static thread_local std::vector<workspace_ptr> idle;
+#else
+    static std::vector<workspace_ptr> idle;
+#endif
+    return idle;
+  }
+};
+
+template <typename Workspace, typename Tag>
+constexpr std::size_t
+    sundials_workspace_cache<Workspace, Tag>::max_idle_workspaces;
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -1,6 +1,7 @@
 #include <stan/math/mix.hpp>
 #include <gtest/gtest.h>
 #include <test/unit/math/rev/fun/util.hpp>
+#include <test/unit/util.hpp>
 #include <iostream>
 #include <stdexcept>
 #include <vector>
@@ -34,6 +35,29 @@ struct fun2 {
   }
 };
 
+// fun3: R^N --> R^N | x --> cumulative sums of x_i^2 * x_{i+1}
+struct fun3 {
+  template <typename T>
+  inline Matrix<T, Dynamic, 1> operator()(
+      const Matrix<T, Dynamic, 1>& x) const {
+    Matrix<T, Dynamic, 1> z(x.size());
+    T sum = 0;
+    for (int i = 0; i < x.size(); ++i) {
+      sum += x(i) * x(i) * x((i + 1) % x.size());
+      z(i) = sum;
+    }
+    return z;
+  }
+};
+
+// fun4: R^N --> R | x --> sum of x_i^2 * x_{i+1}
+struct fun4 {
+  template <typename T>
+  inline T operator()(const Matrix<T, Dynamic, 1>& x) const {
+    return fun3()(x)(x.size() - 1);
+  }
+};
+
 struct norm_functor {
   template <typename T>
   inline T operator()(
@@ -186,6 +210,59 @@ TEST(MixFunctor, hessian) {
   EXPECT_FLOAT_EQ(2 * 3, H2(1, 1));
 }
 
+TEST(MixFunctor, jacobian_grainsize) {
+  using stan::math::jacobian;
+
+  Matrix<double, Dynamic, 1> x(20);
+  for (int i = 0; i < x.size(); ++i) {
+    x(i) = 0.5 * i - 3.0;
+  }
+
+  Matrix<double, Dynamic, 1> fx;
+  Matrix<double, Dynamic, Dynamic> J;
+  jacobian(fun3(), x, fx, J);
+
+  for (int grainsize : {1, 3, 50}) {
+    Matrix<double, Dynamic, 1> fx_par;
+    Matrix<double, Dynamic, Dynamic> J_par;
+    jacobian(fun3(), x, fx_par, J_par, grainsize);
+    EXPECT_MATRIX_FLOAT_EQ(fx, fx_par);
+    EXPECT_MATRIX_FLOAT_EQ(J, J_par);
+  }
+
+  Matrix<double, Dynamic, 1> fx_par;
+  Matrix<double, Dynamic, Dynamic> J_par;
+  EXPECT_THROW(jacobian(fun3(), x, fx_par, J_par, 0), std::domain_error);
+}
+
+TEST(MixFunctor, hessian_grainsize) {
+  Matrix<double, Dynamic, 1> x(20);
+  for (int i = 0; i < x.size(); ++i) {
+    x(i) = 0.5 * i - 3.0;
+  }
+
+  double fx;
+  Matrix<double, Dynamic, 1> grad;
+  Matrix<double, Dynamic, Dynamic> H;
+  stan::math::hessian(fun4(), x, fx, grad, H);
+
+  for (int grainsize : {1, 3, 50}) {
+    double fx_par;
+    Matrix<double, Dynamic, 1> grad_par;
+    Matrix<double, Dynamic, Dynamic> H_par;
+    stan::math::hessian(fun4(), x, fx_par, grad_par, H_par, grainsize);
+    EXPECT_FLOAT_EQ(fx, fx_par);
+    EXPECT_MATRIX_FLOAT_EQ(grad, grad_par);
+    EXPECT_MATRIX_FLOAT_EQ(H, H_par);
+  }
+
+  double fx_par;
+  Matrix<double, Dynamic, 1> grad_par;
+  Matrix<double, Dynamic, Dynamic> H_par;
+  EXPECT_THROW(stan::math::hessian(fun4(), x, fx_par, grad_par, H_par, 0),
+               std::domain_error);
+}
+
 TEST(MixFunctor, GradientTraceMatrixTimesHessian) {
   Matrix<double, Dynamic, Dynamic> M(2, 2);
   M << 11, 13, 17, 23;
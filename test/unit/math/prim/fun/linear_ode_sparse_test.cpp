@@ -0,0 +1,100 @@
+#include <stan/math/prim.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace linear_ode_sparse_test {
+
+// rate matrix of a chain of compartments, the last of which absorbs
+inline Eigen::SparseMatrix<double> compartment_chain(int N) {
+  std::vector<Eigen::Triplet<double>> triplets;
+  for (int i = 0; i < N - 1; ++i) {
+    const double k = 0.5 + i;
+    triplets.emplace_back(i, i, -k);
+    triplets.emplace_back(i + 1, i, k);
+  }
+  Eigen::SparseMatrix<double> A(N, N);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+}  // namespace linear_ode_sparse_test
+
+TEST(MathMatrixPrimMat, linear_ode_sparse) {
+  using linear_ode_sparse_test::compartment_chain;
+
+  for (int N : {1, 2, 5, 60}) {
+    Eigen::SparseMatrix<double> A = compartment_chain(N);
+    Eigen::VectorXd y0 = Eigen::VectorXd::LinSpaced(N, 1.0, 2.0);
+    std::vector<double> ts = {0.01, 0.1, 0.1, 1.0, 25.0};
+
+    std::vector<Eigen::VectorXd> ys = stan::math::linear_ode_sparse(A, y0, ts);
+    ASSERT_EQ(ts.size(), ys.size());
+    const Eigen::MatrixXd A_dense = A;
+    for (size_t n = 0; n < ts.size(); ++n) {
+      Eigen::VectorXd expected = stan::math::matrix_exp(ts[n] * A_dense) * y0;
+      ASSERT_EQ(N, ys[n].size());
+      for (int i = 0; i < N; ++i) {
+        EXPECT_NEAR(expected(i), ys[n](i), 1e-8 * y0.norm())
+            << "N " << N << " output " << n << " state " << i;
+      }
+    }
+  }
+}
+
+TEST(MathMatrixPrimMat, linear_ode_sparse_non_normal) {
+  std::srand(1999);
+  const int N = 40;
+  Eigen::MatrixXd A_dense = Eigen::MatrixXd::Random(N, N);
+  A_dense = A_dense.unaryExpr([](double x) { return x > 0.6 ? x : 0.0; });
+  Eigen::SparseMatrix<double> A = A_dense.sparseView();
+  Eigen::VectorXd y0 = Eigen::VectorXd::Random(N);
+  std::vector<double> ts = {0.5, 2.0, 3.0};
+
+  std::vector<Eigen::VectorXd> ys = stan::math::linear_ode_sparse(A, y0, ts);
+  for (size_t n = 0; n < ts.size(); ++n) {
+    Eigen::VectorXd expected = stan::math::matrix_exp(ts[n] * A_dense) * y0;
+    EXPECT_MATRIX_NEAR(expected, ys[n], 1e-8 * expected.norm());
+  }
+}
+
+TEST(MathMatrixPrimMat, linear_ode_sparse_zero) {
+  Eigen::SparseMatrix<double> A(3, 3);
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, -2.0, 3.0;
+  std::vector<double> ts = {1.0, 2.0};
+  std::vector<Eigen::VectorXd> ys = stan::math::linear_ode_sparse(A, y0, ts);
+  EXPECT_MATRIX_FLOAT_EQ(y0, ys[0]);
+  EXPECT_MATRIX_FLOAT_EQ(y0, ys[1]);
+
+  Eigen::SparseMatrix<double> B
+      = linear_ode_sparse_test::compartment_chain(3);
+  ys = stan::math::linear_ode_sparse(B, Eigen::VectorXd::Zero(3), ts);
+  EXPECT_MATRIX_FLOAT_EQ(Eigen::VectorXd::Zero(3), ys[1]);
+}
+
+TEST(MathMatrixPrimMat, linear_ode_sparse_errors) {
+  using stan::math::linear_ode_sparse;
+  Eigen::SparseMatrix<double> A = linear_ode_sparse_test::compartment_chain(3);
+  Eigen::VectorXd y0 = Eigen::VectorXd::Ones(3);
+  std::vector<double> ts = {1.0, 2.0};
+
+  EXPECT_THROW(linear_ode_sparse(Eigen::SparseMatrix<double>(3, 2), y0, ts),
+               std::invalid_argument);
+  EXPECT_THROW(linear_ode_sparse(A, Eigen::VectorXd::Ones(2), ts),
+               std::invalid_argument);
+
+  Eigen::SparseMatrix<double> A_nan = A;
+  A_nan.coeffRef(1, 1) = stan::math::NOT_A_NUMBER;
+  EXPECT_THROW(linear_ode_sparse(A_nan, y0, ts), std::domain_error);
+  Eigen::VectorXd y0_inf = y0;
+  y0_inf(0) = stan::math::INFTY;
+  EXPECT_THROW(linear_ode_sparse(A, y0_inf, ts), std::domain_error);
+
+  EXPECT_THROW(linear_ode_sparse(A, y0, std::vector<double>{}),
+               std::invalid_argument);
+  EXPECT_THROW(linear_ode_sparse(A, y0, std::vector<double>{0.0, 1.0}),
+               std::domain_error);
+  EXPECT_THROW(linear_ode_sparse(A, y0, std::vector<double>{2.0, 1.0}),
+               std::domain_error);
+}
@@ -7,6 +7,8 @@
 #include <stan/math/prim.hpp>
 
 #include <iostream>
+#include <algorithm>
+#include <numeric>
 #include <vector>
 #include <memory>
 
@@ -40,6 +42,55 @@ TEST(mpi_cluster, chunk_mapping) {
   }
 }
 
+TEST(mpi_cluster, chunk_mapping_costs) {
+  boost::mpi::communicator world;
+  const std::size_t world_size = world.size();
+
+  // equal costs give an even split
+  std::vector<double> equal_costs(2 * world_size, 1.0);
+  std::vector<int> equal_load = stan::math::mpi_map_chunks(equal_costs, 3);
+  EXPECT_EQ(world_size, equal_load.size());
+  for (std::size_t i = 0; i < world_size; ++i)
+    EXPECT_EQ(6, equal_load[i]);
+
+  // the cheap jobs at the end are all assigned to the last worker
+  std::vector<double> skewed_costs(2 * world_size, 0.0);
+  std::fill(skewed_costs.begin(), skewed_costs.begin() + world_size, 1.0);
+  std::vector<int> skewed_load = stan::math::mpi_map_chunks(skewed_costs, 1);
+  EXPECT_EQ(world_size, skewed_load.size());
+  for (std::size_t i = 0; i < world_size - 1; ++i)
+    EXPECT_EQ(1, skewed_load[i]);
+  EXPECT_EQ(world_size + 1, skewed_load[world_size - 1]);
+
+  // without any costs the jobs are split evenly
+  std::vector<double> zero_costs(world_size + 1, 0.0);
+  EXPECT_EQ(stan::math::mpi_map_chunks(world_size + 1, 1),
+            stan::math::mpi_map_chunks(zero_costs, 1));
+}
+
+TEST(mpi_cluster, chunk_mapping_threads) {
+  boost::mpi::communicator world;
+  const std::size_t world_size = world.size();
+
+  // equal thread counts give the static split
+  std::vector<int> equal_threads(world_size, 4);
+  EXPECT_EQ(stan::math::mpi_map_chunks(world_size + 1, 2),
+            stan::math::mpi_map_chunks(world_size + 1, equal_threads, 2));
+
+  // the jobs are split proportional to the thread counts
+  std::vector<int> rank_threads(world_size, 1);
+  rank_threads[world_size - 1] = 3;
+  const std::size_t num_jobs = 2 * (world_size + 2);
+  std::vector<int> load = stan::math::mpi_map_chunks(num_jobs, rank_threads);
+  EXPECT_EQ(world_size, load.size());
+  for (std::size_t i = 0; i < world_size - 1; ++i)
+    EXPECT_EQ(2, load[i]);
+  EXPECT_EQ(world_size == 1 ? num_jobs : 6, load[world_size - 1]);
+
+  std::vector<int> no_load = stan::math::mpi_map_chunks(0, rank_threads);
+  EXPECT_EQ(0, std::accumulate(no_load.begin(), no_load.end(), 0));
+}
+
 TEST(mpi_cluster, listen_state) {
   EXPECT_TRUE(stan::math::mpi_cluster::listening_status());
 }
@@ -65,6 +116,26 @@ struct make_secret {
 // register worker command
 STAN_REGISTER_MPI_DISTRIBUTED_APPLY(make_secret)
 
+// command which is never broadcasted
+struct unregistered_command : public stan::math::mpi_command {
+  void run() const {}
+};
+
+TEST(mpi_cluster, command_registry) {
+  using registry = stan::math::mpi_command_registry;
+  using make_secret_apply = stan::math::mpi_distributed_apply<make_secret>;
+
+  const int command_id = registry::id<make_secret_apply>();
+  EXPECT_GE(command_id, 0);
+  EXPECT_LT(command_id, registry::size());
+
+  // registering again keeps the id
+  EXPECT_EQ(command_id, registry::add<make_secret_apply>());
+
+  EXPECT_EQ(-1, registry::id<unregistered_command>());
+  EXPECT_THROW(registry::run(registry::size()), std::out_of_range);
+}
+
 TEST(mpi_cluster, communication_apply) {
   boost::mpi::communicator world;
   const std::size_t world_size = world.size();
@@ -8,7 +8,12 @@
 
 #include <test/unit/math/prim/functor/faulty_functor.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 using stan::math::matrix_d;
@@ -60,6 +65,46 @@ typedef stan::math::mpi_parallel_call<2, mock_reduce, mock_combine_dd>
     mock_call_t;
 STAN_REGISTER_MPI_DISTRIBUTED_APPLY(mock_call_t)
 
+// job costs grow with the job index given as integer data
+struct costly_reduce {
+  matrix_d operator()(const vector_d& shared_params,
+                      const vector_d& job_specific_params,
+                      const std::vector<double>& x_r,
+                      const std::vector<int>& x_i,
+                      std::ostream* msgs = nullptr) const {
+    std::this_thread::sleep_for(std::chrono::milliseconds(x_i[0] * x_i[0]));
+    matrix_d res(1, 2);
+    res << x_r[0], x_i[0];
+    return res;
+  }
+};
+
+typedef stan::math::mpi_parallel_call<3, costly_reduce, mock_combine_dd>
+    costly_call_t;
+STAN_REGISTER_MPI_DISTRIBUTED_APPLY(costly_call_t)
+
+// returns the parameters and counts the evaluations in each process
+struct echo_reduce {
+  static std::atomic<int> num_evals;
+
+  matrix_d operator()(const vector_d& shared_params,
+                      const vector_d& job_specific_params,
+                      const std::vector<double>& x_r,
+                      const std::vector<int>& x_i,
+                      std::ostream* msgs = nullptr) const {
+    ++num_evals;
+    matrix_d res(4, 1);
+    res << shared_params, job_specific_params;
+    return res;
+  }
+};
+
+std::atomic<int> echo_reduce::num_evals(0);
+
+typedef stan::math::mpi_parallel_call<4, echo_reduce, mock_combine_dd>
+    echo_call_t;
+STAN_REGISTER_MPI_DISTRIBUTED_APPLY(echo_call_t)
+
 struct MpiJob : public ::testing::Test {
   Eigen::VectorXd shared_params_d;
   std::vector<Eigen::VectorXd> job_params_d;
@@ -201,6 +246,126 @@ TEST_F(MpiJob, size_mismatch_cached_jobs_dd) {
                std::invalid_argument);
 }
 
+TEST_F(MpiJob, rebalance_costly_jobs_dd) {
+  using cache_chunks = stan::math::internal::mpi_parallel_call_cache<
+      3, 4, std::vector<int>>;
+  boost::mpi::communicator world;
+  const std::size_t world_size = world.size();
+
+  for (std::size_t n = 0; n != N; ++n)
+    x_r[n][0] = 2.0 * n;
+
+  for (int iter = 0; iter < 4; ++iter) {
+    // new parameters avoid that cached results are returned
+    shared_params_d(1) = iter;
+    std::shared_ptr<costly_call_t> call;
+    EXPECT_NO_THROW((call = std::shared_ptr<costly_call_t>(new costly_call_t(
+                         shared_params_d, job_params_d, x_r, x_i))));
+
+    // the results stay in job order whatever the job assignment
+    matrix_d res = call->reduce_combine();
+    EXPECT_EQ(res.rows(), 1);
+    EXPECT_EQ(res.cols(), 2 * N);
+    for (std::size_t n = 0; n != N; ++n) {
+      EXPECT_FLOAT_EQ(res(0, 2 * n), x_r[n][0]);
+      EXPECT_FLOAT_EQ(res(0, 2 * n + 1), n);
+    }
+  }
+
+  const std::vector<int>& job_chunks = cache_chunks::data();
+  EXPECT_EQ(N, stan::math::sum(job_chunks));
+  if (world_size > 1) {
+    // the most expensive jobs at the end are spread over more workers
+    EXPECT_LT(job_chunks[world_size - 1],
+              stan::math::mpi_map_chunks(N, 1)[world_size - 1]);
+  }
+}
+
+TEST_F(MpiJob, changed_params_dd) {
+  boost::mpi::communicator world;
+  const int num_local_jobs = stan::math::mpi_map_chunks(N, 1)[0];
+
+  auto check_call = [&]() {
+    std::shared_ptr<echo_call_t> call;
+    EXPECT_NO_THROW((call = std::shared_ptr<echo_call_t>(new echo_call_t(
+                         shared_params_d, job_params_d, x_r, x_i))));
+    matrix_d res = call->reduce_combine();
+    EXPECT_EQ(res.rows(), 4);
+    EXPECT_EQ(res.cols(), N);
+    for (std::size_t n = 0; n != N; ++n) {
+      EXPECT_FLOAT_EQ(res(0, n), shared_params_d(0));
+      EXPECT_FLOAT_EQ(res(1, n), shared_params_d(1));
+      EXPECT_FLOAT_EQ(res(2, n), job_params_d[n](0));
+      EXPECT_FLOAT_EQ(res(3, n), job_params_d[n](1));
+    }
+  };
+
+  check_call();
+  int num_evals = echo_reduce::num_evals;
+  EXPECT_EQ(num_local_jobs, num_evals);
+
+  // only a few parameters change
+  shared_params_d(1) = -3.0;
+  check_call();
+  job_params_d[N - 1](0) = 7.0;
+  job_params_d[0](1) = 5.0;
+  check_call();
+  shared_params_d << 11.0, 12.0;
+  check_call();
+  EXPECT_EQ(num_evals + 3 * num_local_jobs, echo_reduce::num_evals);
+
+  // the results of known parameters are reused on the root
+  num_evals = echo_reduce::num_evals;
+  shared_params_d(1) = -3.0;
+  check_call();
+  shared_params_d(0) = 2.0;
+  check_call();
+  EXPECT_EQ(num_evals + num_local_jobs, echo_reduce::num_evals);
+}
+
+TEST_F(MpiJob, profile_dd) {
+  using stan::math::mpi_profile;
+  boost::mpi::communicator world;
+  const std::size_t world_size = world.size();
+
+  mpi_profile::reset();
+  mpi_profile::enable();
+  EXPECT_TRUE(mpi_profile::is_enabled());
+
+  for (int iter = 0; iter < 3; ++iter) {
+    shared_params_d(0) = 100.0 + iter;
+    echo_call_t(shared_params_d, job_params_d, x_r, x_i).reduce_combine();
+  }
+
+  mpi_profile::disable();
+  EXPECT_FALSE(mpi_profile::is_enabled());
+  shared_params_d(0) = 200.0;
+  echo_call_t(shared_params_d, job_params_d, x_r, x_i).reduce_combine();
+
+  EXPECT_EQ(0, mpi_profile::stats(0).size());
+  std::vector<stan::math::mpi_rank_stats> stats = mpi_profile::stats(4);
+  EXPECT_EQ(world_size, stats.size());
+  std::size_t num_jobs = 0;
+  for (std::size_t r = 0; r != world_size; ++r) {
+    EXPECT_EQ(3, stats[r].num_calls);
+    EXPECT_GE(stats[r].compute_time, 0.0);
+    EXPECT_GE(stats[r].wait_time, 0.0);
+    if (world_size > 1) {
+      EXPECT_GT(stats[r].bytes, 0.0);
+    }
+    num_jobs += stats[r].num_jobs;
+  }
+  EXPECT_EQ(3 * N, num_jobs);
+
+  std::stringstream csv;
+  mpi_profile::write_csv(csv);
+  std::string line;
+  std::size_t num_lines = 0;
+  while (std::getline(csv, line))
+    ++num_lines;
+  EXPECT_EQ(1 + world_size, num_lines);
+}
+
 TEST_F(MpiJob, root_not_confused_dd) {
   // the root must not call the distributed_apply ever
   EXPECT_THROW_MSG(mock_call_t::distributed_apply(), std::runtime_error,
@@ -0,0 +1,77 @@
+#include <stan/math/prim.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_rk45_batch_prim_test {
+
+struct decay_ode {
+  template <typename T0, typename T_y, typename T_k>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const T_k& k) const {
+    return -k * y;
+  }
+};
+
+}  // namespace ode_rk45_batch_prim_test
+
+TEST(StanMathOde_ode_rk45_batch, matches_single_solves) {
+  using ode_rk45_batch_prim_test::decay_ode;
+
+  const std::size_t num_systems = 5;
+  std::vector<Eigen::VectorXd> y0;
+  std::vector<std::vector<double>> ts;
+  std::vector<double> k;
+  for (std::size_t i = 0; i < num_systems; ++i) {
+    y0.push_back(Eigen::VectorXd::Constant(2, 1.0 + i));
+    ts.push_back(std::vector<double>(i + 1, 0.0));
+    for (std::size_t j = 0; j <= i; ++j)
+      ts[i][j] = 0.5 * (j + 1);
+    k.push_back(0.1 * (i + 1));
+  }
+
+  std::vector<std::vector<Eigen::VectorXd>> ys = stan::math::ode_rk45_batch(
+      decay_ode(), y0, 0.0, ts, nullptr, k);
+
+  ASSERT_EQ(num_systems, ys.size());
+  for (std::size_t i = 0; i < num_systems; ++i) {
+    std::vector<Eigen::VectorXd> y_i
+        = stan::math::ode_rk45(decay_ode(), y0[i], 0.0, ts[i], nullptr, k[i]);
+    ASSERT_EQ(y_i.size(), ys[i].size());
+    for (std::size_t j = 0; j < y_i.size(); ++j) {
+      EXPECT_MATRIX_FLOAT_EQ(y_i[j], ys[i][j]);
+      EXPECT_NEAR((1.0 + i) * std::exp(-k[i] * ts[i][j]), ys[i][j](0), 1e-5);
+    }
+  }
+}
+
+TEST(StanMathOde_ode_rk45_batch, errors) {
+  using ode_rk45_batch_prim_test::decay_ode;
+
+  std::vector<Eigen::VectorXd> y0(2, Eigen::VectorXd::Ones(1));
+  std::vector<std::vector<double>> ts(2, std::vector<double>{1.0});
+  std::vector<double> k(2, 0.5);
+
+  EXPECT_EQ(0, stan::math::ode_rk45_batch(
+                   decay_ode(), std::vector<Eigen::VectorXd>(), 0.0,
+                   std::vector<std::vector<double>>(), nullptr,
+                   std::vector<double>())
+                   .size());
+
+  std::vector<double> k_short(1, 0.5);
+  EXPECT_THROW(stan::math::ode_rk45_batch(decay_ode(), y0, 0.0, ts, nullptr,
+                                          k_short),
+               std::invalid_argument);
+
+  std::vector<std::vector<double>> ts_short(1, std::vector<double>{1.0});
+  EXPECT_THROW(
+      stan::math::ode_rk45_batch(decay_ode(), y0, 0.0, ts_short, nullptr, k),
+      std::invalid_argument);
+
+  // errors of single systems are propagated
+  ts[1][0] = -1.0;
+  EXPECT_THROW(stan::math::ode_rk45_tol_batch(decay_ode(), y0, 0.0, ts, 1e-6,
+                                              1e-6, 1000, nullptr, k),
+               std::domain_error);
+}
@@ -0,0 +1,74 @@
+#include <stan/math.hpp>
+#include <test/unit/math/prim/functor/reduce_sum_util.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(StanMathPrim_reduce_sum_auto, value) {
+  using stan::math::test::count_lpdf;
+  using stan::math::test::get_new_msg;
+  double lambda_d = 10.0;
+  const std::size_t elems = 10000;
+  std::vector<int> data(elems);
+
+  for (std::size_t i = 0; i != elems; ++i)
+    data[i] = i;
+
+  std::vector<int> idata;
+  std::vector<double> vlambda_d(1, lambda_d);
+
+  double poisson_lpdf_ref = stan::math::poisson_lpmf(data, lambda_d);
+
+  EXPECT_EQ(0, (stan::math::reduce_sum_auto_grainsize<count_lpdf<double>>(
+                   elems)));
+
+  for (int i = 0; i < 50; ++i) {
+    double poisson_lpdf = stan::math::reduce_sum_auto<count_lpdf<double>>(
+        data, get_new_msg(), vlambda_d, idata);
+    EXPECT_FLOAT_EQ(poisson_lpdf, poisson_lpdf_ref);
+  }
+
+  const int grainsize
+      = stan::math::reduce_sum_auto_grainsize<count_lpdf<double>>(elems);
+#ifdef STAN_THREADS
+  EXPECT_GE(grainsize, 1);
+  EXPECT_LE(grainsize, elems);
+#else
+  EXPECT_EQ(0, grainsize);
+#endif
+  // the tuning is done per number of terms
+  EXPECT_EQ(0, (stan::math::reduce_sum_auto_grainsize<count_lpdf<double>>(
+                   elems + 1)));
+}
+
+TEST(StanMathPrim_reduce_sum_auto, empty) {
+  using stan::math::test::get_new_msg;
+  using stan::math::test::sum_lpdf;
+  std::vector<double> data(0);
+  EXPECT_EQ(0.0, stan::math::reduce_sum_auto<sum_lpdf>(data, get_new_msg()));
+}
+
+TEST(StanMathPrim_reduce_sum_auto, grainsize_tuner) {
+  stan::math::internal::grainsize_tuner tuner(1000, 4, 2);
+  const std::vector<int>& candidates = tuner.candidates();
+  ASSERT_FALSE(candidates.empty());
+  EXPECT_EQ(250, candidates.front());
+  EXPECT_EQ(4, candidates.back());
+  EXPECT_FALSE(tuner.converged());
+  EXPECT_EQ(0, tuner.grainsize());
+
+  // pretend that the third candidate is the fastest one
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    for (int trial = 0; trial < 2; ++trial) {
+      EXPECT_EQ(candidates[i], tuner.propose());
+      tuner.record(tuner.propose(), i == 2 ? 1.0 : 2.0);
+    }
+  }
+  EXPECT_TRUE(tuner.converged());
+  EXPECT_EQ(candidates[2], tuner.grainsize());
+  EXPECT_EQ(candidates[2], tuner.propose());
+
+  stan::math::internal::grainsize_tuner small_tuner(3, 8);
+  ASSERT_EQ(1, small_tuner.candidates().size());
+  EXPECT_EQ(1, small_tuner.propose());
+}
@@ -0,0 +1,102 @@
+#include <stan/math/rev/core.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+TEST(AgradRevScopedChainableStack, execute_restores_main_stack) {
+  using stan::math::ChainableStack;
+  using stan::math::ScopedChainableStack;
+  using stan::math::var;
+
+  stan::math::recover_memory();
+  ChainableStack::AutodiffStackStorage* main_stack = ChainableStack::instance_;
+  const std::size_t main_size = main_stack->var_stack_.size();
+
+  ScopedChainableStack scoped_stack;
+  EXPECT_FALSE(scoped_stack.is_active());
+
+  scoped_stack.execute([&] {
+    EXPECT_EQ(ChainableStack::instance_, scoped_stack.storage());
+    EXPECT_TRUE(scoped_stack.is_active());
+    var a = 2.0;
+    var b = a * a;
+  });
+
+  EXPECT_EQ(ChainableStack::instance_, main_stack);
+  EXPECT_FALSE(scoped_stack.is_active());
+  EXPECT_EQ(main_size, main_stack->var_stack_.size());
+  EXPECT_EQ(1, scoped_stack.storage()->var_stack_.size());
+}
+
+TEST(AgradRevScopedChainableStack, interleaved_gradients) {
+  using stan::math::ScopedChainableStack;
+  using stan::math::var;
+
+  ScopedChainableStack tape_a;
+  ScopedChainableStack tape_b;
+
+  var x_a = tape_a.execute([] { return var(3.0); });
+  var x_b = tape_b.execute([] { return var(5.0); });
+
+  var lp_a = tape_a.execute([&] { return x_a * x_a; });
+  var lp_b = tape_b.execute([&] { return x_b * x_b * x_b; });
+
+  tape_b.execute([&] { lp_b.grad(); });
+  tape_a.execute([&] { lp_a.grad(); });
+
+  EXPECT_FLOAT_EQ(9.0, lp_a.val());
+  EXPECT_FLOAT_EQ(6.0, x_a.adj());
+  EXPECT_FLOAT_EQ(125.0, lp_b.val());
+  EXPECT_FLOAT_EQ(75.0, x_b.adj());
+
+  tape_a.execute([] { stan::math::recover_memory(); });
+  EXPECT_EQ(0, tape_a.storage()->var_stack_.size());
+  EXPECT_EQ(2, tape_b.storage()->var_stack_.size());
+}
+
+TEST(AgradRevScopedChainableStack, recursive_activation_throws) {
+  using stan::math::ChainableStack;
+  using stan::math::ScopedChainableStack;
+
+  ChainableStack::AutodiffStackStorage* main_stack = ChainableStack::instance_;
+  ScopedChainableStack scoped_stack;
+
+  EXPECT_THROW(scoped_stack.execute([&] { scoped_stack.execute([] {}); }),
+               std::logic_error);
+  EXPECT_EQ(ChainableStack::instance_, main_stack);
+  EXPECT_FALSE(scoped_stack.is_active());
+}
+
+TEST(AgradRevScopedChainableStack, exception_restores_main_stack) {
+  using stan::math::ChainableStack;
+  using stan::math::ScopedChainableStack;
+
+  ChainableStack::AutodiffStackStorage* main_stack = ChainableStack::instance_;
+  ScopedChainableStack scoped_stack;
+
+  EXPECT_THROW(scoped_stack.execute([] { throw std::domain_error("fail"); }),
+               std::domain_error);
+  EXPECT_EQ(ChainableStack::instance_, main_stack);
+
+  // the tape can be activated again after the failure
+  double result = scoped_stack.execute([](double x) { return 2.0 * x; }, 4.0);
+  EXPECT_FLOAT_EQ(8.0, result);
+}
+
+TEST(AgradRevScopedChainableStack, explicit_activation) {
+  using stan::math::ChainableStack;
+  using stan::math::ScopedChainableStack;
+  using stan::math::var;
+
+  ChainableStack::AutodiffStackStorage* main_stack = ChainableStack::instance_;
+  ScopedChainableStack scoped_stack;
+
+  std::vector<var> xs;
+  for (int i = 0; i < 3; ++i) {
+    ScopedChainableStack::activation active(scoped_stack);
+    EXPECT_EQ(ChainableStack::instance_, scoped_stack.storage());
+    xs.push_back(var(i));
+  }
+  EXPECT_EQ(ChainableStack::instance_, main_stack);
+  EXPECT_EQ(3, scoped_stack.storage()->var_nochain_stack_.size());
+}
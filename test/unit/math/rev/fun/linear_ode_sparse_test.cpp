@@ -0,0 +1,198 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace linear_ode_sparse_test {
+
+using stan::math::var;
+
+// rate matrix of a Markov model with random transitions and some
+// additional loss from each state
+inline std::vector<Eigen::Triplet<double>> random_triplets(int N) {
+  std::srand(1999);
+  std::vector<Eigen::Triplet<double>> triplets;
+  Eigen::MatrixXd values = Eigen::MatrixXd::Random(N, N);
+  for (int j = 0; j < N; ++j) {
+    double out = 0.5 * std::fabs(values(j, j));
+    for (int i = 0; i < N; ++i) {
+      if (i != j && values(i, j) > 0.5) {
+        triplets.emplace_back(i, j, values(i, j));
+        out += values(i, j);
+      }
+    }
+    triplets.emplace_back(j, j, -out);
+  }
+  return triplets;
+}
+
+template <typename Ta>
+inline Eigen::SparseMatrix<Ta> sparse(
+    int N, const std::vector<Eigen::Triplet<double>>& triplets) {
+  std::vector<Eigen::Triplet<Ta>> t;
+  for (const auto& x : triplets) {
+    t.emplace_back(x.row(), x.col(), x.value());
+  }
+  Eigen::SparseMatrix<Ta> A(N, N);
+  A.setFromTriplets(t.begin(), t.end());
+  return A;
+}
+
+// dense copy of A which shares the vars of the non-zero entries
+inline Eigen::Matrix<var, -1, -1> dense(const Eigen::SparseMatrix<var>& A) {
+  Eigen::Matrix<var, -1, -1> A_dense
+      = Eigen::Matrix<var, -1, -1>::Constant(A.rows(), A.cols(), 0.0);
+  for (int j = 0; j < A.outerSize(); ++j) {
+    for (Eigen::SparseMatrix<var>::InnerIterator it(A, j); it; ++it) {
+      A_dense(it.row(), it.col()) = it.value();
+    }
+  }
+  return A_dense;
+}
+
+inline std::vector<double> adjoints(const Eigen::SparseMatrix<var>& A,
+                                    const Eigen::Matrix<var, -1, 1>& y0) {
+  std::vector<double> g;
+  for (int j = 0; j < A.outerSize(); ++j) {
+    for (Eigen::SparseMatrix<var>::InnerIterator it(A, j); it; ++it) {
+      g.push_back(it.value().adj());
+    }
+  }
+  for (int i = 0; i < y0.size(); ++i) {
+    g.push_back(y0(i).adj());
+  }
+  return g;
+}
+
+}  // namespace linear_ode_sparse_test
+
+TEST(AgradRevMatrix, linear_ode_sparse) {
+  using linear_ode_sparse_test::adjoints;
+  using linear_ode_sparse_test::dense;
+  using linear_ode_sparse_test::random_triplets;
+  using linear_ode_sparse_test::sparse;
+  using stan::math::var;
+
+  const int N = 40;
+  Eigen::SparseMatrix<var> A = sparse<var>(N, random_triplets(N));
+  Eigen::Matrix<var, -1, 1> y0 = Eigen::VectorXd::LinSpaced(N, -1.0, 1.0);
+  std::vector<double> ts = {0.2, 1.0, 1.0, 4.0};
+  Eigen::VectorXd c = Eigen::VectorXd::LinSpaced(N, 0.5, 2.0);
+
+  std::vector<Eigen::Matrix<var, -1, 1>> ys
+      = stan::math::linear_ode_sparse(A, y0, ts);
+  var loss = 0;
+  for (size_t n = 0; n < ts.size(); ++n) {
+    loss += (n + 1.0) * stan::math::dot_product(c, ys[n]);
+  }
+
+  const Eigen::Matrix<var, -1, -1> A_dense = dense(A);
+  var loss_dense = 0;
+  for (size_t n = 0; n < ts.size(); ++n) {
+    Eigen::Matrix<var, -1, 1> y
+        = stan::math::scale_matrix_exp_multiply(ts[n], A_dense, y0);
+    EXPECT_MATRIX_NEAR(stan::math::value_of(y),
+                       stan::math::value_of(ys[n]), 1e-8);
+    loss_dense += (n + 1.0) * stan::math::dot_product(c, y);
+  }
+
+  stan::math::set_zero_all_adjoints();
+  loss.grad();
+  std::vector<double> g = adjoints(A, y0);
+  stan::math::set_zero_all_adjoints();
+  loss_dense.grad();
+  std::vector<double> g_dense = adjoints(A, y0);
+
+  ASSERT_EQ(g_dense.size(), g.size());
+  for (size_t i = 0; i < g.size(); ++i) {
+    EXPECT_NEAR(g_dense[i], g[i], 1e-7 * std::max(1.0, std::fabs(g_dense[i])))
+        << "adjoint " << i;
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevMatrix, linear_ode_sparse_single_output_component) {
+  using linear_ode_sparse_test::adjoints;
+  using linear_ode_sparse_test::dense;
+  using linear_ode_sparse_test::random_triplets;
+  using linear_ode_sparse_test::sparse;
+  using stan::math::var;
+
+  const int N = 6;
+  Eigen::SparseMatrix<var> A = sparse<var>(N, random_triplets(N));
+  Eigen::Matrix<var, -1, 1> y0 = Eigen::VectorXd::Ones(N);
+  std::vector<double> ts = {0.5, 3.0};
+
+  std::vector<Eigen::Matrix<var, -1, 1>> ys
+      = stan::math::linear_ode_sparse(A, y0, ts);
+  Eigen::Matrix<var, -1, 1> y_dense
+      = stan::math::scale_matrix_exp_multiply(ts[0], dense(A), y0);
+
+  stan::math::set_zero_all_adjoints();
+  ys[0](2).grad();
+  std::vector<double> g = adjoints(A, y0);
+  stan::math::set_zero_all_adjoints();
+  y_dense(2).grad();
+  std::vector<double> g_dense = adjoints(A, y0);
+  for (size_t i = 0; i < g.size(); ++i) {
+    EXPECT_NEAR(g_dense[i], g[i], 1e-7 * std::max(1.0, std::fabs(g_dense[i])))
+        << "adjoint " << i;
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevMatrix, linear_ode_sparse_data_matrix) {
+  using linear_ode_sparse_test::random_triplets;
+  using linear_ode_sparse_test::sparse;
+  using stan::math::var;
+
+  const int N = 8;
+  Eigen::SparseMatrix<double> A = sparse<double>(N, random_triplets(N));
+  Eigen::Matrix<var, -1, 1> y0 = Eigen::VectorXd::LinSpaced(N, 0.0, 1.0);
+  std::vector<double> ts = {0.3, 1.5};
+
+  std::vector<Eigen::Matrix<var, -1, 1>> ys
+      = stan::math::linear_ode_sparse(A, y0, ts);
+  ys[1](N - 1).grad();
+
+  // the adjoint of y0 is the last row of exp(t A)
+  const Eigen::MatrixXd expA
+      = stan::math::matrix_exp(ts[1] * Eigen::MatrixXd(A));
+  for (int i = 0; i < N; ++i) {
+    EXPECT_NEAR(expA(N - 1, i), y0(i).adj(), 1e-8);
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevMatrix, linear_ode_sparse_data_initial_state) {
+  using linear_ode_sparse_test::adjoints;
+  using linear_ode_sparse_test::dense;
+  using linear_ode_sparse_test::random_triplets;
+  using linear_ode_sparse_test::sparse;
+  using stan::math::var;
+
+  const int N = 5;
+  Eigen::SparseMatrix<var> A = sparse<var>(N, random_triplets(N));
+  Eigen::VectorXd y0 = Eigen::VectorXd::LinSpaced(N, 1.0, 2.0);
+  std::vector<double> ts = {2.0};
+
+  std::vector<Eigen::Matrix<var, -1, 1>> ys
+      = stan::math::linear_ode_sparse(A, y0, ts);
+  Eigen::Matrix<var, -1, 1> y_dense
+      = stan::math::scale_matrix_exp_multiply(ts[0], dense(A), y0);
+
+  stan::math::set_zero_all_adjoints();
+  stan::math::sum(ys[0]).grad();
+  std::vector<double> g = adjoints(A, Eigen::Matrix<var, -1, 1>());
+  stan::math::set_zero_all_adjoints();
+  stan::math::sum(y_dense).grad();
+  std::vector<double> g_dense = adjoints(A, Eigen::Matrix<var, -1, 1>());
+  for (size_t i = 0; i < g.size(); ++i) {
+    EXPECT_NEAR(g_dense[i], g[i], 1e-7 * std::max(1.0, std::fabs(g_dense[i])));
+  }
+
+  stan::math::recover_memory();
+}
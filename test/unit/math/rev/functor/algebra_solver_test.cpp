@@ -212,6 +212,25 @@ TEST_F(algebra_solver_non_linear_eq_test, powell) {
   }
 }
 
+TEST_F(algebra_solver_non_linear_eq_test, powell_vector_jacobian_product) {
+  using stan::math::var;
+  bool is_newton = false;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y = y_dbl;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> theta
+      = non_linear_eq_test(non_linear_eq_functor(), y, is_newton);
+
+  // the adjoints of all solutions are propagated by a single solve
+  Eigen::VectorXd w = stan::math::to_vector(std::vector<double>{0.5, -2, 3});
+  var loss = stan::math::dot_product(w, theta);
+  AVEC y_vec = createAVEC(y(0), y(1), y(2));
+  VEC g;
+  loss.grad(y_vec, g);
+
+  Eigen::VectorXd g_expected = J.transpose() * w;
+  for (int i = 0; i < n_y; i++)
+    EXPECT_NEAR(g_expected(i), g[i], err);
+}
+
 TEST_F(algebra_solver_non_linear_eq_test, powell_dbl) {
   bool is_newton = false;
   Eigen::VectorXd theta
@@ -0,0 +1,303 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace algebra_solver_warm_start_test {
+
+int num_evals = 0;
+
+// x^3 + x = y, solved elementwise
+struct cubic_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* msgs) const {
+    ++num_evals;
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      z(i) = x(i) * x(i) * x(i) + x(i) - y(i);
+    }
+    return z;
+  }
+};
+
+// x^3 + x = y + dat, solved elementwise
+struct cubic_data_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* msgs) const {
+    ++num_evals;
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      z(i) = x(i) * x(i) * x(i) + x(i) - y(i) - dat[i];
+    }
+    return z;
+  }
+};
+
+// x = y, but only defined within a distance of 1 to y
+struct local_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* msgs) const {
+    if (stan::math::value_of(x(0)) > stan::math::value_of(y(0)) + 1) {
+      throw std::domain_error("outside of the domain");
+    }
+    return x - y;
+  }
+};
+
+// x = cos(x) / 2 + y
+struct fixed_point_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* msgs) const {
+    ++num_evals;
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      z(i) = 0.5 * stan::math::cos(x(i)) + y(i);
+    }
+    return z;
+  }
+};
+
+struct tag {};
+
+class warm_start : public ::testing::Test {
+ protected:
+  void SetUp() override { num_evals = 0; }
+  void TearDown() override {
+    stan::math::algebra_solver_warm_start::disable();
+    stan::math::recover_memory();
+  }
+
+  Eigen::VectorXd x_guess = Eigen::VectorXd::Constant(3, 10.0);
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+};
+
+}  // namespace algebra_solver_warm_start_test
+
+using algebra_solver_warm_start_test::warm_start;
+
+TEST_F(warm_start, disabled_by_default) {
+  EXPECT_FALSE(stan::math::algebra_solver_warm_start::enabled());
+  EXPECT_FALSE(stan::math::algebra_solver_warm_start::extrapolate());
+}
+
+TEST_F(warm_start, newton_needs_fewer_evaluations) {
+  using algebra_solver_warm_start_test::cubic_functor;
+  using algebra_solver_warm_start_test::num_evals;
+  using stan::math::algebra_solver_newton;
+  Eigen::VectorXd y1 = stan::math::to_vector({2, 10, 30});
+  Eigen::VectorXd y2
+      = stan::math::to_vector(std::vector<double>{2.01, 10.1, 30.2});
+
+  algebra_solver_newton(cubic_functor(), x_guess, y1, dat, dat_int);
+  num_evals = 0;
+  Eigen::VectorXd cold
+      = algebra_solver_newton(cubic_functor(), x_guess, y2, dat, dat_int);
+  const int cold_evals = num_evals;
+
+  stan::math::algebra_solver_warm_start::enable();
+  algebra_solver_newton(cubic_functor(), x_guess, y1, dat, dat_int);
+  num_evals = 0;
+  Eigen::VectorXd warm
+      = algebra_solver_newton(cubic_functor(), x_guess, y2, dat, dat_int);
+
+  EXPECT_LT(num_evals, cold_evals);
+  EXPECT_MATRIX_NEAR(cold, warm, 1e-6);
+}
+
+TEST_F(warm_start, powell_needs_fewer_evaluations) {
+  using algebra_solver_warm_start_test::cubic_functor;
+  using algebra_solver_warm_start_test::num_evals;
+  using stan::math::algebra_solver_powell;
+  using stan::math::var;
+  Eigen::VectorXd y1 = stan::math::to_vector({2, 10, 30});
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y2
+      = stan::math::to_vector(std::vector<double>{2.01, 10.1, 30.2});
+
+  num_evals = 0;
+  Eigen::VectorXd cold = stan::math::value_of(
+      algebra_solver_powell(cubic_functor(), x_guess, y2, dat, dat_int));
+  const int cold_evals = num_evals;
+
+  stan::math::algebra_solver_warm_start::enable();
+  algebra_solver_powell(cubic_functor(), x_guess, y1, dat, dat_int);
+  num_evals = 0;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> warm
+      = algebra_solver_powell(cubic_functor(), x_guess, y2, dat, dat_int);
+
+  EXPECT_LT(num_evals, cold_evals);
+  EXPECT_MATRIX_NEAR(cold, stan::math::value_of(warm), 1e-8);
+
+  // the gradients do not depend on the starting point
+  warm(1).grad();
+  EXPECT_FLOAT_EQ(0.0, y2(0).adj());
+  EXPECT_FLOAT_EQ(1.0 / (3.0 * cold(1) * cold(1) + 1.0), y2(1).adj());
+  EXPECT_FLOAT_EQ(0.0, y2(2).adj());
+}
+
+TEST_F(warm_start, fixed_point_needs_fewer_evaluations) {
+  using algebra_solver_warm_start_test::fixed_point_functor;
+  using algebra_solver_warm_start_test::num_evals;
+  using stan::math::algebra_solver_fp;
+  Eigen::VectorXd y1 = stan::math::to_vector(std::vector<double>{0.5, 1, 2});
+  Eigen::VectorXd y2
+      = stan::math::to_vector(std::vector<double>{0.501, 1.001, 2.001});
+  std::vector<double> scale(3, 1.0);
+
+  num_evals = 0;
+  Eigen::VectorXd cold = algebra_solver_fp(fixed_point_functor(), x_guess, y2,
+                                           dat, dat_int, scale, scale);
+  const int cold_evals = num_evals;
+
+  stan::math::algebra_solver_warm_start::enable();
+  algebra_solver_fp(fixed_point_functor(), x_guess, y1, dat, dat_int, scale,
+                    scale);
+  num_evals = 0;
+  Eigen::VectorXd warm = algebra_solver_fp(fixed_point_functor(), x_guess, y2,
+                                           dat, dat_int, scale, scale);
+
+  EXPECT_LT(num_evals, cold_evals);
+  EXPECT_MATRIX_NEAR(cold, warm, 1e-6);
+}
+
+TEST_F(warm_start, falls_back_to_initial_guess) {
+  using algebra_solver_warm_start_test::local_functor;
+  using stan::math::algebra_solver_newton;
+  using stan::math::algebra_solver_powell;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(1);
+  Eigen::VectorXd y1 = stan::math::to_vector({4});
+  Eigen::VectorXd y2 = stan::math::to_vector({1});
+
+  stan::math::algebra_solver_warm_start::enable();
+  algebra_solver_powell(local_functor(), x, y1, dat, dat_int);
+  // the system is not defined at the warm start 4
+  EXPECT_FLOAT_EQ(
+      1.0, algebra_solver_powell(local_functor(), x, y2, dat, dat_int)(0));
+
+  algebra_solver_newton(local_functor(), x, y1, dat, dat_int);
+  EXPECT_FLOAT_EQ(
+      1.0, algebra_solver_newton(local_functor(), x, y2, dat, dat_int)(0));
+
+  // failures from the initial guess of the caller are not hidden
+  Eigen::VectorXd x_bad = Eigen::VectorXd::Constant(1, 3);
+  EXPECT_THROW(algebra_solver_powell(local_functor(), x_bad, y2, dat, dat_int),
+               std::domain_error);
+}
+
+TEST_F(warm_start, secant_extrapolation) {
+  using cache = stan::math::internal::algebra_solver_warm_start_cache<
+      algebra_solver_warm_start_test::tag>;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(2);
+  Eigen::VectorXd x0;
+
+  stan::math::algebra_solver_warm_start::enable(true);
+  EXPECT_FALSE(cache::guess(x, Eigen::VectorXd::Zero(1), 0, x0));
+
+  cache::store(stan::math::to_vector({1}), 0, stan::math::to_vector({1, -1}));
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({2}), 0, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({1, -1}), x0);
+
+  cache::store(stan::math::to_vector({2}), 0, stan::math::to_vector({4, -2}));
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({3}), 0, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({7, -3}), x0);
+
+  // the step along the secant is limited
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({100}), 0, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({10, -4}), x0);
+
+  // a repeated solve keeps the secant
+  cache::store(stan::math::to_vector({2}), 0, stan::math::to_vector({4, -2}));
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({3}), 0, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({7, -3}), x0);
+
+  // without extrapolation the last solution is the starting point
+  stan::math::algebra_solver_warm_start::enable(false);
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({3}), 0, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({4, -2}), x0);
+
+  // solutions are kept per problem size
+  EXPECT_FALSE(cache::guess(Eigen::VectorXd::Zero(3),
+                            stan::math::to_vector({3}), 0, x0));
+
+  stan::math::algebra_solver_warm_start::clear();
+  EXPECT_FALSE(cache::guess(x, stan::math::to_vector({3}), 0, x0));
+}
+
+TEST_F(warm_start, solutions_are_kept_per_data_set) {
+  using cache = stan::math::internal::algebra_solver_warm_start_cache<
+      algebra_solver_warm_start_test::tag>;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(1);
+  Eigen::VectorXd x0;
+  const std::size_t key_a = cache::data_key({1.0}, {});
+  const std::size_t key_b = cache::data_key({2.0}, {});
+  ASSERT_NE(key_a, key_b);
+  EXPECT_NE(key_a, cache::data_key({1.0}, {0}));
+
+  stan::math::algebra_solver_warm_start::enable(true);
+  cache::store(stan::math::to_vector({1}), key_a, stan::math::to_vector({1}));
+  EXPECT_FALSE(cache::guess(x, stan::math::to_vector({2}), key_b, x0));
+  cache::store(stan::math::to_vector({2}), key_b,
+               stan::math::to_vector({100}));
+  cache::store(stan::math::to_vector({2}), key_a, stan::math::to_vector({2}));
+
+  // the secant only runs through the solutions of the same data set
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({3}), key_a, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({3}), x0);
+  ASSERT_TRUE(cache::guess(x, stan::math::to_vector({3}), key_b, x0));
+  EXPECT_MATRIX_FLOAT_EQ(stan::math::to_vector({100}), x0);
+}
+
+TEST_F(warm_start, newton_alternating_data_sets) {
+  using algebra_solver_warm_start_test::cubic_data_functor;
+  using algebra_solver_warm_start_test::num_evals;
+  using stan::math::algebra_solver_newton;
+  std::vector<double> dat_a{0, 0, 0};
+  std::vector<double> dat_b{1000, 2000, 3000};
+
+  auto solve_all = [&](int& evals_a) {
+    evals_a = 0;
+    std::vector<Eigen::VectorXd> thetas;
+    for (int n = 0; n < 6; ++n) {
+      Eigen::VectorXd y = Eigen::VectorXd::Constant(3, 2.0 + 0.01 * n);
+      num_evals = 0;
+      thetas.push_back(algebra_solver_newton(cubic_data_functor(), x_guess,
+                                             y, dat_a, dat_int));
+      evals_a += num_evals;
+      thetas.push_back(algebra_solver_newton(cubic_data_functor(), x_guess,
+                                             y, dat_b, dat_int));
+    }
+    return thetas;
+  };
+
+  int cold_evals_a;
+  std::vector<Eigen::VectorXd> cold = solve_all(cold_evals_a);
+  stan::math::algebra_solver_warm_start::enable(true);
+  int warm_evals_a;
+  std::vector<Eigen::VectorXd> warm = solve_all(warm_evals_a);
+
+  EXPECT_LT(warm_evals_a, cold_evals_a);
+  for (std::size_t n = 0; n < cold.size(); ++n) {
+    EXPECT_MATRIX_NEAR(cold[n], warm[n], 1e-6);
+  }
+  using Fs = stan::math::system_functor<cubic_data_functor, double, double,
+                                        true>;
+  EXPECT_EQ(2,
+            stan::math::internal::algebra_solver_warm_start_cache<Fs>::size());
+}
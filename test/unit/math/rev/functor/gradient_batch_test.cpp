@@ -0,0 +1,82 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using Eigen::Dynamic;
+using Eigen::Matrix;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+// fun1(x, y) = (x^2 * y) + (3 * y^2)
+struct fun1 {
+  template <typename T>
+  inline T operator()(const Matrix<T, Dynamic, 1>& x) const {
+    return x(0) * x(0) * x(1) + 3.0 * x(1) * x(1);
+  }
+};
+
+struct throwing_fun {
+  template <typename T>
+  inline T operator()(const Matrix<T, Dynamic, 1>& x) const {
+    if (x(0) < 0) {
+      throw std::domain_error("negative argument");
+    }
+    return x(0);
+  }
+};
+
+TEST(RevFunctor, gradient_batch) {
+  const int num_args = 100;
+  MatrixXd x(2, num_args);
+  for (int j = 0; j < num_args; ++j) {
+    x(0, j) = 0.1 * j;
+    x(1, j) = 5.0 - 0.2 * j;
+  }
+
+  VectorXd fx;
+  MatrixXd grad_fx;
+  stan::math::gradient_batch(fun1(), x, fx, grad_fx);
+  EXPECT_EQ(num_args, fx.size());
+  EXPECT_EQ(2, grad_fx.rows());
+  EXPECT_EQ(num_args, grad_fx.cols());
+
+  for (int j = 0; j < num_args; ++j) {
+    double fx_ref;
+    VectorXd grad_fx_ref;
+    stan::math::gradient(fun1(), VectorXd(x.col(j)), fx_ref, grad_fx_ref);
+    EXPECT_FLOAT_EQ(fx_ref, fx(j));
+    EXPECT_FLOAT_EQ(grad_fx_ref(0), grad_fx(0, j));
+    EXPECT_FLOAT_EQ(grad_fx_ref(1), grad_fx(1, j));
+  }
+
+  VectorXd fx_grain;
+  MatrixXd grad_fx_grain;
+  stan::math::gradient_batch(fun1(), x, fx_grain, grad_fx_grain, 7);
+  EXPECT_TRUE(fx.isApprox(fx_grain));
+  EXPECT_TRUE(grad_fx.isApprox(grad_fx_grain));
+
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(RevFunctor, gradient_batch_empty) {
+  MatrixXd x(3, 0);
+  VectorXd fx;
+  MatrixXd grad_fx;
+  stan::math::gradient_batch(fun1(), x, fx, grad_fx);
+  EXPECT_EQ(0, fx.size());
+  EXPECT_EQ(3, grad_fx.rows());
+  EXPECT_EQ(0, grad_fx.cols());
+}
+
+TEST(RevFunctor, gradient_batch_errors) {
+  MatrixXd x(1, 10);
+  x.setOnes();
+  x(0, 4) = -1.0;
+  VectorXd fx;
+  MatrixXd grad_fx;
+  EXPECT_THROW(stan::math::gradient_batch(throwing_fun(), x, fx, grad_fx),
+               std::domain_error);
+  EXPECT_THROW(stan::math::gradient_batch(fun1(), x, fx, grad_fx, 0),
+               std::domain_error);
+  EXPECT_TRUE(stan::math::empty_nested());
+}
@@ -0,0 +1,167 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <cmath>
+#include <vector>
+
+namespace integrate_dae_adjoint_test {
+
+// Robertson's chemical kinetics with the conservation law as
+// algebraic equation for the third species
+struct chemical_kinetics {
+  template <typename T0, typename TYY, typename TYP, typename TPAR>
+  inline std::vector<stan::return_type_t<TYY, TYP, TPAR>> operator()(
+      const T0& t_in, const std::vector<TYY>& yy, const std::vector<TYP>& yp,
+      const std::vector<TPAR>& theta, const std::vector<double>& x_r,
+      const std::vector<int>& x_i, std::ostream* msgs) const {
+    std::vector<stan::return_type_t<TYY, TYP, TPAR>> res(3);
+    res[0] = yp[0] + theta[0] * yy[0] - theta[1] * yy[1] * yy[2];
+    res[1] = yp[1] - theta[0] * yy[0] + theta[1] * yy[1] * yy[2]
+             + theta[2] * yy[1] * yy[1];
+    res[2] = yy[0] + yy[1] + yy[2] - 1.0;
+    return res;
+  }
+};
+
+std::vector<double> gradient(stan::math::var y,
+                             const std::vector<stan::math::var>& theta) {
+  stan::math::set_zero_all_adjoints();
+  y.grad();
+  std::vector<double> g(theta.size());
+  for (size_t i = 0; i < theta.size(); ++i) {
+    g[i] = theta[i].adj();
+  }
+  return g;
+}
+
+}  // namespace integrate_dae_adjoint_test
+
+TEST(StanIntegrateDAEAdjoint, matches_forward_sensitivities) {
+  using integrate_dae_adjoint_test::chemical_kinetics;
+  using integrate_dae_adjoint_test::gradient;
+  using stan::math::var;
+
+  std::vector<double> yy0 = {1.0, 0.0, 0.0};
+  std::vector<double> yp0 = {-0.04, 0.04, 0.0};
+  std::vector<double> ts = {0.4, 4.0, 40.0, 400.0};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  std::vector<var> theta = {0.040, 1.0e4, 3.0e7};
+  auto yy = stan::math::integrate_dae_adjoint(chemical_kinetics(), yy0, yp0,
+                                              0.0, ts, theta, x_r, x_i, 1e-8,
+                                              1e-12, 100000);
+  std::vector<var> theta_fwd = {0.040, 1.0e4, 3.0e7};
+  auto yy_fwd = stan::math::integrate_dae(chemical_kinetics(), yy0, yp0, 0.0,
+                                          ts, theta_fwd, x_r, x_i, 1e-8, 1e-12,
+                                          100000);
+
+  ASSERT_EQ(yy_fwd.size(), yy.size());
+  for (size_t n = 0; n < ts.size(); ++n) {
+    // the third species is the algebraic component
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_NEAR(yy_fwd[n][i].val(), yy[n][i].val(), 1e-6);
+      std::vector<double> g = gradient(yy[n][i], theta);
+      std::vector<double> g_fwd = gradient(yy_fwd[n][i], theta_fwd);
+      for (size_t j = 0; j < theta.size(); ++j) {
+        EXPECT_NEAR(g_fwd[j], g[j], 1e-5 * std::max(1.0, std::fabs(g_fwd[j])))
+            << "output " << n << " state " << i << " parameter " << j;
+      }
+    }
+  }
+
+  // adjoints of several outputs are accumulated in one backward solve
+  var loss = yy[0][0] + 2.0 * yy[1][2] - yy[3][1];
+  var loss_fwd = yy_fwd[0][0] + 2.0 * yy_fwd[1][2] - yy_fwd[3][1];
+  std::vector<double> g = gradient(loss, theta);
+  std::vector<double> g_fwd = gradient(loss_fwd, theta_fwd);
+  for (size_t j = 0; j < theta.size(); ++j) {
+    EXPECT_NEAR(g_fwd[j], g[j], 1e-5 * std::max(1.0, std::fabs(g_fwd[j])));
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(StanIntegrateDAEAdjoint, repeated_solves) {
+  using integrate_dae_adjoint_test::chemical_kinetics;
+  using integrate_dae_adjoint_test::gradient;
+  using stan::math::var;
+
+  std::vector<double> yy0 = {1.0, 0.0, 0.0};
+  std::vector<double> yp0 = {-0.04, 0.04, 0.0};
+  std::vector<double> ts = {0.4, 4.0};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  // later solves re-initialize the IDAS memory of the first solve,
+  // also with a different number of output times
+  std::vector<std::vector<double>> g(3);
+  for (size_t k = 0; k < g.size(); ++k) {
+    std::vector<var> theta = {0.040, 1.0e4, 3.0e7};
+    if (k == 2) {
+      ts.push_back(40.0);
+    }
+    auto yy = stan::math::integrate_dae_adjoint(chemical_kinetics(), yy0, yp0,
+                                                0.0, ts, theta, x_r, x_i,
+                                                1e-8, 1e-12, 100000, 20);
+    g[k] = gradient(yy[1][0], theta);
+    stan::math::recover_memory();
+  }
+  for (size_t j = 0; j < 3; ++j) {
+    EXPECT_FLOAT_EQ(g[0][j], g[1][j]);
+    EXPECT_FLOAT_EQ(g[0][j], g[2][j]);
+  }
+}
+
+TEST(StanIntegrateDAEAdjoint, data_only) {
+  using integrate_dae_adjoint_test::chemical_kinetics;
+
+  std::vector<double> yy0 = {1.0, 0.0, 0.0};
+  std::vector<double> yp0 = {-0.04, 0.04, 0.0};
+  std::vector<double> theta = {0.040, 1.0e4, 3.0e7};
+  std::vector<double> ts = {0.4, 4.0};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  auto yy = stan::math::integrate_dae_adjoint(chemical_kinetics(), yy0, yp0,
+                                              0.0, ts, theta, x_r, x_i, 1e-5,
+                                              1e-12);
+  EXPECT_NEAR(0.985172, yy[0][0], 1e-6);
+  EXPECT_NEAR(0.0147939, yy[0][2], 1e-6);
+  EXPECT_NEAR(0.905519, yy[1][0], 1e-6);
+  EXPECT_NEAR(0.0944588, yy[1][2], 1e-6);
+}
+
+TEST(StanIntegrateDAEAdjoint, errors) {
+  using integrate_dae_adjoint_test::chemical_kinetics;
+  using stan::math::var;
+
+  std::vector<double> yy0 = {1.0, 0.0, 0.0};
+  std::vector<double> yp0 = {-0.04, 0.04, 0.0};
+  std::vector<var> theta = {0.040, 1.0e4, 3.0e7};
+  std::vector<double> ts = {0.4, 4.0};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  std::vector<double> yp0_bad = {-0.04, 0.4, 0.0};
+  EXPECT_THROW_MSG(stan::math::integrate_dae_adjoint(
+                       chemical_kinetics(), yy0, yp0_bad, 0.0, ts, theta, x_r,
+                       x_i, 1e-5, 1e-12),
+                   std::domain_error, "DAE residual at t0");
+  std::vector<double> yy0_bad = {1.0, 0.0, 1.0};
+  EXPECT_THROW_MSG(stan::math::integrate_dae_adjoint(
+                       chemical_kinetics(), yy0_bad, yp0, 0.0, ts, theta, x_r,
+                       x_i, 1e-5, 1e-12),
+                   std::domain_error, "DAE residual at t0");
+  EXPECT_THROW(stan::math::integrate_dae_adjoint(chemical_kinetics(), yy0, yp0,
+                                                 0.0, ts, theta, x_r, x_i, 1e-5,
+                                                 1e-12, 100, 0),
+               std::domain_error);
+  EXPECT_THROW_MSG(stan::math::integrate_dae_adjoint(
+                       chemical_kinetics(), yy0, yp0, 0.0, {1.0e6}, theta, x_r,
+                       x_i, 1e-5, 1e-12, 10),
+                   std::domain_error,
+                   "Failed to integrate to next output time");
+
+  stan::math::recover_memory();
+}
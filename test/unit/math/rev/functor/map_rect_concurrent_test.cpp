@@ -163,3 +163,42 @@ TEST_F(map_rect, concurrent_eval_ok_vv) {
     }
   }
 }
+
+TEST_F(map_rect, concurrent_eval_ok_vv_weighted_sum) {
+  stan::math::vector_v shared_params_v = stan::math::to_var(shared_params_d);
+  std::vector<stan::math::vector_v> job_params_v;
+
+  for (std::size_t i = 0; i < N; i++)
+    job_params_v.push_back(stan::math::to_var(job_params_d[i]));
+
+  stan::math::vector_v res1 = stan::math::map_rect<0, hard_work>(
+      shared_params_v, job_params_v, x_r, x_i);
+
+  // one reverse sweep propagates the adjoints of all outputs at once
+  Eigen::VectorXd weights(2 * N);
+  for (std::size_t j = 0; j < 2 * N; j++)
+    weights(j) = 1.0 + 0.5 * j;
+  stan::math::var lp = stan::math::dot_product(weights, res1);
+
+  // the gradient is the same for repeated reverse sweeps
+  for (int sweep = 0; sweep < 2; sweep++) {
+    stan::math::set_zero_all_adjoints();
+    lp.grad();
+
+    double shared_adj_0 = 0;
+    double shared_adj_1 = 0;
+    for (std::size_t i = 0; i < N; i++) {
+      const double w0 = weights(2 * i);
+      const double w1 = weights(2 * i + 1);
+      shared_adj_0 += w0 + 2.0 * w1;
+      shared_adj_1 += w1;
+      EXPECT_FLOAT_EQ(job_params_v[i](0).vi_->adj_,
+                      w0 * 2.0 * job_params_d[i](0)
+                          + w1 * x_r[i][0] * job_params_d[i](1));
+      EXPECT_FLOAT_EQ(job_params_v[i](1).vi_->adj_,
+                      w1 * x_r[i][0] * job_params_d[i](0));
+    }
+    EXPECT_FLOAT_EQ(shared_params_v(0).vi_->adj_, shared_adj_0);
+    EXPECT_FLOAT_EQ(shared_params_v(1).vi_->adj_, shared_adj_1);
+  }
+}
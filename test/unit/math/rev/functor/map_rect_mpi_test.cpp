@@ -9,12 +9,30 @@
 #include <test/unit/math/prim/functor/hard_work.hpp>
 #include <test/unit/math/prim/functor/faulty_functor.hpp>
 
+#include <chrono>
 #include <iostream>
+#include <thread>
 #include <vector>
 
+// hard work whose run time grows with the job index, such that the
+// jobs get reassigned to the workers after the first evaluations
+struct slow_hard_work {
+  template <typename T1, typename T2>
+  Eigen::Matrix<stan::return_type_t<T1, T2>, Eigen::Dynamic, 1> operator()(
+      const Eigen::Matrix<T1, Eigen::Dynamic, 1>& eta,
+      const Eigen::Matrix<T2, Eigen::Dynamic, 1>& theta,
+      const std::vector<double>& x_r, const std::vector<int>& x_i,
+      std::ostream* msgs = 0) const {
+    std::this_thread::sleep_for(std::chrono::milliseconds(x_i[0] * x_i[0]));
+    return hard_work()(eta, theta, x_r, x_i, msgs);
+  }
+};
+
 STAN_REGISTER_MAP_RECT(0, hard_work)
 STAN_REGISTER_MAP_RECT(1, faulty_functor)
 STAN_REGISTER_MAP_RECT(2, faulty_functor)
+STAN_REGISTER_MAP_RECT(3, hard_work)
+STAN_REGISTER_MAP_RECT(4, slow_hard_work)
 
 struct MpiJob : public ::testing::Test {
   stan::math::vector_d shared_params_d;
@@ -173,4 +191,101 @@ TEST_F(MpiJob, always_faulty_functor_dv) {
                    std::domain_error, "MPI error on first evaluation.");
 }
 
+TEST_F(MpiJob, pipelined_consecutive_calls_vv) {
+  using stan::math::internal::map_rect_concurrent;
+  using stan::math::value_of;
+  using stan::math::var;
+
+  // once the output sizes are cached from the first call, the outputs
+  // are sent per job as soon as they are evaluated
+  for (int iter = 0; iter < 5; ++iter) {
+    shared_params_d(0) = 2.0 + iter;
+    for (std::size_t n = iter % 2; n < N; n += 2)
+      job_params_d[n] << n + 1.0 + iter, n * n - iter;
+
+    std::vector<stan::math::vector_v> job_mpi;
+    std::vector<stan::math::vector_v> job_concurrent;
+    for (std::size_t n = 0; n != N; ++n) {
+      job_mpi.push_back(job_params_d[n]);
+      job_concurrent.push_back(job_params_d[n]);
+    }
+    stan::math::vector_v shared_mpi = shared_params_d;
+    stan::math::vector_v shared_concurrent = shared_params_d;
+
+    stan::math::vector_v result_mpi
+        = stan::math::map_rect<3, hard_work>(shared_mpi, job_mpi, x_r, x_i);
+    stan::math::vector_v result_concurrent
+        = map_rect_concurrent<3, hard_work>(shared_concurrent, job_concurrent,
+                                            x_r, x_i, 0);
+    ASSERT_EQ(result_concurrent.rows(), result_mpi.rows());
+    EXPECT_MATRIX_FLOAT_EQ(value_of(result_concurrent), value_of(result_mpi));
+
+    // weight the outputs such that each one enters the gradient
+    var lp_mpi = 0;
+    var lp_concurrent = 0;
+    for (int i = 0; i < result_mpi.rows(); ++i) {
+      lp_mpi += (i + 1.0) * result_mpi(i);
+      lp_concurrent += (i + 1.0) * result_concurrent(i);
+    }
+    lp_mpi.grad();
+    stan::math::vector_d shared_adj_mpi = shared_mpi.adj();
+    std::vector<stan::math::vector_d> job_adj_mpi;
+    for (std::size_t n = 0; n != N; ++n)
+      job_adj_mpi.push_back(job_mpi[n].adj());
+
+    stan::math::set_zero_all_adjoints();
+    lp_concurrent.grad();
+    EXPECT_MATRIX_FLOAT_EQ(shared_concurrent.adj(), shared_adj_mpi);
+    for (std::size_t n = 0; n != N; ++n)
+      EXPECT_MATRIX_FLOAT_EQ(job_concurrent[n].adj(), job_adj_mpi[n]);
+    stan::math::recover_memory();
+  }
+}
+
+TEST_F(MpiJob, rebalance_alternating_dd_vv) {
+  using cache_chunks = stan::math::internal::mpi_parallel_call_cache<
+      4, 4, std::vector<int>>;
+  using stan::math::internal::map_rect_concurrent;
+  using stan::math::var;
+  boost::mpi::communicator world;
+  const std::size_t world_size = world.size();
+
+  // the data and the var evaluations of one call_id share the job
+  // assignment, which changes in between, while only few parameters
+  // change such that most parameters are not sent again
+  for (int iter = 0; iter < 6; ++iter) {
+    shared_params_d(1) = iter;
+    job_params_d[iter](1) = -1.0 - iter;
+
+    const stan::math::vector_d expected
+        = map_rect_concurrent<4, slow_hard_work>(shared_params_d,
+                                                 job_params_d, x_r, x_i, 0);
+    if (iter % 2 == 0) {
+      stan::math::vector_d result = stan::math::map_rect<4, slow_hard_work>(
+          shared_params_d, job_params_d, x_r, x_i);
+      EXPECT_MATRIX_FLOAT_EQ(expected, result);
+      continue;
+    }
+
+    stan::math::vector_v shared_v = shared_params_d;
+    std::vector<stan::math::vector_v> job_v;
+    for (std::size_t n = 0; n != N; ++n)
+      job_v.push_back(job_params_d[n]);
+    stan::math::vector_v result = stan::math::map_rect<4, slow_hard_work>(
+        shared_v, job_v, x_r, x_i);
+    EXPECT_MATRIX_FLOAT_EQ(expected, stan::math::value_of(result));
+
+    // the first two outputs of each job depend on theta(0)
+    stan::math::sum(result).grad();
+    for (std::size_t n = 0; n != N; ++n)
+      EXPECT_FLOAT_EQ(2.0 * job_params_d[n](0) + x_r[n][0] * job_params_d[n](1),
+                      job_v[n](0).adj());
+    stan::math::recover_memory();
+  }
+
+  if (world_size > 1) {
+    EXPECT_NE(stan::math::mpi_map_chunks(N, 1), cache_chunks::data());
+  }
+}
+
 #endif
@@ -0,0 +1,162 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_auto_test {
+
+struct harmonic_oscillator {
+  template <typename T0, typename T_y, typename T_theta>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_theta>& theta) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1> dydt(
+        2);
+    dydt << y(1), -y(0) - theta[0] * y(1);
+    return dydt;
+  }
+};
+
+// Robertson's chemical kinetics, which becomes stiff once the
+// concentrations of the second and third species build up
+struct robertson {
+  template <typename T0, typename T_y, typename T_k>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_k>& k) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1> dydt(3);
+    dydt << -k[0] * y(0) + k[1] * y(1) * y(2),
+        k[0] * y(0) - k[1] * y(1) * y(2) - k[2] * y(1) * y(1),
+        k[2] * y(1) * y(1);
+    return dydt;
+  }
+};
+
+}  // namespace ode_auto_test
+
+TEST(StanMathOde_ode_auto, non_stiff_matches_rk45) {
+  using ode_auto_test::harmonic_oscillator;
+  using stan::math::ode_stats;
+  using stan::math::var;
+
+  std::vector<double> ts = {0.5, 1.0, 1.0, 4.0, 10.0};
+
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(2);
+  y0 << 1.0, 0.5;
+  std::vector<var> theta = {0.15};
+  ode_stats stats;
+  auto ys = stan::math::ode_auto_tol(harmonic_oscillator(), y0, 0.0, ts,
+                                     1e-8, 1e-8, 100000, stats, nullptr,
+                                     theta);
+  EXPECT_EQ(0, stats.num_method_switches);
+  EXPECT_EQ(0, stats.num_jacobian_evals);
+  ys[4](0).grad();
+  std::vector<double> g = {y0(0).adj(), y0(1).adj(), theta[0].adj()};
+  stan::math::set_zero_all_adjoints();
+
+  auto ys_rk45 = stan::math::ode_rk45_tol(harmonic_oscillator(), y0, 0.0, ts,
+                                          1e-8, 1e-8, 100000, nullptr, theta);
+  ys_rk45[4](0).grad();
+  std::vector<double> g_rk45 = {y0(0).adj(), y0(1).adj(), theta[0].adj()};
+
+  ASSERT_EQ(ys_rk45.size(), ys.size());
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_NEAR(ys_rk45[n](i).val(), ys[n](i).val(), 1e-7);
+    }
+  }
+  for (size_t i = 0; i < g.size(); ++i) {
+    EXPECT_NEAR(g_rk45[i], g[i], 1e-7);
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_auto, switches_to_bdf) {
+  using ode_auto_test::robertson;
+  using stan::math::ode_stats;
+  using stan::math::var;
+
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, 0.0, 0.0;
+  std::vector<double> ts = {1e-4, 1e-3, 0.1, 1.0, 10.0, 100.0};
+
+  std::vector<var> k = {0.04, 1.0e4, 3.0e7};
+  ode_stats stats;
+  auto ys = stan::math::ode_auto_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10,
+                                     100000, stats, nullptr, k);
+  EXPECT_EQ(1, stats.num_method_switches);
+  EXPECT_GT(stats.num_jacobian_evals, 0);
+  EXPECT_GT(stats.num_sensitivity_rhs_evals, 0);
+
+  std::vector<var> k_bdf = {0.04, 1.0e4, 3.0e7};
+  ode_stats bdf_stats;
+  auto ys_bdf = stan::math::ode_bdf_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10,
+                                        100000, bdf_stats, nullptr, k_bdf);
+
+  ASSERT_EQ(ys_bdf.size(), ys.size());
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(ys_bdf[n](i).val(), ys[n](i).val(), 1e-6)
+          << "output " << n << " state " << i;
+    }
+  }
+
+  for (size_t n = 0; n < ts.size(); ++n) {
+    stan::math::set_zero_all_adjoints();
+    ys[n](0).grad();
+    std::vector<double> g = stan::math::value_of(k);
+    for (size_t i = 0; i < k.size(); ++i) {
+      g[i] = k[i].adj();
+    }
+    stan::math::set_zero_all_adjoints();
+    ys_bdf[n](0).grad();
+    for (size_t i = 0; i < k.size(); ++i) {
+      EXPECT_NEAR(k_bdf[i].adj(), g[i],
+                  1e-4 * std::max(1e-4, std::fabs(k_bdf[i].adj())))
+          << "output " << n << " parameter " << i;
+    }
+  }
+
+  // the non-stiff method alone runs out of steps
+  std::vector<double> k_d = stan::math::value_of(k);
+  EXPECT_THROW(stan::math::ode_rk45_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10,
+                                        stats.num_steps, nullptr, k_d),
+               std::domain_error);
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_auto, data_only) {
+  using ode_auto_test::robertson;
+
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, 0.0, 0.0;
+  std::vector<double> k = {0.04, 1.0e4, 3.0e7};
+  std::vector<double> ts = {1.0, 10.0, 100.0};
+
+  auto ys = stan::math::ode_auto(robertson(), y0, 0.0, ts, nullptr, k);
+  auto ys_bdf = stan::math::ode_bdf_tol(robertson(), y0, 0.0, ts, 1e-8,
+                                        1e-10, 100000, nullptr, k);
+  ASSERT_EQ(ys_bdf.size(), ys.size());
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(ys_bdf[n](i), ys[n](i), 1e-5);
+    }
+  }
+}
+
+TEST(StanMathOde_ode_auto, too_much_work) {
+  using ode_auto_test::harmonic_oscillator;
+
+  Eigen::VectorXd y0(2);
+  y0 << 1.0, 0.5;
+  std::vector<double> theta = {0.15};
+  std::vector<double> ts = {1000.0};
+
+  EXPECT_THROW_MSG(stan::math::ode_auto_tol(harmonic_oscillator(), y0, 0.0,
+                                            ts, 1e-8, 1e-8, 10, nullptr,
+                                            theta),
+                   std::domain_error,
+                   "Failed to integrate to next output time");
+}
@@ -0,0 +1,172 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_batch_rev_test {
+
+// damped oscillator with system specific parameters
+struct oscillator {
+  template <typename T0, typename T_y, typename T_theta, typename T_scale>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_theta, T_scale>,
+                       Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_theta>& theta,
+             const T_scale& scale) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_theta, T_scale>, Eigen::Dynamic,
+                  1>
+        dydt(2);
+    dydt << y(1), -scale * y(0) - theta[0] * y(1);
+    return dydt;
+  }
+};
+
+template <typename Batch, typename Single>
+void test_batch(const Batch& batch, const Single& single) {
+  using stan::math::var;
+  const std::size_t num_systems = 4;
+
+  auto make_args = [&](std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>>& y0,
+                       std::vector<std::vector<var>>& theta, var& scale) {
+    y0.clear();
+    theta.clear();
+    for (std::size_t k = 0; k < num_systems; ++k) {
+      Eigen::Matrix<var, Eigen::Dynamic, 1> y0_k(2);
+      y0_k << 1.0 + k, 0.5;
+      y0.push_back(y0_k);
+      theta.push_back(std::vector<var>{0.1 + 0.2 * k});
+    }
+    scale = 2.0;
+  };
+
+  std::vector<std::vector<double>> ts(num_systems);
+  for (std::size_t k = 0; k < num_systems; ++k)
+    for (std::size_t j = 0; j < 2 + k; ++j)
+      ts[k].push_back(0.3 * (j + 1));
+
+  // the shared scale enters every system as a separate argument
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> y0_b;
+  std::vector<std::vector<var>> theta_b;
+  var scale_b;
+  make_args(y0_b, theta_b, scale_b);
+  std::vector<var> scale_bs(num_systems, scale_b);
+  auto ys_b = batch(y0_b, ts, theta_b, scale_bs);
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> y0_s;
+  std::vector<std::vector<var>> theta_s;
+  var scale_s;
+  make_args(y0_s, theta_s, scale_s);
+
+  var lp_b = 0;
+  var lp_s = 0;
+  ASSERT_EQ(num_systems, ys_b.size());
+  for (std::size_t k = 0; k < num_systems; ++k) {
+    auto ys_s = single(y0_s[k], ts[k], theta_s[k], scale_s);
+    ASSERT_EQ(ys_s.size(), ys_b[k].size());
+    for (std::size_t j = 0; j < ys_s.size(); ++j) {
+      EXPECT_MATRIX_NEAR(stan::math::value_of(ys_s[j]),
+                         stan::math::value_of(ys_b[k][j]), 1e-8);
+      lp_b += (j + 1.0) * ys_b[k][j](0) - ys_b[k][j](1) * ys_b[k][j](1);
+      lp_s += (j + 1.0) * ys_s[j](0) - ys_s[j](1) * ys_s[j](1);
+    }
+  }
+
+  lp_b.grad();
+  std::vector<double> theta_adj_b(num_systems);
+  std::vector<Eigen::VectorXd> y0_adj_b(num_systems);
+  for (std::size_t k = 0; k < num_systems; ++k) {
+    theta_adj_b[k] = theta_b[k][0].adj();
+    y0_adj_b[k] = y0_b[k].adj();
+  }
+  double scale_adj_b = scale_b.adj();
+
+  stan::math::set_zero_all_adjoints();
+  lp_s.grad();
+  for (std::size_t k = 0; k < num_systems; ++k) {
+    EXPECT_NEAR(theta_s[k][0].adj(), theta_adj_b[k], 1e-6);
+    for (int i = 0; i < 2; ++i)
+      EXPECT_NEAR(y0_s[k](i).adj(), y0_adj_b[k](i), 1e-6);
+  }
+  EXPECT_NEAR(scale_s.adj(), scale_adj_b, 1e-6);
+
+  stan::math::recover_memory();
+}
+
+}  // namespace ode_batch_rev_test
+
+TEST(StanMathOde_ode_batch, rk45_gradients) {
+  using ode_batch_rev_test::oscillator;
+  ode_batch_rev_test::test_batch(
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& scale) {
+        return stan::math::ode_rk45_tol_batch(oscillator(), y0, 0.0, ts, 1e-8,
+                                              1e-8, 100000, nullptr, theta,
+                                              scale);
+      },
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& scale) {
+        return stan::math::ode_rk45_tol(oscillator(), y0, 0.0, ts, 1e-8, 1e-8,
+                                        100000, nullptr, theta, scale);
+      });
+}
+
+TEST(StanMathOde_ode_batch, bdf_gradients) {
+  using ode_batch_rev_test::oscillator;
+  ode_batch_rev_test::test_batch(
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& scale) {
+        return stan::math::ode_bdf_batch(oscillator(), y0, 0.0, ts, nullptr,
+                                         theta, scale);
+      },
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& scale) {
+        return stan::math::ode_bdf(oscillator(), y0, 0.0, ts, nullptr, theta,
+                                   scale);
+      });
+}
+
+TEST(StanMathOde_ode_batch, adams_gradients) {
+  using ode_batch_rev_test::oscillator;
+  ode_batch_rev_test::test_batch(
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& scale) {
+        return stan::math::ode_adams_batch(oscillator(), y0, 0.0, ts, nullptr,
+                                           theta, scale);
+      },
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& scale) {
+        return stan::math::ode_adams(oscillator(), y0, 0.0, ts, nullptr, theta,
+                                     scale);
+      });
+}
+
+TEST(StanMathOde_ode_batch, data_initial_state) {
+  using ode_batch_rev_test::oscillator;
+  using stan::math::var;
+
+  std::vector<Eigen::VectorXd> y0(3, Eigen::VectorXd::Ones(2));
+  std::vector<std::vector<double>> ts(3, std::vector<double>{0.5, 1.0});
+  std::vector<std::vector<var>> theta;
+  for (std::size_t k = 0; k < 3; ++k)
+    theta.push_back(std::vector<var>{0.3});
+  std::vector<double> scale(3, 1.5);
+
+  auto ys = stan::math::ode_bdf_batch(oscillator(), y0, 0.0, ts, nullptr,
+                                      theta, scale);
+  ys[2][1](0).grad();
+  std::vector<double> theta_adj(3);
+  for (std::size_t k = 0; k < 3; ++k)
+    theta_adj[k] = theta[k][0].adj();
+
+  stan::math::set_zero_all_adjoints();
+  var theta_s = 0.3;
+  auto ys_s = stan::math::ode_bdf(oscillator(), y0[2], 0.0, ts[2], nullptr,
+                                  std::vector<var>{theta_s}, 1.5);
+  ys_s[1](0).grad();
+
+  EXPECT_NEAR(theta_s.adj(), theta_adj[2], 1e-6);
+  EXPECT_FLOAT_EQ(0.0, theta_adj[0]);
+  EXPECT_FLOAT_EQ(0.0, theta_adj[1]);
+
+  stan::math::recover_memory();
+}
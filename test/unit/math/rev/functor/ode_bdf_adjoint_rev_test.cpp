@@ -0,0 +1,218 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_bdf_adjoint_rev_test {
+
+// damped oscillator with a time dependent forcing term
+struct forced_oscillator {
+  template <typename T0, typename T_y, typename T_theta>
+  inline Eigen::Matrix<stan::return_type_t<T0, T_y, T_theta>, Eigen::Dynamic,
+                       1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_theta>& theta,
+             const Eigen::VectorXd& x) const {
+    Eigen::Matrix<stan::return_type_t<T0, T_y, T_theta>, Eigen::Dynamic, 1>
+        dydt(2);
+    dydt << y(1), -theta[0] * y(0) - theta[1] * y(1) + x(0) * sin(t);
+    return dydt;
+  }
+};
+
+// linear decay whose rate is the weighted sum of many parameters
+struct many_rates {
+  template <typename T0, typename T_y, typename T_k>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs,
+             const Eigen::Matrix<T_k, Eigen::Dynamic, 1>& k) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1> dydt(1);
+    dydt << -stan::math::sum(k) * y(0) / k.size();
+    return dydt;
+  }
+};
+
+template <typename Solve>
+std::vector<double> forced_oscillator_grad(const Solve& solve) {
+  using stan::math::var;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(2);
+  y0 << 1.0, -0.5;
+  var t0 = 0.1;
+  std::vector<var> ts = {0.6, 1.2, 1.2, 2.5};
+  std::vector<var> theta = {2.0, 0.3};
+  Eigen::VectorXd x(1);
+  x << 0.7;
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ys
+      = solve(y0, t0, ts, theta, x);
+
+  var lp = 0;
+  for (size_t n = 0; n < ys.size(); ++n) {
+    lp += (n + 1.0) * ys[n](0) - ys[n](1) * ys[n](1);
+  }
+  lp.grad();
+
+  std::vector<double> g = {lp.val(),       y0(0).adj(),    y0(1).adj(),
+                           t0.adj(),       theta[0].adj(), theta[1].adj()};
+  for (const var& t : ts) {
+    g.push_back(t.adj());
+  }
+  stan::math::recover_memory();
+  return g;
+}
+
+}  // namespace ode_bdf_adjoint_rev_test
+
+TEST(StanMathOde_ode_bdf_adjoint, matches_forward_sensitivities) {
+  using ode_bdf_adjoint_rev_test::forced_oscillator;
+  std::vector<double> g_forward = ode_bdf_adjoint_rev_test::
+      forced_oscillator_grad([](const auto& y0, const auto& t0,
+                                const auto& ts, const auto& theta,
+                                const auto& x) {
+        return stan::math::ode_bdf(forced_oscillator(), y0, t0, ts, nullptr,
+                                   theta, x);
+      });
+  std::vector<double> g_adjoint = ode_bdf_adjoint_rev_test::
+      forced_oscillator_grad([](const auto& y0, const auto& t0,
+                                const auto& ts, const auto& theta,
+                                const auto& x) {
+        return stan::math::ode_bdf_adjoint(forced_oscillator(), y0, t0, ts,
+                                           nullptr, theta, x);
+      });
+
+  ASSERT_EQ(g_forward.size(), g_adjoint.size());
+  for (size_t i = 0; i < g_forward.size(); ++i) {
+    EXPECT_NEAR(g_forward[i], g_adjoint[i], 1e-6) << "entry " << i;
+  }
+}
+
+TEST(StanMathOde_ode_bdf_adjoint, checkpoint_spacing) {
+  using ode_bdf_adjoint_rev_test::forced_oscillator;
+  std::vector<double> g_dense = ode_bdf_adjoint_rev_test::
+      forced_oscillator_grad([](const auto& y0, const auto& t0,
+                                const auto& ts, const auto& theta,
+                                const auto& x) {
+        return stan::math::ode_bdf_adjoint_tol(forced_oscillator(), y0, t0,
+                                               ts, 1e-10, 1e-10, 100000, 1,
+                                               nullptr, theta, x);
+      });
+  std::vector<double> g_sparse = ode_bdf_adjoint_rev_test::
+      forced_oscillator_grad([](const auto& y0, const auto& t0,
+                                const auto& ts, const auto& theta,
+                                const auto& x) {
+        return stan::math::ode_bdf_adjoint_tol(forced_oscillator(), y0, t0,
+                                               ts, 1e-10, 1e-10, 100000, 5000,
+                                               nullptr, theta, x);
+      });
+
+  ASSERT_EQ(g_dense.size(), g_sparse.size());
+  for (size_t i = 0; i < g_dense.size(); ++i) {
+    EXPECT_NEAR(g_dense[i], g_sparse[i], 1e-6) << "entry " << i;
+  }
+}
+
+TEST(StanMathOde_ode_bdf_adjoint, many_parameters) {
+  using ode_bdf_adjoint_rev_test::many_rates;
+  using stan::math::var;
+
+  const int num_rates = 200;
+  Eigen::VectorXd y0 = Eigen::VectorXd::Ones(1);
+  std::vector<double> ts = {0.5, 1.0};
+  Eigen::Matrix<var, Eigen::Dynamic, 1> k(num_rates);
+  for (int j = 0; j < num_rates; ++j) {
+    k(j) = 0.5 + 0.01 * j;
+  }
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ys
+      = stan::math::ode_bdf_adjoint(many_rates(), y0, 0.0, ts, nullptr, k);
+  ys[1](0).grad();
+
+  // y(t) = exp(-mean(k) * t)
+  const double mean_k = stan::math::value_of(stan::math::mean(k));
+  EXPECT_NEAR(std::exp(-mean_k * ts[1]), ys[1](0).val(), 1e-8);
+  for (int j = 0; j < num_rates; ++j) {
+    EXPECT_NEAR(-ts[1] / num_rates * std::exp(-mean_k * ts[1]), k(j).adj(),
+                1e-8);
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_bdf_adjoint, repeated_reverse_pass) {
+  using ode_bdf_adjoint_rev_test::forced_oscillator;
+  using stan::math::var;
+
+  Eigen::VectorXd y0(2);
+  y0 << 1.0, -0.5;
+  std::vector<double> ts = {0.6, 1.2};
+  std::vector<var> theta = {2.0, 0.3};
+  Eigen::VectorXd x(1);
+  x << 0.7;
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ys
+      = stan::math::ode_bdf_adjoint(forced_oscillator(), y0, 0.0, ts, nullptr,
+                                    theta, x);
+
+  ys[1](0).grad();
+  std::vector<double> theta_adj = {theta[0].adj(), theta[1].adj()};
+
+  stan::math::set_zero_all_adjoints();
+  ys[1](0).grad();
+  EXPECT_FLOAT_EQ(theta_adj[0], theta[0].adj());
+  EXPECT_FLOAT_EQ(theta_adj[1], theta[1].adj());
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_bdf_adjoint, data_only) {
+  using ode_bdf_adjoint_rev_test::forced_oscillator;
+
+  Eigen::VectorXd y0(2);
+  y0 << 1.0, -0.5;
+  std::vector<double> ts = {0.6, 1.2};
+  std::vector<double> theta = {2.0, 0.3};
+  Eigen::VectorXd x(1);
+  x << 0.7;
+
+  std::vector<Eigen::VectorXd> ys_adjoint = stan::math::ode_bdf_adjoint(
+      forced_oscillator(), y0, 0.0, ts, nullptr, theta, x);
+  std::vector<Eigen::VectorXd> ys = stan::math::ode_bdf(
+      forced_oscillator(), y0, 0.0, ts, nullptr, theta, x);
+
+  ASSERT_EQ(ys.size(), ys_adjoint.size());
+  for (size_t n = 0; n < ys.size(); ++n) {
+    EXPECT_MATRIX_FLOAT_EQ(ys[n], ys_adjoint[n]);
+  }
+}
+
+TEST(StanMathOde_ode_bdf_adjoint, errors) {
+  using ode_bdf_adjoint_rev_test::forced_oscillator;
+  using stan::math::var;
+
+  Eigen::VectorXd y0(2);
+  y0 << 1.0, -0.5;
+  std::vector<double> ts = {0.6, 1.2};
+  std::vector<var> theta = {2.0, 0.3};
+  Eigen::VectorXd x(1);
+  x << 0.7;
+
+  EXPECT_THROW(stan::math::ode_bdf_adjoint_tol(forced_oscillator(), y0, 0.0,
+                                               ts, 1e-8, 1e-8, 1000, 0,
+                                               nullptr, theta, x),
+               std::domain_error);
+  EXPECT_THROW(stan::math::ode_bdf_adjoint_tol(forced_oscillator(), y0, 0.0,
+                                               ts, -1e-8, 1e-8, 1000, 100,
+                                               nullptr, theta, x),
+               std::domain_error);
+  EXPECT_THROW(stan::math::ode_bdf_adjoint(forced_oscillator(), y0, 1.0, ts,
+                                           nullptr, theta, x),
+               std::domain_error);
+  std::vector<double> ts_long = {0.6, 1000.0};
+  EXPECT_THROW(stan::math::ode_bdf_adjoint_tol(forced_oscillator(), y0, 0.0,
+                                               ts_long, 1e-8, 1e-8, 2, 100,
+                                               nullptr, theta, x),
+               std::domain_error);
+
+  stan::math::recover_memory();
+}
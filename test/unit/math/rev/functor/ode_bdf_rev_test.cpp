@@ -545,3 +545,57 @@ TEST(StanMathOde_ode_bdf, arg_combos_test) {
   check_ts(ts);
   check_a(a);
 }
+
+struct decay_chain {
+  template <typename T0, typename T_y, typename T_k>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_k>& k) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1> dydt(
+        y.size());
+    dydt(0) = -k[0] * y(0);
+    for (int i = 1; i < y.size(); ++i) {
+      dydt(i) = k[i - 1] * y(i - 1) - k[i] * y(i);
+    }
+    return dydt;
+  }
+};
+
+TEST(StanMathOde_ode_bdf, many_sensitivities) {
+  const int N = 8;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(N);
+  std::vector<var> k(N);
+  for (int i = 0; i < N; ++i) {
+    y0(i) = 1.0 / (i + 1);
+    k[i] = 0.3 + 0.1 * i;
+  }
+  std::vector<double> ts = {0.5, 2.0};
+
+  auto grads = [&](const std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>>&
+                       ys) {
+    stan::math::set_zero_all_adjoints();
+    stan::math::sum(ys[1]).grad();
+    std::vector<double> g;
+    for (int i = 0; i < N; ++i) {
+      g.push_back(y0(i).adj());
+      g.push_back(k[i].adj());
+    }
+    return g;
+  };
+
+  auto ys_bdf = stan::math::ode_bdf_tol(decay_chain(), y0, 0.0, ts, 1e-10,
+                                        1e-10, 100000, nullptr, k);
+  std::vector<double> g_bdf = grads(ys_bdf);
+  auto ys_rk45 = stan::math::ode_rk45_tol(decay_chain(), y0, 0.0, ts, 1e-10,
+                                          1e-10, 100000, nullptr, k);
+  std::vector<double> g_rk45 = grads(ys_rk45);
+
+  for (int i = 0; i < N; ++i) {
+    EXPECT_NEAR(ys_rk45[1](i).val(), ys_bdf[1](i).val(), 1e-7);
+  }
+  for (size_t i = 0; i < g_bdf.size(); ++i) {
+    EXPECT_NEAR(g_rk45[i], g_bdf[i], 1e-6) << "gradient " << i;
+  }
+
+  stan::math::recover_memory();
+}
@@ -0,0 +1,216 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_cvodes_linear_solver_rev_test {
+
+// diffusion along a chain with decay and a feed two sites downstream,
+// which has one upper and two lower bands
+struct diffusion_chain {
+  template <typename T0, typename T_y, typename T_theta>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_theta>& theta) const {
+    const int N = y.size();
+    Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1> dydt(
+        N);
+    for (int i = 0; i < N; ++i) {
+      dydt(i) = -(2 * theta[0] + theta[1]) * y(i);
+      if (i > 0) {
+        dydt(i) += theta[0] * y(i - 1);
+      }
+      if (i + 1 < N) {
+        dydt(i) += theta[0] * y(i + 1);
+      }
+      if (i > 1) {
+        dydt(i) += theta[2] * y(i - 2);
+      }
+    }
+    return dydt;
+  }
+};
+
+// elementwise quadratic decay, whose jacobian depends on the states
+struct quadratic_decay {
+  template <typename T0, typename T_y, typename T_theta>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_theta>& theta) const {
+    return -theta[0] * y.cwiseProduct(y);
+  }
+};
+
+template <typename Solve>
+std::vector<double> solve_and_grad(const Solve& solve) {
+  using stan::math::var;
+  const int N = 30;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(N);
+  for (int i = 0; i < N; ++i) {
+    y0(i) = std::exp(-0.1 * (i - 10) * (i - 10));
+  }
+  std::vector<var> theta = {3.0, 0.2, 0.5};
+  std::vector<double> ts = {0.5, 1.0, 2.0};
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ys
+      = solve(y0, ts, theta);
+
+  var lp = 0;
+  for (size_t n = 0; n < ys.size(); ++n) {
+    for (int i = 0; i < N; ++i) {
+      lp += (i + n + 1.0) * ys[n](i);
+    }
+  }
+  lp.grad();
+
+  std::vector<double> g{lp.val()};
+  for (int i = 0; i < N; ++i) {
+    g.push_back(y0(i).adj());
+  }
+  for (const var& theta_j : theta) {
+    g.push_back(theta_j.adj());
+  }
+  stan::math::recover_memory();
+  return g;
+}
+
+template <typename Solve>
+void expect_same_results(const Solve& solve) {
+  using stan::math::cvodes_linear_solver;
+  std::vector<double> g_dense
+      = solve_and_grad([&](const auto& y0, const auto& ts, const auto& theta) {
+          return solve(y0, ts, theta, cvodes_linear_solver::dense());
+        });
+
+  std::vector<cvodes_linear_solver> solvers
+      = {cvodes_linear_solver::band(2, 1), cvodes_linear_solver::band(3, 4),
+         cvodes_linear_solver::spgmr(), cvodes_linear_solver::spbcgs(10)};
+  for (const cvodes_linear_solver& linear_solver : solvers) {
+    std::vector<double> g = solve_and_grad(
+        [&](const auto& y0, const auto& ts, const auto& theta) {
+          return solve(y0, ts, theta, linear_solver);
+        });
+    ASSERT_EQ(g_dense.size(), g.size());
+    for (size_t i = 0; i < g.size(); ++i) {
+      EXPECT_NEAR(g_dense[i], g[i], 1e-5 * (1 + std::fabs(g_dense[i])))
+          << "entry " << i;
+    }
+  }
+}
+
+}  // namespace ode_cvodes_linear_solver_rev_test
+
+TEST(StanMathOde_cvodes_linear_solver, bdf) {
+  using ode_cvodes_linear_solver_rev_test::diffusion_chain;
+  ode_cvodes_linear_solver_rev_test::expect_same_results(
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& linear_solver) {
+        return stan::math::ode_bdf_tol(diffusion_chain(), y0, 0.0, ts, 1e-10,
+                                       1e-10, 100000, linear_solver, nullptr,
+                                       theta);
+      });
+}
+
+TEST(StanMathOde_cvodes_linear_solver, adams) {
+  using ode_cvodes_linear_solver_rev_test::diffusion_chain;
+  ode_cvodes_linear_solver_rev_test::expect_same_results(
+      [](const auto& y0, const auto& ts, const auto& theta,
+         const auto& linear_solver) {
+        return stan::math::ode_adams_tol(diffusion_chain(), y0, 0.0, ts,
+                                         1e-10, 1e-10, 100000, linear_solver,
+                                         nullptr, theta);
+      });
+}
+
+TEST(StanMathOde_cvodes_linear_solver, preconditioner) {
+  using ode_cvodes_linear_solver_rev_test::diffusion_chain;
+  using stan::math::cvodes_linear_solver;
+
+  // Jacobi preconditioner for I - gamma * J
+  const std::vector<double> theta = {3.0, 0.2, 0.5};
+  int num_setups = 0;
+  int num_solves = 0;
+  Eigen::VectorXd diagonal;
+  cvodes_linear_solver linear_solver = cvodes_linear_solver::spgmr();
+  linear_solver.preconditioner(
+      [&](double t, const Eigen::VectorXd& y, const Eigen::MatrixXd& J,
+          double gamma) {
+        EXPECT_FLOAT_EQ(-(2 * theta[0] + theta[1]), J(0, 0));
+        diagonal = 1.0 - gamma * J.diagonal().array();
+        ++num_setups;
+      },
+      [&](double t, const Eigen::VectorXd& y, const Eigen::VectorXd& r,
+          double gamma) -> Eigen::VectorXd {
+        ++num_solves;
+        return r.cwiseQuotient(diagonal);
+      });
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::LinSpaced(30, 1.0, 0.0);
+  std::vector<double> ts = {0.5, 1.0, 2.0};
+  std::vector<Eigen::VectorXd> ys = stan::math::ode_bdf_tol(
+      diffusion_chain(), y0, 0.0, ts, 1e-10, 1e-10, 100000, linear_solver,
+      nullptr, theta);
+  std::vector<Eigen::VectorXd> ys_dense = stan::math::ode_bdf_tol(
+      diffusion_chain(), y0, 0.0, ts, 1e-10, 1e-10, 100000, nullptr, theta);
+
+  EXPECT_GT(num_setups, 0);
+  EXPECT_GT(num_solves, 0);
+  ASSERT_EQ(ys_dense.size(), ys.size());
+  for (size_t n = 0; n < ys.size(); ++n) {
+    EXPECT_MATRIX_NEAR(ys_dense[n], ys[n], 1e-7);
+  }
+}
+
+TEST(StanMathOde_cvodes_linear_solver, preconditioner_reuses_jacobian) {
+  using ode_cvodes_linear_solver_rev_test::quadratic_decay;
+  using stan::math::cvodes_linear_solver;
+
+  const std::vector<double> theta = {2.0};
+  int num_setups = 0;
+  int num_current = 0;
+  Eigen::VectorXd diagonal;
+  cvodes_linear_solver linear_solver = cvodes_linear_solver::spgmr();
+  linear_solver.preconditioner(
+      [&](double t, const Eigen::VectorXd& y, const Eigen::MatrixXd& J,
+          double gamma) {
+        // the jacobian is recomputed on some setups only and is
+        // otherwise the one of an earlier state
+        if (J.diagonal().isApprox(-2 * theta[0] * y)) {
+          ++num_current;
+        }
+        diagonal = 1.0 - gamma * J.diagonal().array();
+        ++num_setups;
+      },
+      [&](double t, const Eigen::VectorXd& y, const Eigen::VectorXd& r,
+          double gamma) -> Eigen::VectorXd {
+        return r.cwiseQuotient(diagonal);
+      });
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::LinSpaced(5, 1.0, 5.0);
+  std::vector<double> ts = {1.0, 10.0, 100.0};
+  std::vector<Eigen::VectorXd> ys = stan::math::ode_bdf_tol(
+      quadratic_decay(), y0, 0.0, ts, 1e-10, 1e-10, 100000, linear_solver,
+      nullptr, theta);
+
+  EXPECT_GT(num_current, 0);
+  EXPECT_LT(num_current, num_setups);
+  for (size_t n = 0; n < ys.size(); ++n) {
+    Eigen::VectorXd y_exact
+        = y0.array() / (1.0 + theta[0] * ts[n] * y0.array());
+    EXPECT_MATRIX_NEAR(y_exact, ys[n], 1e-7);
+  }
+}
+
+TEST(StanMathOde_cvodes_linear_solver, errors) {
+  using stan::math::cvodes_linear_solver;
+  EXPECT_THROW(cvodes_linear_solver::band(-1, 1), std::domain_error);
+  EXPECT_THROW(cvodes_linear_solver::band(1, -1), std::domain_error);
+  EXPECT_THROW(cvodes_linear_solver::spgmr(-1), std::domain_error);
+  EXPECT_THROW(
+      cvodes_linear_solver::dense().preconditioner(
+          [](double t, const Eigen::VectorXd& y, const Eigen::MatrixXd& J,
+             double gamma) {},
+          [](double t, const Eigen::VectorXd& y, const Eigen::VectorXd& r,
+             double gamma) -> Eigen::VectorXd { return r; }),
+      std::invalid_argument);
+}
@@ -0,0 +1,177 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_stats_test {
+
+// Robertson's chemical kinetics, which is stiff
+struct robertson {
+  template <typename T0, typename T_y, typename T_k>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_k>& k) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_k>, Eigen::Dynamic, 1> dydt(3);
+    dydt << -k[0] * y(0) + k[1] * y(1) * y(2),
+        k[0] * y(0) - k[1] * y(1) * y(2) - k[2] * y(1) * y(1),
+        k[2] * y(1) * y(1);
+    return dydt;
+  }
+};
+
+struct robertson_dae {
+  template <typename T0, typename TYY, typename TYP, typename TPAR>
+  inline std::vector<stan::return_type_t<TYY, TYP, TPAR>> operator()(
+      const T0& t_in, const std::vector<TYY>& yy, const std::vector<TYP>& yp,
+      const std::vector<TPAR>& k, const std::vector<double>& x_r,
+      const std::vector<int>& x_i, std::ostream* msgs) const {
+    std::vector<stan::return_type_t<TYY, TYP, TPAR>> res(3);
+    res[0] = yp[0] + k[0] * yy[0] - k[1] * yy[1] * yy[2];
+    res[1] = yp[1] - k[0] * yy[0] + k[1] * yy[1] * yy[2]
+             + k[2] * yy[1] * yy[1];
+    res[2] = yy[0] + yy[1] + yy[2] - 1.0;
+    return res;
+  }
+};
+
+void expect_consistent(const stan::math::ode_stats& stats) {
+  EXPECT_GT(stats.num_steps, 0);
+  EXPECT_GE(stats.num_rhs_evals, stats.num_steps);
+  EXPECT_GE(stats.num_error_test_failures, 0);
+  EXPECT_GE(stats.num_nonlinear_solver_convergence_failures, 0);
+}
+
+}  // namespace ode_stats_test
+
+TEST(StanMathOde_ode_stats, bdf_and_adams) {
+  using ode_stats_test::robertson;
+  using stan::math::ode_stats;
+  using stan::math::var;
+
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, 0.0, 0.0;
+  std::vector<var> k = {0.04, 1.0e4, 3.0e7};
+  std::vector<double> ts = {1.0, 10.0, 100.0};
+
+  ode_stats bdf_stats;
+  stan::math::ode_bdf_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10, 100000,
+                          bdf_stats, nullptr, k);
+  ode_stats_test::expect_consistent(bdf_stats);
+  EXPECT_GT(bdf_stats.num_jacobian_evals, 0);
+  EXPECT_GT(bdf_stats.num_linear_solver_setups, 0);
+  EXPECT_GT(bdf_stats.num_nonlinear_solver_iterations, 0);
+  EXPECT_GT(bdf_stats.num_sensitivity_rhs_evals, 0);
+  EXPECT_GT(bdf_stats.last_step_size, 0);
+
+  // the explicit method needs many more steps for the stiff problem
+  ode_stats adams_stats;
+  stan::math::ode_adams_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10, 100000,
+                            adams_stats, nullptr, k);
+  ode_stats_test::expect_consistent(adams_stats);
+  EXPECT_GT(adams_stats.num_steps, bdf_stats.num_steps);
+
+  // data only solves have no sensitivities
+  std::vector<double> k_d = stan::math::value_of(k);
+  ode_stats data_stats;
+  stan::math::ode_bdf_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10, 100000,
+                          data_stats, nullptr, k_d);
+  ode_stats_test::expect_consistent(data_stats);
+  EXPECT_EQ(0, data_stats.num_sensitivity_rhs_evals);
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_stats, krylov) {
+  using ode_stats_test::robertson;
+  using stan::math::cvodes_linear_solver;
+  using stan::math::ode_stats;
+
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, 0.0, 0.0;
+  std::vector<double> k = {0.04, 1.0e4, 3.0e7};
+  std::vector<double> ts = {1.0, 10.0};
+
+  // the products of the jacobian with vectors are difference quotients
+  ode_stats stats;
+  stan::math::ode_bdf_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10, 100000,
+                          cvodes_linear_solver::spgmr(), stats, nullptr, k);
+  ode_stats_test::expect_consistent(stats);
+  EXPECT_EQ(0, stats.num_jacobian_evals);
+
+  // the jacobian is only evaluated for the preconditioner
+  Eigen::VectorXd diagonal;
+  cvodes_linear_solver preconditioned = cvodes_linear_solver::spgmr();
+  preconditioned.preconditioner(
+      [&](double t, const Eigen::VectorXd& y, const Eigen::MatrixXd& J,
+          double gamma) { diagonal = 1.0 - gamma * J.diagonal().array(); },
+      [&](double t, const Eigen::VectorXd& y, const Eigen::VectorXd& r,
+          double gamma) -> Eigen::VectorXd {
+        return r.cwiseQuotient(diagonal);
+      });
+  ode_stats preconditioned_stats;
+  stan::math::ode_bdf_tol(robertson(), y0, 0.0, ts, 1e-8, 1e-10, 100000,
+                          preconditioned, preconditioned_stats, nullptr, k);
+  ode_stats_test::expect_consistent(preconditioned_stats);
+  EXPECT_GT(preconditioned_stats.num_jacobian_evals, 0);
+  EXPECT_LE(preconditioned_stats.num_jacobian_evals,
+            preconditioned_stats.num_linear_solver_setups);
+}
+
+TEST(StanMathOde_ode_stats, failed_solve) {
+  using ode_stats_test::robertson;
+  using stan::math::ode_stats;
+
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, 0.0, 0.0;
+  std::vector<double> k = {0.04, 1.0e4, 3.0e7};
+  std::vector<double> ts = {1.0e6};
+
+  ode_stats stats;
+  EXPECT_THROW(stan::math::ode_adams_tol(robertson(), y0, 0.0, ts, 1e-8,
+                                         1e-10, 50, stats, nullptr, k),
+               std::domain_error);
+  EXPECT_EQ(50, stats.num_steps);
+}
+
+TEST(StanMathOde_ode_stats, rk45) {
+  using ode_stats_test::robertson;
+  using stan::math::ode_stats;
+  using stan::math::var;
+
+  Eigen::VectorXd y0(3);
+  y0 << 1.0, 0.0, 0.0;
+  std::vector<var> k = {0.04, 1.0e2, 3.0e2};
+  std::vector<double> ts = {1.0, 10.0};
+
+  ode_stats stats;
+  stan::math::ode_rk45_tol(robertson(), y0, 0.0, ts, 1e-6, 1e-6, 100000,
+                           stats, nullptr, k);
+  ode_stats_test::expect_consistent(stats);
+  EXPECT_GT(stats.num_rhs_evals, stats.num_steps);
+  EXPECT_EQ(0, stats.num_sensitivity_rhs_evals);
+  EXPECT_EQ(0, stats.num_jacobian_evals);
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_stats, integrate_dae) {
+  using ode_stats_test::robertson_dae;
+  using stan::math::ode_stats;
+  using stan::math::var;
+
+  std::vector<double> yy0 = {1.0, 0.0, 0.0};
+  std::vector<double> yp0 = {-0.04, 0.04, 0.0};
+  std::vector<var> k = {0.04, 1.0e4, 3.0e7};
+  std::vector<double> ts = {0.4, 4.0};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  ode_stats stats;
+  stan::math::integrate_dae(robertson_dae(), yy0, yp0, 0.0, ts, k, x_r, x_i,
+                            1e-5, 1e-12, 500, nullptr, &stats);
+  ode_stats_test::expect_consistent(stats);
+  EXPECT_GT(stats.num_jacobian_evals, 0);
+  EXPECT_GT(stats.num_sensitivity_rhs_evals, 0);
+
+  stan::math::recover_memory();
+}
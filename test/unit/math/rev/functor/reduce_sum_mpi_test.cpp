@@ -0,0 +1,96 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/reduce_sum_util.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+struct faulty_count_lpdf {
+  template <typename T>
+  inline T operator()(const std::vector<int>& sub_slice, std::size_t start,
+                      std::size_t end, std::ostream* msgs,
+                      const T& lambda) const {
+    if (start <= 3 && 3 <= end)
+      throw std::domain_error("term 3 failed");
+    return stan::math::poisson_lpmf(sub_slice, lambda);
+  }
+};
+
+using grouped_count_v = stan::math::test::grouped_count_lpdf<stan::math::var>;
+using grouped_count_d = stan::math::test::grouped_count_lpdf<double>;
+
+STAN_REGISTER_MPI_REDUCE_SUM(0, grouped_count_v, std::vector<int>,
+                             std::vector<stan::math::var>, std::vector<int>)
+STAN_REGISTER_MPI_REDUCE_SUM(1, grouped_count_d, std::vector<int>,
+                             std::vector<double>, std::vector<int>)
+STAN_REGISTER_MPI_REDUCE_SUM(2, faulty_count_lpdf, std::vector<int>,
+                             stan::math::var)
+
+struct ReduceSumMpi : public ::testing::Test {
+  const std::size_t N = 11;
+  const std::size_t groups = 3;
+  std::vector<int> data;
+  std::vector<int> gidx;
+  std::vector<double> lambda_d;
+
+  virtual void SetUp() {
+    for (std::size_t i = 0; i != N; ++i) {
+      data.push_back(i % 4 + i % 5);
+      gidx.push_back(i % groups);
+    }
+    for (std::size_t g = 0; g != groups; ++g) {
+      lambda_d.push_back(0.5 + g);
+    }
+  }
+};
+
+TEST_F(ReduceSumMpi, grouped_gradient) {
+  using stan::math::var;
+
+  // repeated calls use the cached data with new parameter values
+  for (int iter = 0; iter != 3; ++iter) {
+    std::vector<var> lambda_mpi(lambda_d.begin(), lambda_d.end());
+    std::vector<var> lambda_ref(lambda_d.begin(), lambda_d.end());
+    lambda_mpi[0] += iter;
+    lambda_ref[0] += iter;
+
+    var lp_mpi = stan::math::reduce_sum_mpi<0, grouped_count_v>(
+        data, nullptr, lambda_mpi, gidx);
+    var lp_ref = grouped_count_v()(data, 0, N - 1, nullptr, lambda_ref, gidx);
+
+    EXPECT_FLOAT_EQ(lp_ref.val(), lp_mpi.val());
+
+    std::vector<double> grad_mpi;
+    std::vector<double> grad_ref;
+    lp_mpi.grad(lambda_mpi, grad_mpi);
+    lp_ref.grad(lambda_ref, grad_ref);
+    for (std::size_t g = 0; g != groups; ++g) {
+      EXPECT_NEAR(grad_ref[g], grad_mpi[g], 1e-10);
+    }
+    stan::math::recover_memory();
+  }
+}
+
+TEST_F(ReduceSumMpi, grouped_value) {
+  double lp_mpi = stan::math::reduce_sum_mpi<1, grouped_count_d>(
+      data, nullptr, lambda_d, gidx);
+  double lp_ref = grouped_count_d()(data, 0, N - 1, nullptr, lambda_d, gidx);
+
+  EXPECT_FLOAT_EQ(lp_ref, lp_mpi);
+}
+
+TEST_F(ReduceSumMpi, error_is_propagated) {
+  stan::math::var lambda = 2.0;
+
+  EXPECT_THROW((stan::math::reduce_sum_mpi<2, faulty_count_lpdf>(
+                   data, nullptr, lambda)),
+               std::domain_error);
+
+  // the cluster is still usable after the failure
+  std::vector<stan::math::var> lambda_v(lambda_d.begin(), lambda_d.end());
+  stan::math::var lp = stan::math::reduce_sum_mpi<0, grouped_count_v>(
+      data, nullptr, lambda_v, gidx);
+  EXPECT_FLOAT_EQ(
+      grouped_count_d()(data, 0, N - 1, nullptr, lambda_d, gidx), lp.val());
+  stan::math::recover_memory();
+}
@@ -390,6 +390,163 @@ TEST(StanMathRev_reduce_sum, slice_group_gradient) {
   stan::math::recover_memory();
 }
 
+TEST(StanMathRev_reduce_sum, auto_gradient) {
+  using stan::math::var;
+  using stan::math::test::count_lpdf;
+  using stan::math::test::get_new_msg;
+
+  double lambda_d = 10.0;
+  const std::size_t elems = 10000;
+  std::vector<int> data(elems);
+
+  for (std::size_t i = 0; i != elems; ++i)
+    data[i] = i;
+
+  std::vector<int> idata;
+  var lambda_ref = lambda_d;
+  var poisson_lpdf_ref = stan::math::poisson_lpmf(data, lambda_ref);
+  stan::math::grad(poisson_lpdf_ref.vi_);
+  const double lambda_ref_adj = lambda_ref.adj();
+
+  for (int i = 0; i < 30; ++i) {
+    stan::math::set_zero_all_adjoints();
+    var lambda_v = lambda_d;
+    std::vector<var> vlambda_v(1, lambda_v);
+    var poisson_lpdf = stan::math::reduce_sum_auto<count_lpdf<var>>(
+        data, get_new_msg(), vlambda_v, idata);
+    EXPECT_FLOAT_EQ(value_of(poisson_lpdf), value_of(poisson_lpdf_ref));
+
+    stan::math::grad(poisson_lpdf.vi_);
+    EXPECT_FLOAT_EQ(lambda_v.adj(), lambda_ref_adj);
+  }
+
+#ifdef STAN_THREADS
+  EXPECT_GE((stan::math::reduce_sum_auto_grainsize<count_lpdf<var>, var>(
+                elems)),
+            1);
+#endif
+
+  stan::math::recover_memory();
+}
+
+struct shared_args_lpdf {
+  template <typename T1, typename T2, typename T3>
+  inline auto operator()(const std::vector<T1>& sub_slice, std::size_t start,
+                         std::size_t end, std::ostream* msgs,
+                         const Eigen::Matrix<T2, Eigen::Dynamic, 1>& mu,
+                         const T3& sigma, const Eigen::MatrixXd& x) const {
+    stan::return_type_t<T1, T2, T3> sum = 0;
+    for (std::size_t i = start; i <= end; ++i) {
+      sum += stan::math::normal_lpdf(sub_slice[i - start],
+                                     x.row(i).dot(mu), sigma);
+    }
+    return sum;
+  }
+};
+
+TEST(StanMathRev_reduce_sum, shared_args_gradient) {
+  using stan::math::var;
+  using stan::math::test::get_new_msg;
+
+  const int N = 200;
+  const int K = 5;
+  std::vector<var> y(N);
+  Eigen::Matrix<var, Eigen::Dynamic, 1> mu(K);
+  var sigma = 1.5;
+  for (int i = 0; i < N; ++i) {
+    y[i] = 0.01 * i;
+  }
+  for (int k = 0; k < K; ++k) {
+    mu(k) = 0.1 * k;
+  }
+  auto make_x = [&]() {
+    Eigen::MatrixXd x(N, K);
+    for (int i = 0; i < N; ++i) {
+      for (int k = 0; k < K; ++k) {
+        x(i, k) = std::sin(i + k);
+      }
+    }
+    return x;
+  };
+
+  var lp_ref = shared_args_lpdf()(y, 0, N - 1, get_new_msg(), mu, sigma,
+                                  make_x());
+  std::vector<var> vars(y.begin(), y.end());
+  vars.insert(vars.end(), mu.data(), mu.data() + K);
+  vars.push_back(sigma);
+  std::vector<double> grad_ref;
+  lp_ref.grad(vars, grad_ref);
+  stan::math::set_zero_all_adjoints();
+
+  for (int grainsize : {1, 7, 1000}) {
+    var lp = stan::math::reduce_sum<shared_args_lpdf>(
+        y, grainsize, get_new_msg(), mu, sigma, make_x());
+    std::vector<double> grad;
+    lp.grad(vars, grad);
+    stan::math::set_zero_all_adjoints();
+
+    EXPECT_FLOAT_EQ(lp_ref.val(), lp.val());
+    for (std::size_t i = 0; i < grad_ref.size(); ++i) {
+      EXPECT_FLOAT_EQ(grad_ref[i], grad[i]);
+    }
+
+    var lp_static = stan::math::reduce_sum_static<shared_args_lpdf>(
+        y, grainsize, get_new_msg(), mu, sigma, make_x());
+    std::vector<double> grad_static;
+    lp_static.grad(vars, grad_static);
+    stan::math::set_zero_all_adjoints();
+
+    EXPECT_FLOAT_EQ(lp_ref.val(), lp_static.val());
+    for (std::size_t i = 0; i < grad_ref.size(); ++i) {
+      EXPECT_FLOAT_EQ(grad_ref[i], grad_static[i]);
+    }
+  }
+
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRev_reduce_sum, static_shared_args_gradient_reproducible) {
+  using stan::math::var;
+  using stan::math::test::get_new_msg;
+
+  const int N = 200;
+  const int K = 5;
+  std::vector<var> y(N);
+  Eigen::Matrix<var, Eigen::Dynamic, 1> mu(K);
+  var sigma = 1.5;
+  Eigen::MatrixXd x(N, K);
+  for (int i = 0; i < N; ++i) {
+    y[i] = 0.01 * i;
+    for (int k = 0; k < K; ++k) {
+      x(i, k) = std::sin(i + k);
+    }
+  }
+  for (int k = 0; k < K; ++k) {
+    mu(k) = 0.1 * k;
+  }
+  std::vector<var> vars(mu.data(), mu.data() + K);
+  vars.push_back(sigma);
+
+  // the adjoints of the shared arguments are accumulated in the same
+  // order on every call, no matter which threads run the chunks
+  std::vector<double> grad_first;
+  for (int n = 0; n < 10; ++n) {
+    var lp = stan::math::reduce_sum_static<shared_args_lpdf>(
+        y, 3, get_new_msg(), mu, sigma, x);
+    std::vector<double> grad;
+    lp.grad(vars, grad);
+    stan::math::set_zero_all_adjoints();
+    if (n == 0) {
+      grad_first = grad;
+    }
+    for (std::size_t i = 0; i < grad.size(); ++i) {
+      EXPECT_EQ(grad_first[i], grad[i]);
+    }
+  }
+
+  stan::math::recover_memory();
+}
+
 #ifdef STAN_THREADS
 std::vector<int> threading_test_global;
 struct threading_test_lpdf {
@@ -0,0 +1,185 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace sundials_workspace_cache_test {
+
+struct counted_workspace {
+  static int num_alive;
+  int key_;
+
+  explicit counted_workspace(int key) : key_(key) { ++num_alive; }
+  ~counted_workspace() { --num_alive; }
+
+  int key() const { return key_; }
+};
+
+int counted_workspace::num_alive = 0;
+
+struct harmonic_oscillator {
+  template <typename T0, typename T_y, typename T_theta>
+  inline Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const std::vector<T_theta>& theta) const {
+    Eigen::Matrix<stan::return_type_t<T_y, T_theta>, Eigen::Dynamic, 1> dydt(
+        2);
+    dydt << y(1), -y(0) - theta[0] * y(1);
+    return dydt;
+  }
+};
+
+struct chemical_kinetics {
+  template <typename T0, typename TYY, typename TYP, typename TPAR>
+  inline std::vector<stan::return_type_t<TYY, TYP, TPAR>> operator()(
+      const T0& t_in, const std::vector<TYY>& yy, const std::vector<TYP>& yp,
+      const std::vector<TPAR>& theta, const std::vector<double>& x_r,
+      const std::vector<int>& x_i, std::ostream* msgs) const {
+    std::vector<stan::return_type_t<TYY, TYP, TPAR>> res(3);
+    res[0] = yp[0] + theta[0] * yy[0] - theta[1] * yy[1] * yy[2];
+    res[1] = yp[1] - theta[0] * yy[0] + theta[1] * yy[1] * yy[2]
+             + theta[2] * yy[1] * yy[1];
+    res[2] = yy[0] + yy[1] + yy[2] - 1.0;
+    return res;
+  }
+};
+
+std::vector<double> oscillator_grad(double y0_0, double theta_0) {
+  using stan::math::var;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(2);
+  y0 << y0_0, 0.5;
+  std::vector<var> theta = {theta_0};
+  std::vector<double> ts = {0.5, 1.0, 4.0};
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ys
+      = stan::math::ode_bdf(harmonic_oscillator(), y0, 0.0, ts, nullptr,
+                            theta);
+  var lp = ys[0](0) + ys[1](1) + ys[2](0);
+  lp.grad();
+
+  std::vector<double> g
+      = {lp.val(), y0(0).adj(), y0(1).adj(), theta[0].adj()};
+  stan::math::recover_memory();
+  return g;
+}
+
+std::vector<double> dae_grad(double theta_0) {
+  using stan::math::var;
+  std::vector<double> yy0 = {1.0, 0.0, 0.0};
+  std::vector<double> yp0 = {-theta_0, theta_0, 0.0};
+  std::vector<var> theta = {theta_0, 1.0e4, 3.0e7};
+  std::vector<double> ts = {0.4, 4.0};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  std::vector<std::vector<var>> yy
+      = stan::math::integrate_dae(chemical_kinetics(), yy0, yp0, 0.0, ts,
+                                  theta, x_r, x_i, 1e-5, 1e-12);
+  yy[1][0].grad();
+
+  std::vector<double> g = {yy[1][0].val(), theta[0].adj(), theta[1].adj(),
+                           theta[2].adj()};
+  stan::math::recover_memory();
+  return g;
+}
+
+}  // namespace sundials_workspace_cache_test
+
+TEST(StanMath_sundials_workspace_cache, reuse_by_key) {
+  using sundials_workspace_cache_test::counted_workspace;
+  using cache = stan::math::sundials_workspace_cache<counted_workspace,
+                                                     counted_workspace>;
+  cache::clear();
+
+  cache::workspace_ptr a = cache::acquire(1, 1);
+  cache::workspace_ptr b = cache::acquire(1, 1);
+  EXPECT_NE(a.get(), b.get());
+  EXPECT_EQ(2, counted_workspace::num_alive);
+
+  counted_workspace* a_ptr = a.get();
+  cache::release(std::move(a));
+  EXPECT_EQ(1, cache::size());
+  cache::workspace_ptr c = cache::acquire(2, 2);
+  EXPECT_NE(a_ptr, c.get());
+  cache::workspace_ptr d = cache::acquire(1, 1);
+  EXPECT_EQ(a_ptr, d.get());
+  EXPECT_EQ(0, cache::size());
+  EXPECT_EQ(3, counted_workspace::num_alive);
+
+  // workspaces which are not released are freed
+  c.reset();
+  EXPECT_EQ(2, counted_workspace::num_alive);
+
+  cache::release(std::move(b));
+  cache::release(std::move(d));
+  EXPECT_EQ(2, cache::size());
+  cache::clear();
+  EXPECT_EQ(0, counted_workspace::num_alive);
+}
+
+TEST(StanMath_sundials_workspace_cache, max_idle_workspaces) {
+  using sundials_workspace_cache_test::counted_workspace;
+  using cache = stan::math::sundials_workspace_cache<counted_workspace,
+                                                     counted_workspace>;
+  cache::clear();
+
+  const int num_workspaces = cache::max_idle_workspaces + 2;
+  std::vector<cache::workspace_ptr> workspaces;
+  for (int i = 0; i < num_workspaces; ++i) {
+    workspaces.push_back(cache::acquire(i, i));
+  }
+  for (auto& workspace : workspaces) {
+    cache::release(std::move(workspace));
+  }
+  EXPECT_EQ(cache::max_idle_workspaces, cache::size());
+  EXPECT_EQ(cache::max_idle_workspaces, counted_workspace::num_alive);
+  cache::clear();
+}
+
+TEST(StanMath_sundials_workspace_cache, ode_bdf_repeated_solves) {
+  using sundials_workspace_cache_test::oscillator_grad;
+  std::vector<double> g_first = oscillator_grad(1.0, 0.15);
+  std::vector<double> g_other = oscillator_grad(-0.3, 0.8);
+  std::vector<double> g_second = oscillator_grad(1.0, 0.15);
+
+  ASSERT_EQ(g_first.size(), g_second.size());
+  for (size_t i = 0; i < g_first.size(); ++i) {
+    EXPECT_FLOAT_EQ(g_first[i], g_second[i]) << "entry " << i;
+  }
+  EXPECT_NE(g_first[0], g_other[0]);
+}
+
+TEST(StanMath_sundials_workspace_cache, ode_bdf_after_error) {
+  using stan::math::var;
+  using sundials_workspace_cache_test::harmonic_oscillator;
+  using sundials_workspace_cache_test::oscillator_grad;
+  std::vector<double> g_first = oscillator_grad(1.0, 0.15);
+
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(2);
+  y0 << 1.0, 0.5;
+  std::vector<var> theta = {0.15};
+  std::vector<double> ts = {1000.0};
+  EXPECT_THROW(stan::math::ode_bdf_tol(harmonic_oscillator(), y0, 0.0, ts,
+                                       1e-10, 1e-10, 10, nullptr, theta),
+               std::domain_error);
+  stan::math::recover_memory();
+
+  std::vector<double> g_second = oscillator_grad(1.0, 0.15);
+  ASSERT_EQ(g_first.size(), g_second.size());
+  for (size_t i = 0; i < g_first.size(); ++i) {
+    EXPECT_FLOAT_EQ(g_first[i], g_second[i]) << "entry " << i;
+  }
+}
+
+TEST(StanMath_sundials_workspace_cache, integrate_dae_repeated_solves) {
+  using sundials_workspace_cache_test::dae_grad;
+  std::vector<double> g_first = dae_grad(0.04);
+  std::vector<double> g_other = dae_grad(0.08);
+  std::vector<double> g_second = dae_grad(0.04);
+
+  ASSERT_EQ(g_first.size(), g_second.size());
+  for (size_t i = 0; i < g_first.size(); ++i) {
+    EXPECT_FLOAT_EQ(g_first[i], g_second[i]) << "entry " << i;
+  }
+  EXPECT_NE(g_first[0], g_other[0]);
+}